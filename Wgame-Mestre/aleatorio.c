@@ -0,0 +1,501 @@
+/**
+ * aleatorio.c - Implementação do gerador de números pseudoaleatórios
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "aleatorio.h"
+
+// 6^4: quantidade de combinações de quatro dados
+#define COMBINACOES_QUATRO_DADOS 1296u
+
+// 2^32 mod 6^4: abaixo deste valor a redução de 32 bits teria viés
+#define LIMIAR_REJEICAO ((uint32_t)(4294967296ull % COMBINACOES_QUATRO_DADOS))
+
+/**
+ * Função auxiliar splitmix64, usada apenas para espalhar a semente pelo estado
+ */
+static uint64_t splitmix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Função para inicializar o gerador a partir de uma semente de 64 bits
+ */
+void inicializarGerador(GeradorAleatorio *gerador, uint64_t semente)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        gerador->s[i] = splitmix64(&semente);
+    }
+    gerador->posicao = 0;
+}
+
+/**
+ * Função para avançar o gerador 2^128 posições de uma só vez
+ */
+void saltarGerador(GeradorAleatorio *gerador)
+{
+    static const uint64_t SALTO[4] = {
+        0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+        0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+    uint64_t novo[4] = {0, 0, 0, 0};
+
+    for (int i = 0; i < 4; i++)
+    {
+        for (int bit = 0; bit < 64; bit++)
+        {
+            if (SALTO[i] & (1ull << bit))
+            {
+                for (int j = 0; j < 4; j++)
+                {
+                    novo[j] ^= gerador->s[j];
+                }
+            }
+            proximoAleatorio(gerador);
+        }
+    }
+
+    memcpy(gerador->s, novo, sizeof(novo));
+
+    // O salto inicia um novo fluxo: a contagem de posições recomeça
+    gerador->posicao = 0;
+}
+
+/**
+ * Função para criar o fluxo de número 'fluxo' derivado de uma única semente
+ */
+void criarFluxoGerador(GeradorAleatorio *gerador, uint64_t semente, unsigned int fluxo)
+{
+    inicializarGerador(gerador, semente);
+
+    for (unsigned int i = 0; i < fluxo; i++)
+    {
+        saltarGerador(gerador);
+    }
+}
+
+/**
+ * Função para derivar uma semente independente para o item 'indice' de um lote
+ */
+uint64_t derivarSemente(uint64_t semente, uint64_t indice)
+{
+    uint64_t x = semente ^ (indice * 0xD1B54A32D192ED03ull);
+    return splitmix64(&x);
+}
+
+/**
+ * Função para sortear um inteiro uniforme em [0, limite) sem viés (método de Lemire)
+ */
+uint32_t sortearIntervalo(GeradorAleatorio *gerador, uint32_t limite)
+{
+    uint64_t produto = (uint64_t)(uint32_t)(proximoAleatorio(gerador) >> 32) * limite;
+
+    if ((uint32_t)produto < limite)
+    {
+        uint32_t limiar = (uint32_t)(-limite) % limite;
+        while ((uint32_t)produto < limiar)
+        {
+            produto = (uint64_t)(uint32_t)(proximoAleatorio(gerador) >> 32) * limite;
+        }
+    }
+
+    return (uint32_t)(produto >> 32);
+}
+
+/**
+ * Função auxiliar que converte 32 bits em quatro faces pelo método de Lemire
+ * @return 1 se as faces foram geradas, 0 se o valor caiu na faixa rejeitada
+ */
+static int extrairQuatroFaces(uint32_t bits, int *faces)
+{
+    uint64_t produto = (uint64_t)bits * COMBINACOES_QUATRO_DADOS;
+    uint32_t valor;
+
+    // Rejeição rara (probabilidade ~3e-7) que elimina o viés do módulo
+    if ((uint32_t)produto < LIMIAR_REJEICAO)
+    {
+        return 0;
+    }
+
+    // A parte alta é uniforme em [0, 6^4): cada dígito na base 6 é um dado
+    valor = (uint32_t)(produto >> 32);
+    for (int i = 0; i < 4; i++)
+    {
+        faces[i] = (int)(valor % 6) + 1;
+        valor /= 6;
+    }
+
+    return 1;
+}
+
+/**
+ * Função para lançar dados de seis faces sem viés
+ */
+void lancarFaces(GeradorAleatorio *gerador, int *faces, int quantidade)
+{
+    int quatro[4];
+
+    while (quantidade > 0)
+    {
+        uint64_t bits = proximoAleatorio(gerador);
+
+        for (int metade = 0; metade < 2 && quantidade > 0; metade++)
+        {
+            if (!extrairQuatroFaces((uint32_t)(bits >> (32 * metade)), quatro))
+            {
+                continue;
+            }
+
+            int usadas = quantidade < 4 ? quantidade : 4;
+            memcpy(faces, quatro, usadas * sizeof(int));
+            faces += usadas;
+            quantidade -= usadas;
+        }
+    }
+}
+
+/*
+ * ---------------------------------------------------------------------------
+ * Gerador em lote
+ *
+ * Cada passo avança as quatro vias e produz 4 x 64 bits, ou seja, oito valores
+ * de 32 bits. Cada valor vira uma face pelo método de Lemire: o produto por 6
+ * tem a face na parte alta e é rejeitado quando a parte baixa é menor que
+ * 2^32 mod 6 = 4 (probabilidade ~1e-9). A face 2j do passo vem da metade baixa
+ * da via j e a face 2j+1 da metade alta.
+ * ---------------------------------------------------------------------------
+ */
+
+// Faces produzidas por passo do gerador em lote
+#define FACES_POR_PASSO 8
+
+// 2^32 mod 6: partes baixas menores que isto seriam enviesadas
+#define LIMIAR_REJEICAO_FACE 4u
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LOTE_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * Função para inicializar o gerador em lote
+ */
+void inicializarGeradorLote(GeradorLote *gerador, uint64_t semente, unsigned int fluxo)
+{
+    GeradorAleatorio via;
+
+    // Fluxos 5*fluxo .. 5*fluxo+3 para as vias e 5*fluxo+4 para a reserva
+    criarFluxoGerador(&via, semente, fluxo * 5u);
+    for (int j = 0; j < 4; j++)
+    {
+        for (int palavra = 0; palavra < 4; palavra++)
+        {
+            gerador->s[palavra][j] = via.s[palavra];
+        }
+        saltarGerador(&via);
+    }
+    gerador->reserva = via;
+}
+
+/**
+ * Função auxiliar que converte as quatro saídas de um passo em oito faces
+ * Também trata as rejeições, sempre na mesma ordem, em todas as versões
+ */
+static void extrairFacesPasso(GeradorLote *gerador, const uint64_t saidas[4], uint8_t *faces)
+{
+    for (int j = 0; j < 4; j++)
+    {
+        for (int metade = 0; metade < 2; metade++)
+        {
+            uint64_t produto = (uint64_t)(uint32_t)(saidas[j] >> (32 * metade)) * 6u;
+            int face;
+
+            if ((uint32_t)produto < LIMIAR_REJEICAO_FACE)
+            {
+                lancarFaces(&gerador->reserva, &face, 1);
+            }
+            else
+            {
+                face = (int)(produto >> 32) + 1;
+            }
+            faces[2 * j + metade] = (uint8_t)face;
+        }
+    }
+}
+
+/**
+ * Função auxiliar que avança as quatro vias de forma escalar
+ */
+static void avancarPassoEscalar(GeradorLote *gerador, uint64_t saidas[4])
+{
+    uint64_t(*s)[4] = gerador->s;
+
+    for (int j = 0; j < 4; j++)
+    {
+        uint64_t x = s[1][j] * 5;
+        uint64_t t = s[1][j] << 17;
+
+        saidas[j] = ((x << 7) | (x >> 57)) * 9;
+        s[2][j] ^= s[0][j];
+        s[3][j] ^= s[1][j];
+        s[1][j] ^= s[2][j];
+        s[0][j] ^= s[3][j];
+        s[2][j] ^= t;
+        s[3][j] = (s[3][j] << 45) | (s[3][j] >> 19);
+    }
+}
+
+/**
+ * Versão escalar: referência e alternativa para processadores sem SIMD
+ */
+static void lancarPassosEscalar(GeradorLote *gerador, uint8_t *faces, size_t passos)
+{
+    uint64_t saidas[4];
+
+    for (size_t k = 0; k < passos; k++)
+    {
+        avancarPassoEscalar(gerador, saidas);
+        extrairFacesPasso(gerador, saidas, faces + k * FACES_POR_PASSO);
+    }
+}
+
+#ifdef LOTE_X86
+
+/**
+ * Versão SSE2: duas vias por registrador; a redução a faces é feita em escalar
+ */
+__attribute__((target("sse2"))) static void lancarPassosSse2(GeradorLote *gerador, uint8_t *faces, size_t passos)
+{
+    __m128i s[4][2];
+    uint64_t saidas[4];
+
+    for (int palavra = 0; palavra < 4; palavra++)
+    {
+        s[palavra][0] = _mm_loadu_si128((const __m128i *)&gerador->s[palavra][0]);
+        s[palavra][1] = _mm_loadu_si128((const __m128i *)&gerador->s[palavra][2]);
+    }
+
+    for (size_t k = 0; k < passos; k++)
+    {
+        for (int m = 0; m < 2; m++)
+        {
+            // resultado = rotl(s1 * 5, 7) * 9, com as multiplicações feitas por deslocamentos
+            __m128i x = _mm_add_epi64(_mm_slli_epi64(s[1][m], 2), s[1][m]);
+            x = _mm_or_si128(_mm_slli_epi64(x, 7), _mm_srli_epi64(x, 57));
+            __m128i r = _mm_add_epi64(_mm_slli_epi64(x, 3), x);
+            __m128i t = _mm_slli_epi64(s[1][m], 17);
+
+            s[2][m] = _mm_xor_si128(s[2][m], s[0][m]);
+            s[3][m] = _mm_xor_si128(s[3][m], s[1][m]);
+            s[1][m] = _mm_xor_si128(s[1][m], s[2][m]);
+            s[0][m] = _mm_xor_si128(s[0][m], s[3][m]);
+            s[2][m] = _mm_xor_si128(s[2][m], t);
+            s[3][m] = _mm_or_si128(_mm_slli_epi64(s[3][m], 45), _mm_srli_epi64(s[3][m], 19));
+
+            _mm_storeu_si128((__m128i *)&saidas[2 * m], r);
+        }
+        extrairFacesPasso(gerador, saidas, faces + k * FACES_POR_PASSO);
+    }
+
+    for (int palavra = 0; palavra < 4; palavra++)
+    {
+        _mm_storeu_si128((__m128i *)&gerador->s[palavra][0], s[palavra][0]);
+        _mm_storeu_si128((__m128i *)&gerador->s[palavra][2], s[palavra][1]);
+    }
+}
+
+/**
+ * Versão AVX2: as quatro vias num único registrador e redução vetorizada
+ */
+__attribute__((target("avx2"))) static void lancarPassosAvx2(GeradorLote *gerador, uint8_t *faces, size_t passos)
+{
+    __m256i s0 = _mm256_loadu_si256((const __m256i *)gerador->s[0]);
+    __m256i s1 = _mm256_loadu_si256((const __m256i *)gerador->s[1]);
+    __m256i s2 = _mm256_loadu_si256((const __m256i *)gerador->s[2]);
+    __m256i s3 = _mm256_loadu_si256((const __m256i *)gerador->s[3]);
+    const __m256i seis = _mm256_set1_epi64x(6);
+    const __m256i umUm = _mm256_set1_epi64x(0x0101);
+    const __m256i mascaraRejeicao = _mm256_set1_epi64x(0xFFFFFFFCll);
+    const __m256i zero = _mm256_setzero_si256();
+    // Junta os dois bytes de faces de cada via (bytes 0-1 e 8-9 de cada metade de 128 bits)
+    const __m256i juntar = _mm256_setr_epi8(
+        0, 1, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 1, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+
+    for (size_t k = 0; k < passos; k++)
+    {
+        uint8_t *destino = faces + k * FACES_POR_PASSO;
+        __m256i x = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+        x = _mm256_or_si256(_mm256_slli_epi64(x, 7), _mm256_srli_epi64(x, 57));
+        __m256i r = _mm256_add_epi64(_mm256_slli_epi64(x, 3), x);
+        __m256i t = _mm256_slli_epi64(s1, 17);
+
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+
+        // Produtos de 32 x 32 bits das metades baixa e alta de cada via por 6
+        __m256i produtoBaixo = _mm256_mul_epu32(r, seis);
+        __m256i produtoAlto = _mm256_mul_epu32(_mm256_srli_epi64(r, 32), seis);
+
+        __m256i rejeitados = _mm256_or_si256(
+            _mm256_cmpeq_epi64(_mm256_and_si256(produtoBaixo, mascaraRejeicao), zero),
+            _mm256_cmpeq_epi64(_mm256_and_si256(produtoAlto, mascaraRejeicao), zero));
+
+        if (_mm256_movemask_epi8(rejeitados) != 0)
+        {
+            // Caso raríssimo: refaz o passo pela rotina comum, que trata as rejeições
+            uint64_t saidas[4];
+            _mm256_storeu_si256((__m256i *)saidas, r);
+            extrairFacesPasso(gerador, saidas, destino);
+            continue;
+        }
+
+        // Cada via vira dois bytes: face da metade baixa e face da metade alta (+1)
+        __m256i pares = _mm256_or_si256(_mm256_srli_epi64(produtoBaixo, 32),
+                                        _mm256_slli_epi64(_mm256_srli_epi64(produtoAlto, 32), 8));
+        pares = _mm256_shuffle_epi8(_mm256_add_epi64(pares, umUm), juntar);
+
+        uint32_t vias01 = (uint32_t)_mm256_cvtsi256_si32(pares);
+        uint32_t vias23 = (uint32_t)_mm256_extract_epi32(pares, 4);
+        memcpy(destino, &vias01, sizeof(vias01));
+        memcpy(destino + 4, &vias23, sizeof(vias23));
+    }
+
+    _mm256_storeu_si256((__m256i *)gerador->s[0], s0);
+    _mm256_storeu_si256((__m256i *)gerador->s[1], s1);
+    _mm256_storeu_si256((__m256i *)gerador->s[2], s2);
+    _mm256_storeu_si256((__m256i *)gerador->s[3], s3);
+}
+
+#endif /* LOTE_X86 */
+
+typedef void (*FuncaoPassosLote)(GeradorLote *, uint8_t *, size_t);
+
+/**
+ * Função auxiliar que escolhe uma única vez a melhor versão para este processador
+ */
+static FuncaoPassosLote escolherVersaoLote(const char **nome)
+{
+#ifdef LOTE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        *nome = "avx2";
+        return lancarPassosAvx2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        *nome = "sse2";
+        return lancarPassosSse2;
+    }
+#endif
+    *nome = "escalar";
+    return lancarPassosEscalar;
+}
+
+static FuncaoPassosLote versaoLote = NULL;
+static const char *nomeVersaoLote = "escalar";
+static pthread_once_t escolhaVersaoLote = PTHREAD_ONCE_INIT;
+
+/**
+ * Função auxiliar chamada uma única vez por pthread_once, mesmo com várias threads sorteando
+ */
+static void iniciarVersaoLote(void)
+{
+    versaoLote = escolherVersaoLote(&nomeVersaoLote);
+}
+
+/**
+ * Função para lançar milhares de dados de seis faces de uma só vez, sem viés
+ */
+void lancarFacesLote(GeradorLote *gerador, uint8_t *faces, size_t quantidade)
+{
+    size_t passos = quantidade / FACES_POR_PASSO;
+    size_t resto = quantidade % FACES_POR_PASSO;
+
+    pthread_once(&escolhaVersaoLote, iniciarVersaoLote);
+    versaoLote(gerador, faces, passos);
+
+    // As faces que sobram de um passo incompleto são descartadas
+    if (resto > 0)
+    {
+        uint8_t ultimas[FACES_POR_PASSO];
+        lancarPassosEscalar(gerador, ultimas, 1);
+        memcpy(faces + passos * FACES_POR_PASSO, ultimas, resto);
+    }
+}
+
+/**
+ * Função para consultar qual implementação de lancarFacesLote está em uso
+ */
+const char *implementacaoLote(void)
+{
+    pthread_once(&escolhaVersaoLote, iniciarVersaoLote);
+    return nomeVersaoLote;
+}
+
+/**
+ * Função auxiliar que roda uma versão a partir do estado inicial e compara com a referência escalar
+ * @return 1 se faces e estado final coincidem com os da referência
+ */
+static int conferirVersao(FuncaoPassosLote versao, const GeradorLote *inicial, const uint8_t *referencia,
+                          const GeradorLote *finalReferencia, uint8_t *faces, size_t passos)
+{
+    GeradorLote gerador = *inicial;
+
+    versao(&gerador, faces, passos);
+    return memcmp(faces, referencia, passos * FACES_POR_PASSO) == 0 &&
+           memcmp(gerador.s, finalReferencia->s, sizeof(gerador.s)) == 0 &&
+           memcmp(gerador.reserva.s, finalReferencia->reserva.s, sizeof(gerador.reserva.s)) == 0;
+}
+
+/**
+ * Função para conferir que as versões de lancarFacesLote disponíveis produzem as mesmas faces
+ */
+int conferirVersoesLote(uint64_t semente, size_t quantidade, int *versoes)
+{
+    size_t passos = quantidade / FACES_POR_PASSO;
+    GeradorLote inicial, referencia;
+    uint8_t *facesReferencia = (uint8_t *)malloc(passos * FACES_POR_PASSO + 1);
+    uint8_t *faces = (uint8_t *)malloc(passos * FACES_POR_PASSO + 1);
+    int iguais = facesReferencia != NULL && faces != NULL;
+
+    *versoes = 1;
+    if (iguais)
+    {
+        inicializarGeradorLote(&inicial, semente, 0);
+        referencia = inicial;
+        lancarPassosEscalar(&referencia, facesReferencia, passos);
+
+#ifdef LOTE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse2"))
+        {
+            (*versoes)++;
+            iguais = iguais && conferirVersao(lancarPassosSse2, &inicial, facesReferencia, &referencia, faces, passos);
+        }
+        if (__builtin_cpu_supports("avx2"))
+        {
+            (*versoes)++;
+            iguais = iguais && conferirVersao(lancarPassosAvx2, &inicial, facesReferencia, &referencia, faces, passos);
+        }
+#endif
+    }
+
+    free(facesReferencia);
+    free(faces);
+    return iguais;
+}
@@ -0,0 +1,160 @@
+/**
+ * aleatorio.h - Gerador de números pseudoaleatórios com estado explícito
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef ALEATORIO_H
+#define ALEATORIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Estado do gerador xoshiro256**
+ *
+ * Cada simulação (ou thread) mantém o seu próprio estado, o que torna as
+ * sequências reproduzíveis a partir da semente e elimina a disputa pelo
+ * estado global usado por rand(). 'posicao' conta quantos valores de 64 bits
+ * já foram produzidos no fluxo atual.
+ */
+typedef struct
+{
+    uint64_t s[4];
+    uint64_t posicao;
+} GeradorAleatorio;
+
+/**
+ * Estado do gerador em lote: quatro vias independentes do xoshiro256**
+ *
+ * O estado fica organizado como s[palavra][via], de modo que cada palavra das
+ * quatro vias cabe num registrador AVX2 (ou em dois registradores SSE2).
+ * O gerador 'reserva' só é usado nas raríssimas rejeições da redução sem viés.
+ */
+typedef struct
+{
+    uint64_t s[4][4];
+    GeradorAleatorio reserva;
+} GeradorLote;
+
+/**
+ * Função para inicializar o gerador a partir de uma semente de 64 bits
+ * @param gerador Ponteiro para o gerador a ser inicializado
+ * @param semente Semente; a mesma semente sempre produz a mesma sequência
+ */
+void inicializarGerador(GeradorAleatorio *gerador, uint64_t semente);
+
+/**
+ * Função para avançar o gerador 2^128 posições de uma só vez
+ *
+ * Sequências separadas por saltos nunca se sobrepõem na prática, por isso
+ * cada salto define um fluxo independente.
+ *
+ * @param gerador Ponteiro para o gerador
+ */
+void saltarGerador(GeradorAleatorio *gerador);
+
+/**
+ * Função para criar o fluxo de número 'fluxo' derivado de uma única semente
+ * @param gerador Ponteiro para o gerador a ser inicializado
+ * @param semente Semente comum a todos os fluxos
+ * @param fluxo Índice do fluxo (por exemplo, o número da thread)
+ */
+void criarFluxoGerador(GeradorAleatorio *gerador, uint64_t semente, unsigned int fluxo);
+
+/**
+ * Função para derivar uma semente independente para o item 'indice' de um lote
+ *
+ * Ao contrário de criarFluxoGerador, custa o mesmo para qualquer índice, o que
+ * serve para milhares de partidas derivadas de uma única semente.
+ *
+ * @param semente Semente comum
+ * @param indice Índice do item (por exemplo, o número da partida)
+ * @return Semente própria do item
+ */
+uint64_t derivarSemente(uint64_t semente, uint64_t indice);
+
+/**
+ * Função para sortear um inteiro uniforme em [0, limite) sem viés
+ * @param gerador Ponteiro para o gerador
+ * @param limite Limite superior exclusivo (maior que zero)
+ * @return Valor sorteado
+ */
+uint32_t sortearIntervalo(GeradorAleatorio *gerador, uint32_t limite);
+
+/**
+ * Função para lançar dados de seis faces sem viés
+ *
+ * Cada saída de 64 bits fornece até oito faces (quatro por metade de 32 bits).
+ *
+ * @param gerador Ponteiro para o gerador
+ * @param faces Vetor que receberá valores de 1 a 6
+ * @param quantidade Quantidade de faces a lançar
+ */
+void lancarFaces(GeradorAleatorio *gerador, int *faces, int quantidade);
+
+/**
+ * Função para inicializar o gerador em lote
+ *
+ * As quatro vias e a reserva usam fluxos distintos derivados da semente, então
+ * dois geradores em lote com fluxos diferentes nunca compartilham sequências.
+ *
+ * @param gerador Ponteiro para o gerador em lote
+ * @param semente Semente comum
+ * @param fluxo Índice do fluxo (por exemplo, o número da thread)
+ */
+void inicializarGeradorLote(GeradorLote *gerador, uint64_t semente, unsigned int fluxo);
+
+/**
+ * Função para lançar milhares de dados de seis faces de uma só vez, sem viés
+ *
+ * Usa AVX2 ou SSE2 conforme o processador (detectado em tempo de execução) e
+ * recai numa versão escalar nas demais arquiteturas. Todas as versões produzem
+ * exatamente a mesma sequência para o mesmo estado.
+ *
+ * @param gerador Ponteiro para o gerador em lote
+ * @param faces Vetor que receberá valores de 1 a 6
+ * @param quantidade Quantidade de faces a lançar
+ */
+void lancarFacesLote(GeradorLote *gerador, uint8_t *faces, size_t quantidade);
+
+/**
+ * Função para consultar qual implementação de lancarFacesLote está em uso
+ * @return "avx2", "sse2" ou "escalar"
+ */
+const char *implementacaoLote(void);
+
+/**
+ * Função para conferir que as versões de lancarFacesLote disponíveis neste processador
+ * (escalar, SSE2 e AVX2) produzem as mesmas faces e o mesmo estado final
+ * @param semente Semente do estado inicial comum
+ * @param quantidade Quantidade de faces comparadas (arredondada para baixo a múltiplo de 8)
+ * @param versoes Recebe a quantidade de versões comparadas, incluindo a escalar
+ * @return 1 se todas coincidem, 0 se alguma divergiu ou faltou memória
+ */
+int conferirVersoesLote(uint64_t semente, size_t quantidade, int *versoes);
+
+/**
+ * Função para obter o próximo valor de 64 bits do gerador
+ * Definida no cabeçalho para que o compilador possa expandi-la em linha
+ * @param gerador Ponteiro para o gerador
+ * @return Próximo valor pseudoaleatório
+ */
+static inline uint64_t proximoAleatorio(GeradorAleatorio *gerador)
+{
+    uint64_t *s = gerador->s;
+    uint64_t x = s[1] * 5;
+    uint64_t resultado = ((x << 7) | (x >> 57)) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+    gerador->posicao++;
+
+    return resultado;
+}
+
+#endif /* ALEATORIO_H */
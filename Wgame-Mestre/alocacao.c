@@ -3,32 +3,897 @@
  * Parte do Sistema de Territórios para Jogo de War
  */
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
 #include "alocacao.h"
 #include "territorio.h"
 
+// Telemetria de todos os alocadores; atualizada com operações atômicas porque as threads do torneio também alocam
+static EstatisticasAlocacao estatisticas;
+
 /**
  * Função auxiliar para determinar o melhor tipo de alocação com base na quantidade e tamanho
  */
 TipoAlocacao escolherTipoAlocacao(int quantidade, size_t tamanhoElemento)
 {
+    TipoAlocacao tipo;
+
     // Para grandes alocações, malloc é geralmente mais eficiente
     if (quantidade > 50 || tamanhoElemento > 100 || quantidade * tamanhoElemento > 5000)
     {
-        return USAR_MALLOC;
+        tipo = USAR_MALLOC;
     }
     // Para pequenas alocações, calloc é mais seguro e o overhead de inicialização é aceitável
     else
     {
-        return USAR_CALLOC;
+        tipo = USAR_CALLOC;
+    }
+
+    __atomic_add_fetch(&estatisticas.decisoes[tipo], 1, __ATOMIC_RELAXED);
+    return tipo;
+}
+
+// Alinhamento garantido pelos alocadores e tamanho do cabeçalho de cada bloco
+#define ALINHAMENTO_ALOCADOR 16
+#define CABECALHO_BLOCO 16
+
+// Cabeçalho do mmap: uma linha de cache inteira, para os dados continuarem alinhados em 64 bytes
+#define CABECALHO_MMAP 64
+
+// Parâmetros dos alocadores globais selecionáveis na inicialização
+#define TRECHO_ARENA_GLOBAL (1u << 20)
+#define OBJETO_POOL_GLOBAL 256
+#define LOTE_POOL_GLOBAL 256
+#define LIMIAR_MMAP_GLOBAL (1u << 20)
+
+// Limite de threads do primeiro toque paralelo
+#define MAX_THREADS_TOQUE 64
+
+// Origem de um bloco do pool: recortado de um lote ou repassado ao sistema
+#define ORIGEM_POOL 1
+#define ORIGEM_SISTEMA 2
+
+/**
+ * Função auxiliar que arredonda um tamanho para o alinhamento dos alocadores
+ */
+static size_t alinharTamanho(size_t tamanho)
+{
+    return (tamanho + ALINHAMENTO_ALOCADOR - 1) & ~(size_t)(ALINHAMENTO_ALOCADOR - 1);
+}
+
+/**
+ * Funções auxiliares da telemetria: somam ou subtraem bytes vivos e acompanham o pico
+ */
+static void somarBytesVivos(Alocador *alocador, size_t bytes)
+{
+    size_t vivos = __atomic_add_fetch(&estatisticas.bytesVivos, bytes, __ATOMIC_RELAXED);
+    size_t pico = __atomic_load_n(&estatisticas.picoBytes, __ATOMIC_RELAXED);
+
+    __atomic_add_fetch(&alocador->bytesVivos, bytes, __ATOMIC_RELAXED);
+    while (vivos > pico &&
+           !__atomic_compare_exchange_n(&estatisticas.picoBytes, &pico, vivos, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+static void subtrairBytesVivos(Alocador *alocador, size_t bytes)
+{
+    __atomic_sub_fetch(&estatisticas.bytesVivos, bytes, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&alocador->bytesVivos, bytes, __ATOMIC_RELAXED);
+}
+
+/**
+ * Funções para usar qualquer alocador através da sua tabela de operações
+ */
+void *alocarMemoria(Alocador *alocador, size_t tamanho, int zerar)
+{
+    void *bloco = alocador->operacoes->alocar(alocador, tamanho, zerar);
+
+    if (bloco != NULL)
+    {
+        __atomic_add_fetch(&estatisticas.alocacoes, 1, __ATOMIC_RELAXED);
+        somarBytesVivos(alocador, tamanho);
+    }
+    return bloco;
+}
+
+void *realocarMemoria(Alocador *alocador, void *bloco, size_t novoTamanho)
+{
+    size_t tamanhoAnterior = bloco != NULL ? alocador->operacoes->tamanho(alocador, bloco) : 0;
+    uintptr_t enderecoAnterior;
+    void *novo;
+
+    // Só o valor numérico do endereço sobrevive à realocação
+    memcpy(&enderecoAnterior, &bloco, sizeof(enderecoAnterior));
+    novo = alocador->operacoes->realocar(alocador, bloco, novoTamanho);
+    if (novo == NULL)
+    {
+        return NULL;
+    }
+
+    __atomic_add_fetch(&estatisticas.realocacoes, 1, __ATOMIC_RELAXED);
+    if (enderecoAnterior != 0 && (uintptr_t)novo != enderecoAnterior)
+    {
+        __atomic_add_fetch(&estatisticas.realocacoesMovidas, 1, __ATOMIC_RELAXED);
+    }
+    if (novoTamanho >= tamanhoAnterior)
+    {
+        somarBytesVivos(alocador, novoTamanho - tamanhoAnterior);
+    }
+    else
+    {
+        subtrairBytesVivos(alocador, tamanhoAnterior - novoTamanho);
+    }
+    return novo;
+}
+
+void liberarBloco(Alocador *alocador, void *bloco)
+{
+    if (bloco != NULL)
+    {
+        __atomic_add_fetch(&estatisticas.liberacoes, 1, __ATOMIC_RELAXED);
+        subtrairBytesVivos(alocador, alocador->operacoes->tamanho(alocador, bloco));
+        alocador->operacoes->liberar(alocador, bloco);
+    }
+}
+
+void reiniciarAlocador(Alocador *alocador)
+{
+    if (alocador->operacoes->reiniciar != NULL)
+    {
+        // Os blocos que ainda estavam vivos deixam de existir de uma vez
+        subtrairBytesVivos(alocador, alocador->bytesVivos);
+        alocador->operacoes->reiniciar(alocador);
+    }
+}
+
+void destruirAlocador(Alocador *alocador)
+{
+    if (alocador->operacoes->destruir != NULL)
+    {
+        subtrairBytesVivos(alocador, alocador->bytesVivos);
+        alocador->operacoes->destruir(alocador);
+    }
+}
+
+/**
+ * Função para copiar a telemetria acumulada de todos os alocadores
+ */
+void obterEstatisticasAlocacao(EstatisticasAlocacao *saida)
+{
+    saida->bytesVivos = __atomic_load_n(&estatisticas.bytesVivos, __ATOMIC_RELAXED);
+    saida->picoBytes = __atomic_load_n(&estatisticas.picoBytes, __ATOMIC_RELAXED);
+    saida->alocacoes = __atomic_load_n(&estatisticas.alocacoes, __ATOMIC_RELAXED);
+    saida->realocacoes = __atomic_load_n(&estatisticas.realocacoes, __ATOMIC_RELAXED);
+    saida->liberacoes = __atomic_load_n(&estatisticas.liberacoes, __ATOMIC_RELAXED);
+    saida->realocacoesMovidas = __atomic_load_n(&estatisticas.realocacoesMovidas, __ATOMIC_RELAXED);
+    for (int tipo = 0; tipo < TIPOS_ALOCACAO; tipo++)
+    {
+        saida->decisoes[tipo] = __atomic_load_n(&estatisticas.decisoes[tipo], __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * Função auxiliar que escreve uma quantidade de bytes na maior unidade conveniente
+ */
+static void formatarBytes(size_t bytes, char *texto, size_t tamanho)
+{
+    if (bytes >= ((size_t)1 << 30))
+    {
+        snprintf(texto, tamanho, "%.2f GiB", bytes / (double)((size_t)1 << 30));
+    }
+    else if (bytes >= ((size_t)1 << 20))
+    {
+        snprintf(texto, tamanho, "%.2f MiB", bytes / (double)((size_t)1 << 20));
+    }
+    else if (bytes >= ((size_t)1 << 10))
+    {
+        snprintf(texto, tamanho, "%.2f KiB", bytes / (double)((size_t)1 << 10));
+    }
+    else
+    {
+        snprintf(texto, tamanho, "%zu bytes", bytes);
+    }
+}
+
+/**
+ * Função para exibir o relatório da telemetria de alocação
+ */
+void exibirEstatisticasAlocacao(const EstatisticasAlocacao *dados)
+{
+    char vivos[32], pico[32];
+    long long decisoes = dados->decisoes[USAR_MALLOC] + dados->decisoes[USAR_CALLOC];
+
+    formatarBytes(dados->bytesVivos, vivos, sizeof(vivos));
+    formatarBytes(dados->picoBytes, pico, sizeof(pico));
+
+    printf("\n===================================\n");
+    printf("      ESTATISTICAS DE MEMORIA      \n");
+    printf("===================================\n");
+    printf("Alocador: %s\n", alocadorAtual()->operacoes->nome);
+    printf("Bytes vivos: %s (pico: %s)\n", vivos, pico);
+    printf("Alocacoes: %lld | Realocacoes: %lld (%lld moveram o bloco) | Liberacoes: %lld\n",
+           dados->alocacoes, dados->realocacoes, dados->realocacoesMovidas, dados->liberacoes);
+    printf("Decisoes de alocacao: malloc %lld (%.1f%%) | calloc %lld (%.1f%%)\n",
+           dados->decisoes[USAR_MALLOC], decisoes > 0 ? 100.0 * dados->decisoes[USAR_MALLOC] / decisoes : 0.0,
+           dados->decisoes[USAR_CALLOC], decisoes > 0 ? 100.0 * dados->decisoes[USAR_CALLOC] / decisoes : 0.0);
+    printf("===================================\n\n");
+}
+
+/*
+ * Alocador do sistema: repassa tudo para malloc, calloc, realloc e free,
+ * com um cabeçalho guardando o tamanho pedido para a telemetria
+ */
+
+static void *alocarSistema(Alocador *alocador, size_t tamanho, int zerar)
+{
+    size_t *cabecalho;
+
+    (void)alocador;
+    cabecalho = (size_t *)(zerar ? calloc(1, CABECALHO_BLOCO + tamanho) : malloc(CABECALHO_BLOCO + tamanho));
+    if (cabecalho == NULL)
+    {
+        return NULL;
+    }
+    cabecalho[0] = tamanho;
+    return (unsigned char *)cabecalho + CABECALHO_BLOCO;
+}
+
+static void *realocarSistema(Alocador *alocador, void *bloco, size_t novoTamanho)
+{
+    size_t *cabecalho;
+
+    if (bloco == NULL)
+    {
+        return alocarSistema(alocador, novoTamanho, 0);
+    }
+
+    cabecalho = (size_t *)realloc((unsigned char *)bloco - CABECALHO_BLOCO, CABECALHO_BLOCO + novoTamanho);
+    if (cabecalho == NULL)
+    {
+        return NULL;
+    }
+    cabecalho[0] = novoTamanho;
+    return (unsigned char *)cabecalho + CABECALHO_BLOCO;
+}
+
+static void liberarSistema(Alocador *alocador, void *bloco)
+{
+    (void)alocador;
+    free((unsigned char *)bloco - CABECALHO_BLOCO);
+}
+
+/**
+ * Tamanho pedido de um bloco com cabeçalho de 16 bytes (sistema, arena e pool)
+ */
+static size_t tamanhoComCabecalho(Alocador *alocador, void *bloco)
+{
+    (void)alocador;
+    return *(size_t *)((unsigned char *)bloco - CABECALHO_BLOCO);
+}
+
+static const OperacoesAlocador OPERACOES_SISTEMA = {
+    "sistema", alocarSistema, realocarSistema, liberarSistema, tamanhoComCabecalho, NULL, NULL};
+
+static Alocador instanciaSistema = {&OPERACOES_SISTEMA, 0};
+
+/*
+ * Arena linear: trechos encadeados, cada bloco precedido do seu tamanho
+ */
+
+/**
+ * Trecho da arena; os blocos começam em dados + usado
+ */
+struct BlocoArena
+{
+    BlocoArena *anterior;
+    size_t capacidade;
+    size_t usado;
+    size_t preenchimento;
+    unsigned char dados[];
+};
+
+static void *alocarArena(Alocador *alocador, size_t tamanho, int zerar)
+{
+    AlocadorArena *arena = (AlocadorArena *)alocador;
+    size_t necessario = CABECALHO_BLOCO + alinharTamanho(tamanho);
+    BlocoArena *trecho = arena->trechos;
+    unsigned char *inicio;
+
+    if (trecho == NULL || trecho->capacidade - trecho->usado < necessario)
+    {
+        size_t capacidade = necessario > arena->tamanhoTrecho ? necessario : arena->tamanhoTrecho;
+
+        trecho = (BlocoArena *)malloc(sizeof(BlocoArena) + capacidade);
+        if (trecho == NULL)
+        {
+            return NULL;
+        }
+        trecho->anterior = arena->trechos;
+        trecho->capacidade = capacidade;
+        trecho->usado = 0;
+        arena->trechos = trecho;
+    }
+
+    inicio = trecho->dados + trecho->usado;
+    *(size_t *)inicio = tamanho;
+    trecho->usado += necessario;
+    arena->ultimo = inicio + CABECALHO_BLOCO;
+
+    if (zerar)
+    {
+        memset(arena->ultimo, 0, tamanho);
+    }
+    return arena->ultimo;
+}
+
+/**
+ * O último bloco da arena cresce no lugar quando há espaço no trecho;
+ * os demais são copiados para um bloco novo e o antigo só volta no reinício
+ */
+static void *realocarArena(Alocador *alocador, void *bloco, size_t novoTamanho)
+{
+    AlocadorArena *arena = (AlocadorArena *)alocador;
+    size_t *tamanhoAtual;
+    void *novo;
+
+    if (bloco == NULL)
+    {
+        return alocarArena(alocador, novoTamanho, 0);
+    }
+
+    tamanhoAtual = (size_t *)((unsigned char *)bloco - CABECALHO_BLOCO);
+    if (bloco == arena->ultimo)
+    {
+        BlocoArena *trecho = arena->trechos;
+        size_t inicio = (size_t)((unsigned char *)tamanhoAtual - trecho->dados);
+        size_t necessario = CABECALHO_BLOCO + alinharTamanho(novoTamanho);
+
+        if (trecho->capacidade - inicio >= necessario)
+        {
+            trecho->usado = inicio + necessario;
+            *tamanhoAtual = novoTamanho;
+            return bloco;
+        }
+    }
+
+    novo = alocarArena(alocador, novoTamanho, 0);
+    if (novo != NULL)
+    {
+        memcpy(novo, bloco, *tamanhoAtual < novoTamanho ? *tamanhoAtual : novoTamanho);
+    }
+    return novo;
+}
+
+/**
+ * Só o último bloco devolve o espaço na hora; os demais esperam o reinício
+ */
+static void liberarArena(Alocador *alocador, void *bloco)
+{
+    AlocadorArena *arena = (AlocadorArena *)alocador;
+
+    if (bloco == arena->ultimo)
+    {
+        BlocoArena *trecho = arena->trechos;
+        trecho->usado = (size_t)((unsigned char *)bloco - CABECALHO_BLOCO - trecho->dados);
+        arena->ultimo = NULL;
+    }
+}
+
+/**
+ * Libera tudo de uma vez, mantendo o trecho mais recente para a próxima rodada
+ */
+static void reiniciarArena(Alocador *alocador)
+{
+    AlocadorArena *arena = (AlocadorArena *)alocador;
+    BlocoArena *trecho = arena->trechos;
+
+    if (trecho == NULL)
+    {
+        return;
+    }
+
+    while (trecho->anterior != NULL)
+    {
+        BlocoArena *anterior = trecho->anterior->anterior;
+        free(trecho->anterior);
+        trecho->anterior = anterior;
+    }
+    trecho->usado = 0;
+    arena->ultimo = NULL;
+}
+
+static void destruirArena(Alocador *alocador)
+{
+    AlocadorArena *arena = (AlocadorArena *)alocador;
+
+    while (arena->trechos != NULL)
+    {
+        BlocoArena *anterior = arena->trechos->anterior;
+        free(arena->trechos);
+        arena->trechos = anterior;
+    }
+    arena->ultimo = NULL;
+}
+
+static const OperacoesAlocador OPERACOES_ARENA = {
+    "arena", alocarArena, realocarArena, liberarArena, tamanhoComCabecalho, reiniciarArena, destruirArena};
+
+/**
+ * Função para inicializar uma arena linear
+ */
+void iniciarAlocadorArena(AlocadorArena *arena, size_t tamanhoTrecho)
+{
+    arena->base.operacoes = &OPERACOES_ARENA;
+    arena->base.bytesVivos = 0;
+    arena->trechos = NULL;
+    arena->tamanhoTrecho = tamanhoTrecho > 0 ? tamanhoTrecho : TRECHO_ARENA_GLOBAL;
+    arena->ultimo = NULL;
+}
+
+/*
+ * Pool de tamanho fixo: cabeçalho com tamanho e origem, lista de livres encadeada nos próprios objetos
+ */
+
+/**
+ * Enlace que precede o cabeçalho de um bloco repassado ao sistema
+ * Encadeia todos esses blocos para que reiniciar e destruir o pool os liberem
+ */
+typedef struct EnlacePool
+{
+    struct EnlacePool *anterior;
+    struct EnlacePool *proximo;
+} EnlacePool;
+
+static size_t passoPool(const AlocadorPool *pool)
+{
+    return CABECALHO_BLOCO + alinharTamanho(pool->tamanhoObjeto);
+}
+
+static size_t tamanhoEnlacePool(void)
+{
+    return alinharTamanho(sizeof(EnlacePool));
+}
+
+/**
+ * Funções auxiliares que ligam e desligam um bloco repassado da lista do pool
+ */
+static void ligarBlocoSistema(AlocadorPool *pool, EnlacePool *enlace)
+{
+    enlace->anterior = NULL;
+    enlace->proximo = (EnlacePool *)pool->sistema;
+    if (enlace->proximo != NULL)
+    {
+        enlace->proximo->anterior = enlace;
+    }
+    pool->sistema = enlace;
+}
+
+static void desligarBlocoSistema(AlocadorPool *pool, EnlacePool *enlace)
+{
+    if (enlace->anterior != NULL)
+    {
+        enlace->anterior->proximo = enlace->proximo;
+    }
+    else
+    {
+        pool->sistema = enlace->proximo;
+    }
+    if (enlace->proximo != NULL)
+    {
+        enlace->proximo->anterior = enlace->anterior;
     }
 }
 
+static EnlacePool *enlaceDoBloco(void *bloco)
+{
+    return (EnlacePool *)((unsigned char *)bloco - CABECALHO_BLOCO - tamanhoEnlacePool());
+}
+
+/**
+ * Libera de uma vez todos os blocos que o pool repassou ao sistema
+ */
+static void liberarBlocosSistema(AlocadorPool *pool)
+{
+    while (pool->sistema != NULL)
+    {
+        EnlacePool *proximo = ((EnlacePool *)pool->sistema)->proximo;
+        free(pool->sistema);
+        pool->sistema = proximo;
+    }
+}
+
+static void *alocarPool(Alocador *alocador, size_t tamanho, int zerar)
+{
+    AlocadorPool *pool = (AlocadorPool *)alocador;
+    size_t *cabecalho;
+
+    if (tamanho > pool->tamanhoObjeto)
+    {
+        size_t total = tamanhoEnlacePool() + CABECALHO_BLOCO + tamanho;
+        EnlacePool *enlace = (EnlacePool *)(zerar ? calloc(1, total) : malloc(total));
+
+        if (enlace == NULL)
+        {
+            return NULL;
+        }
+        ligarBlocoSistema(pool, enlace);
+        cabecalho = (size_t *)((unsigned char *)enlace + tamanhoEnlacePool());
+        cabecalho[0] = tamanho;
+        cabecalho[1] = ORIGEM_SISTEMA;
+        return (unsigned char *)cabecalho + CABECALHO_BLOCO;
+    }
+
+    if (pool->livres == NULL)
+    {
+        // Lote novo: o primeiro campo encadeia os lotes, os objetos vêm depois
+        unsigned char *lote = (unsigned char *)malloc(ALINHAMENTO_ALOCADOR + pool->objetosPorLote * passoPool(pool));
+
+        if (lote == NULL)
+        {
+            return NULL;
+        }
+        *(void **)lote = pool->lotes;
+        pool->lotes = lote;
+
+        for (size_t i = pool->objetosPorLote; i > 0; i--)
+        {
+            size_t *objeto = (size_t *)(lote + ALINHAMENTO_ALOCADOR + (i - 1) * passoPool(pool));
+            *(void **)(objeto + 2) = pool->livres;
+            pool->livres = objeto;
+        }
+    }
+
+    cabecalho = (size_t *)pool->livres;
+    pool->livres = *(void **)(cabecalho + 2);
+    cabecalho[0] = tamanho;
+    cabecalho[1] = ORIGEM_POOL;
+
+    if (zerar)
+    {
+        memset(cabecalho + 2, 0, tamanho);
+    }
+    return (unsigned char *)cabecalho + CABECALHO_BLOCO;
+}
+
+static void liberarPool(Alocador *alocador, void *bloco)
+{
+    AlocadorPool *pool = (AlocadorPool *)alocador;
+    size_t *cabecalho = (size_t *)((unsigned char *)bloco - CABECALHO_BLOCO);
+
+    if (cabecalho[1] == ORIGEM_SISTEMA)
+    {
+        EnlacePool *enlace = enlaceDoBloco(bloco);
+        desligarBlocoSistema(pool, enlace);
+        free(enlace);
+        return;
+    }
+
+    *(void **)(cabecalho + 2) = pool->livres;
+    pool->livres = cabecalho;
+}
+
+static void *realocarPool(Alocador *alocador, void *bloco, size_t novoTamanho)
+{
+    AlocadorPool *pool = (AlocadorPool *)alocador;
+    size_t *cabecalho;
+    void *novo;
+
+    if (bloco == NULL)
+    {
+        return alocarPool(alocador, novoTamanho, 0);
+    }
+
+    cabecalho = (size_t *)((unsigned char *)bloco - CABECALHO_BLOCO);
+    if (cabecalho[1] == ORIGEM_POOL && novoTamanho <= pool->tamanhoObjeto)
+    {
+        cabecalho[0] = novoTamanho;
+        return bloco;
+    }
+    if (cabecalho[1] == ORIGEM_SISTEMA && novoTamanho > pool->tamanhoObjeto)
+    {
+        // O bloco sai da lista antes do realloc e volta com o endereço novo
+        EnlacePool *enlace = enlaceDoBloco(bloco);
+        EnlacePool *novoEnlace;
+
+        desligarBlocoSistema(pool, enlace);
+        novoEnlace = (EnlacePool *)realloc(enlace, tamanhoEnlacePool() + CABECALHO_BLOCO + novoTamanho);
+        if (novoEnlace == NULL)
+        {
+            ligarBlocoSistema(pool, enlace);
+            return NULL;
+        }
+        ligarBlocoSistema(pool, novoEnlace);
+        cabecalho = (size_t *)((unsigned char *)novoEnlace + tamanhoEnlacePool());
+        cabecalho[0] = novoTamanho;
+        return (unsigned char *)cabecalho + CABECALHO_BLOCO;
+    }
+
+    // O bloco muda de origem: copia para um bloco novo
+    novo = alocarPool(alocador, novoTamanho, 0);
+    if (novo != NULL)
+    {
+        memcpy(novo, bloco, cabecalho[0] < novoTamanho ? cabecalho[0] : novoTamanho);
+        liberarPool(alocador, bloco);
+    }
+    return novo;
+}
+
+/**
+ * Devolve todos os objetos dos lotes à lista de livres e libera os blocos repassados ao sistema
+ */
+static void reiniciarPool(Alocador *alocador)
+{
+    AlocadorPool *pool = (AlocadorPool *)alocador;
+
+    liberarBlocosSistema(pool);
+    pool->livres = NULL;
+    for (unsigned char *lote = (unsigned char *)pool->lotes; lote != NULL; lote = *(unsigned char **)lote)
+    {
+        for (size_t i = 0; i < pool->objetosPorLote; i++)
+        {
+            size_t *objeto = (size_t *)(lote + ALINHAMENTO_ALOCADOR + i * passoPool(pool));
+            *(void **)(objeto + 2) = pool->livres;
+            pool->livres = objeto;
+        }
+    }
+}
+
+static void destruirPool(Alocador *alocador)
+{
+    AlocadorPool *pool = (AlocadorPool *)alocador;
+
+    liberarBlocosSistema(pool);
+    while (pool->lotes != NULL)
+    {
+        void *proximo = *(void **)pool->lotes;
+        free(pool->lotes);
+        pool->lotes = proximo;
+    }
+    pool->livres = NULL;
+}
+
+static const OperacoesAlocador OPERACOES_POOL = {
+    "pool", alocarPool, realocarPool, liberarPool, tamanhoComCabecalho, reiniciarPool, destruirPool};
+
+/**
+ * Função para inicializar um pool de objetos de tamanho fixo
+ * O objeto precisa comportar o ponteiro da lista de livres
+ */
+void iniciarAlocadorPool(AlocadorPool *pool, size_t tamanhoObjeto, size_t objetosPorLote)
+{
+    pool->base.operacoes = &OPERACOES_POOL;
+    pool->base.bytesVivos = 0;
+    pool->tamanhoObjeto = tamanhoObjeto < sizeof(void *) ? sizeof(void *) : tamanhoObjeto;
+    pool->objetosPorLote = objetosPorLote > 0 ? objetosPorLote : LOTE_POOL_GLOBAL;
+    pool->livres = NULL;
+    pool->lotes = NULL;
+    pool->sistema = NULL;
+}
+
+/*
+ * Alocador por mmap: cabeçalho de 64 bytes com o tamanho pedido e o tamanho mapeado (0 = malloc)
+ */
+
+/**
+ * Função auxiliar que mapeia uma região anônima e pede páginas enormes ao núcleo
+ */
+static void *mapearRegiao(size_t bytes)
+{
+    void *regiao = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (regiao == MAP_FAILED)
+    {
+        return NULL;
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(regiao, bytes, MADV_HUGEPAGE);
+#endif
+    return regiao;
+}
+
+/**
+ * Função auxiliar que arredonda o tamanho mapeado para páginas inteiras
+ */
+static size_t tamanhoMapeado(size_t tamanho)
+{
+    size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+    return (CABECALHO_MMAP + tamanho + pagina - 1) / pagina * pagina;
+}
+
+static void *alocarMmap(Alocador *alocador, size_t tamanho, int zerar)
+{
+    AlocadorMmap *alocadorMmap = (AlocadorMmap *)alocador;
+    size_t *cabecalho;
+
+    if (tamanho < alocadorMmap->limiar)
+    {
+        cabecalho = (size_t *)(zerar ? calloc(1, CABECALHO_MMAP + tamanho) : malloc(CABECALHO_MMAP + tamanho));
+        if (cabecalho == NULL)
+        {
+            return NULL;
+        }
+        cabecalho[1] = 0;
+    }
+    else
+    {
+        // Páginas anônimas já chegam zeradas: não há nada a limpar
+        size_t mapeado = tamanhoMapeado(tamanho);
+
+        cabecalho = (size_t *)mapearRegiao(mapeado);
+        if (cabecalho == NULL)
+        {
+            return NULL;
+        }
+        cabecalho[1] = mapeado;
+    }
+
+    cabecalho[0] = tamanho;
+    return (unsigned char *)cabecalho + CABECALHO_MMAP;
+}
+
+static void liberarMmap(Alocador *alocador, void *bloco)
+{
+    size_t *cabecalho = (size_t *)((unsigned char *)bloco - CABECALHO_MMAP);
+
+    (void)alocador;
+    if (cabecalho[1] == 0)
+    {
+        free(cabecalho);
+    }
+    else
+    {
+        munmap(cabecalho, cabecalho[1]);
+    }
+}
+
+static void *realocarMmap(Alocador *alocador, void *bloco, size_t novoTamanho)
+{
+    AlocadorMmap *alocadorMmap = (AlocadorMmap *)alocador;
+    size_t *cabecalho;
+    void *novo;
+
+    if (bloco == NULL)
+    {
+        return alocarMmap(alocador, novoTamanho, 0);
+    }
+
+    cabecalho = (size_t *)((unsigned char *)bloco - CABECALHO_MMAP);
+
+    // Blocos pequenos continuam no malloc enquanto não passarem do limiar
+    if (cabecalho[1] == 0 && novoTamanho < alocadorMmap->limiar)
+    {
+        cabecalho = (size_t *)realloc(cabecalho, CABECALHO_MMAP + novoTamanho);
+        if (cabecalho == NULL)
+        {
+            return NULL;
+        }
+        cabecalho[0] = novoTamanho;
+        return (unsigned char *)cabecalho + CABECALHO_MMAP;
+    }
+
+    // Mapeamentos cabem no espaço já mapeado ou são remapeados sem cópia pelo núcleo
+    if (cabecalho[1] != 0 && novoTamanho >= alocadorMmap->limiar)
+    {
+        size_t mapeado = tamanhoMapeado(novoTamanho);
+
+        if (mapeado <= cabecalho[1])
+        {
+            cabecalho[0] = novoTamanho;
+            return bloco;
+        }
+#ifdef MREMAP_MAYMOVE
+        cabecalho = (size_t *)mremap(cabecalho, cabecalho[1], mapeado, MREMAP_MAYMOVE);
+        if (cabecalho == MAP_FAILED)
+        {
+            return NULL;
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(cabecalho, mapeado, MADV_HUGEPAGE);
+#endif
+        cabecalho[0] = novoTamanho;
+        cabecalho[1] = mapeado;
+        return (unsigned char *)cabecalho + CABECALHO_MMAP;
+#endif
+    }
+
+    novo = alocarMmap(alocador, novoTamanho, 0);
+    if (novo != NULL)
+    {
+        memcpy(novo, bloco, cabecalho[0] < novoTamanho ? cabecalho[0] : novoTamanho);
+        liberarMmap(alocador, bloco);
+    }
+    return novo;
+}
+
+static size_t tamanhoMmap(Alocador *alocador, void *bloco)
+{
+    (void)alocador;
+    return *(size_t *)((unsigned char *)bloco - CABECALHO_MMAP);
+}
+
+static const OperacoesAlocador OPERACOES_MMAP = {
+    "mmap", alocarMmap, realocarMmap, liberarMmap, tamanhoMmap, NULL, NULL};
+
+/**
+ * Função para inicializar o alocador por mmap
+ */
+void iniciarAlocadorMmap(AlocadorMmap *alocadorMmap, size_t limiar)
+{
+    alocadorMmap->base.operacoes = &OPERACOES_MMAP;
+    alocadorMmap->base.bytesVivos = 0;
+    alocadorMmap->limiar = limiar;
+}
+
+/*
+ * Seleção do alocador global
+ */
+
+static AlocadorArena arenaGlobal;
+static AlocadorPool poolGlobal;
+static AlocadorMmap mmapGlobal;
+static Alocador *alocadorEscolhido = &instanciaSistema;
+
+/**
+ * Função para obter o alocador do sistema (malloc, calloc, realloc e free)
+ */
+Alocador *alocadorSistema(void)
+{
+    return &instanciaSistema;
+}
+
+/**
+ * Função para escolher, na inicialização, o alocador usado pelo mapa do jogo
+ */
+int selecionarAlocador(const char *nome)
+{
+    if (strcmp(nome, "sistema") == 0)
+    {
+        alocadorEscolhido = &instanciaSistema;
+    }
+    else if (strcmp(nome, "arena") == 0)
+    {
+        iniciarAlocadorArena(&arenaGlobal, TRECHO_ARENA_GLOBAL);
+        alocadorEscolhido = &arenaGlobal.base;
+    }
+    else if (strcmp(nome, "pool") == 0)
+    {
+        iniciarAlocadorPool(&poolGlobal, OBJETO_POOL_GLOBAL, LOTE_POOL_GLOBAL);
+        alocadorEscolhido = &poolGlobal.base;
+    }
+    else if (strcmp(nome, "mmap") == 0)
+    {
+        iniciarAlocadorMmap(&mmapGlobal, LIMIAR_MMAP_GLOBAL);
+        alocadorEscolhido = &mmapGlobal.base;
+    }
+    else
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Função para obter o alocador escolhido (o do sistema, se nenhum foi escolhido)
+ */
+Alocador *alocadorAtual(void)
+{
+    return alocadorEscolhido;
+}
+
 /**
  * Função para alocar memória para territórios
  * Implementa passagem por referência para o tipo de alocação
+ * A memória vem do alocador escolhido na inicialização (ver selecionarAlocador)
  */
 Territorio *alocarTerritorios(int quantidade, TipoAlocacao *tipoAlocacao)
 {
@@ -40,58 +905,139 @@ Territorio *alocarTerritorios(int quantidade, TipoAlocacao *tipoAlocacao)
     // Aloca a memória de acordo com o tipo escolhido
     if (*tipoAlocacao == USAR_MALLOC)
     {
+        size_t bytes = (size_t)quantidade * sizeof(Territorio);
+
+        if (bytes >= LIMIAR_MAPA_GRANDE)
+        {
+            // Mapas enormes: o sistema (calloc acima do limiar de mmap do glibc) e o alocador mmap
+            // devolvem páginas anônimas que o núcleo zera no primeiro acesso, sem varrer o bloco agora
+            return (Territorio *)alocarMemoria(alocadorAtual(), bytes, 1);
+        }
+
         // Aloca memória sem inicializar (mais rápido para grandes blocos)
-        mapa = (Territorio *)malloc(quantidade * sizeof(Territorio));
+        mapa = (Territorio *)alocarMemoria(alocadorAtual(), bytes, 0);
 
-        // Inicialização manual necessária após malloc
+        // Inicialização manual necessária após malloc, de uma vez só
         if (mapa != NULL)
         {
-            for (int i = 0; i < quantidade; i++)
-            {
-                memset(&mapa[i], 0, sizeof(Territorio));
-            }
+            memset(mapa, 0, bytes);
         }
     }
     else
     {
         // Aloca E inicializa memória com zeros (mais seguro, ligeiramente mais lento)
-        mapa = (Territorio *)calloc(quantidade, sizeof(Territorio));
+        mapa = (Territorio *)alocarMemoria(alocadorAtual(), quantidade * sizeof(Territorio), 1);
     }
 
     return mapa;
 }
 
 /**
- * Função para realocar memória para territórios
- * Implementa passagem por referência para o tipo de alocação
+ * Função para liberar a memória alocada para o vetor de territórios
  */
-Territorio *realocarTerritorios(Territorio *mapa, int quantidadeAtual, int novaQuantidade, TipoAlocacao *tipoAlocacao)
+void liberarMemoria(Territorio *mapa)
 {
-    Territorio *novoMapa;
+    liberarBloco(alocadorAtual(), mapa);
+}
 
-    // Reavalia o método de alocação ideal para o novo tamanho total
-    TipoAlocacao novoTipoAlocacao = escolherTipoAlocacao(novaQuantidade, sizeof(Territorio));
-    *tipoAlocacao = novoTipoAlocacao; // Atualiza o tipo para futuras realocações
+/**
+ * Fatia de páginas tocada por uma thread no primeiro toque paralelo
+ */
+typedef struct
+{
+    unsigned char *inicio;
+    size_t bytes;
+    size_t pagina;
+} FatiaPaginas;
 
-    // Realoca o bloco para o novo tamanho
-    novoMapa = (Territorio *)realloc(mapa, novaQuantidade * sizeof(Territorio));
+/**
+ * Função executada por cada thread do primeiro toque: reescreve um byte por página,
+ * com o próprio valor, para forçar a falta de página sem alterar o conteúdo
+ */
+static void *tocarFatia(void *argumento)
+{
+    FatiaPaginas *fatia = (FatiaPaginas *)argumento;
+    volatile unsigned char *byte = fatia->inicio;
 
-    // Inicializa os novos territórios se necessário e se a realocação foi bem-sucedida
-    if (novoMapa != NULL && *tipoAlocacao == USAR_MALLOC)
+    for (size_t deslocamento = 0; deslocamento < fatia->bytes; deslocamento += fatia->pagina)
     {
-        for (int i = quantidadeAtual; i < novaQuantidade; i++)
-        {
-            memset(&novoMapa[i], 0, sizeof(Territorio));
-        }
+        byte[deslocamento] = byte[deslocamento];
     }
-
-    return novoMapa;
+    return NULL;
 }
 
 /**
- * Função para liberar a memória alocada para o vetor de territórios
+ * Função para tocar pela primeira vez todas as páginas de um bloco, dividindo-as entre threads
  */
-void liberarMemoria(Territorio *mapa)
+int tocarPaginas(void *bloco, size_t bytes, int threads)
 {
-    free(mapa);
+    size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+    uintptr_t inicio = (uintptr_t)bloco;
+    uintptr_t fim = inicio + bytes;
+    uintptr_t base = inicio - inicio % pagina;
+    size_t paginas, porThread;
+    FatiaPaginas fatias[MAX_THREADS_TOQUE];
+    pthread_t identificadores[MAX_THREADS_TOQUE];
+    int criada[MAX_THREADS_TOQUE] = {0};
+    int iniciadas = 1;
+
+    if (bloco == NULL || bytes == 0)
+    {
+        return 0;
+    }
+
+    if (threads <= 0)
+    {
+        long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = nucleos > 0 ? (int)nucleos : 1;
+    }
+    if (threads > MAX_THREADS_TOQUE)
+    {
+        threads = MAX_THREADS_TOQUE;
+    }
+
+    // Divide as páginas inteiras entre as threads; as pontas do bloco ficam com a primeira e a última
+    paginas = (fim - base + pagina - 1) / pagina;
+    if ((size_t)threads > paginas)
+    {
+        threads = (int)paginas;
+    }
+    porThread = (paginas + threads - 1) / threads;
+
+    for (int t = 0; t < threads; t++)
+    {
+        uintptr_t de = base + (uintptr_t)t * porThread * pagina;
+        uintptr_t ate = de + porThread * pagina;
+
+        de = de < inicio ? inicio : de;
+        ate = ate > fim ? fim : ate;
+        fatias[t].inicio = (unsigned char *)bloco + (de - inicio);
+        fatias[t].bytes = ate > de ? ate - de : 0;
+        fatias[t].pagina = pagina;
+    }
+
+    // A thread principal fica com a primeira fatia; se alguma thread não puder ser criada, faz a parte dela
+    for (int t = 1; t < threads; t++)
+    {
+        criada[t] = pthread_create(&identificadores[t], NULL, tocarFatia, &fatias[t]) == 0;
+        if (criada[t])
+        {
+            iniciadas++;
+        }
+        else
+        {
+            tocarFatia(&fatias[t]);
+        }
+    }
+    tocarFatia(&fatias[0]);
+
+    for (int t = 1; t < threads; t++)
+    {
+        if (criada[t])
+        {
+            pthread_join(identificadores[t], NULL);
+        }
+    }
+
+    return iniciadas;
 }
@@ -6,6 +6,7 @@
 #ifndef ALOCACAO_H
 #define ALOCACAO_H
 
+#include <stddef.h>
 #include "territorio.h"
 
 // Definição do tipo de alocação
@@ -15,6 +16,171 @@ typedef enum
     USAR_CALLOC
 } TipoAlocacao;
 
+// Quantidade de valores de TipoAlocacao
+#define TIPOS_ALOCACAO 2
+
+typedef struct Alocador Alocador;
+
+/**
+ * Telemetria acumulada de todos os alocadores desde o início do programa
+ * - bytesVivos/picoBytes: bytes pedidos e ainda não liberados, agora e no máximo
+ * - alocacoes/realocacoes/liberacoes: chamadas bem-sucedidas de cada operação
+ * - realocacoesMovidas: realocações que precisaram mudar o bloco de endereço
+ * - decisoes: quantas vezes escolherTipoAlocacao recomendou cada TipoAlocacao
+ */
+typedef struct
+{
+    size_t bytesVivos;
+    size_t picoBytes;
+    long long alocacoes;
+    long long realocacoes;
+    long long liberacoes;
+    long long realocacoesMovidas;
+    long long decisoes[TIPOS_ALOCACAO];
+} EstatisticasAlocacao;
+
+/**
+ * Tabela de operações de um alocador
+ * - nome: nome usado na seleção por linha de comando
+ * - alocar: devolve 'tamanho' bytes, zerados se 'zerar' for diferente de zero
+ * - realocar: muda o tamanho de um bloco preservando o conteúdo (NULL aloca um bloco novo)
+ * - liberar: devolve um bloco ao alocador (NULL é ignorado)
+ * - tamanho: tamanho pedido para um bloco ainda vivo
+ * - reiniciar: libera de uma vez todos os blocos do alocador (NULL se não suportado)
+ * - destruir: devolve ao sistema toda a memória do próprio alocador
+ *
+ * Todos os blocos são alinhados em pelo menos 16 bytes.
+ */
+typedef struct
+{
+    const char *nome;
+    void *(*alocar)(Alocador *alocador, size_t tamanho, int zerar);
+    void *(*realocar)(Alocador *alocador, void *bloco, size_t novoTamanho);
+    void (*liberar)(Alocador *alocador, void *bloco);
+    size_t (*tamanho)(Alocador *alocador, void *bloco);
+    void (*reiniciar)(Alocador *alocador);
+    void (*destruir)(Alocador *alocador);
+} OperacoesAlocador;
+
+/**
+ * Alocador genérico: cada implementação começa com esta estrutura
+ * - bytesVivos: bytes pedidos e ainda não devolvidos a este alocador
+ */
+struct Alocador
+{
+    const OperacoesAlocador *operacoes;
+    size_t bytesVivos;
+};
+
+typedef struct BlocoArena BlocoArena;
+
+/**
+ * Arena linear: os blocos são recortados em sequência de trechos grandes e
+ * liberados todos juntos por reiniciarAlocador. Ideal para o estado de uma
+ * partida, que morre inteiro no fim. Não é segura para uso entre threads.
+ */
+typedef struct
+{
+    Alocador base;
+    BlocoArena *trechos;
+    size_t tamanhoTrecho;
+    void *ultimo;
+} AlocadorArena;
+
+/**
+ * Pool de objetos de tamanho fixo, com lista de livres
+ * Pedidos maiores que 'tamanhoObjeto' são repassados ao sistema, então o pool
+ * pode atender qualquer pedido. Esses blocos ficam numa lista própria
+ * ('sistema') e também são devolvidos por reiniciarAlocador e destruirAlocador.
+ * Não é seguro para uso entre threads.
+ */
+typedef struct
+{
+    Alocador base;
+    size_t tamanhoObjeto;
+    size_t objetosPorLote;
+    void *livres;
+    void *lotes;
+    void *sistema;
+} AlocadorPool;
+
+/**
+ * Alocador por mmap para mapas muito grandes
+ * Pedidos a partir de 'limiar' bytes viram mapeamentos anônimos marcados com
+ * MADV_HUGEPAGE (já zerados pelo núcleo); os menores usam o malloc.
+ */
+typedef struct
+{
+    Alocador base;
+    size_t limiar;
+} AlocadorMmap;
+
+/**
+ * Funções para usar qualquer alocador através da sua tabela de operações
+ */
+void *alocarMemoria(Alocador *alocador, size_t tamanho, int zerar);
+void *realocarMemoria(Alocador *alocador, void *bloco, size_t novoTamanho);
+void liberarBloco(Alocador *alocador, void *bloco);
+void reiniciarAlocador(Alocador *alocador);
+void destruirAlocador(Alocador *alocador);
+
+/**
+ * Função para inicializar uma arena linear
+ * @param arena Ponteiro para a arena
+ * @param tamanhoTrecho Tamanho de cada trecho pedido ao sistema
+ */
+void iniciarAlocadorArena(AlocadorArena *arena, size_t tamanhoTrecho);
+
+/**
+ * Função para inicializar um pool de objetos de tamanho fixo
+ * @param pool Ponteiro para o pool
+ * @param tamanhoObjeto Tamanho máximo atendido pelo pool
+ * @param objetosPorLote Quantidade de objetos pedidos ao sistema de cada vez
+ */
+void iniciarAlocadorPool(AlocadorPool *pool, size_t tamanhoObjeto, size_t objetosPorLote);
+
+/**
+ * Função para inicializar o alocador por mmap
+ * @param alocadorMmap Ponteiro para o alocador
+ * @param limiar Tamanho a partir do qual os blocos são mapeados
+ */
+void iniciarAlocadorMmap(AlocadorMmap *alocadorMmap, size_t limiar);
+
+/**
+ * Função para obter o alocador do sistema (malloc, calloc, realloc e free)
+ * @return Ponteiro para o alocador do sistema
+ */
+Alocador *alocadorSistema(void);
+
+/**
+ * Função para escolher, na inicialização, o alocador usado pelo mapa do jogo
+ *
+ * Deve ser chamada antes de qualquer alocação de territórios: blocos alocados
+ * por um alocador só podem ser liberados por ele mesmo.
+ *
+ * @param nome "sistema", "arena", "pool" ou "mmap"
+ * @return 1 se o nome é válido, 0 caso contrário
+ */
+int selecionarAlocador(const char *nome);
+
+/**
+ * Função para obter o alocador escolhido (o do sistema, se nenhum foi escolhido)
+ * @return Ponteiro para o alocador atual
+ */
+Alocador *alocadorAtual(void);
+
+/**
+ * Função para copiar a telemetria acumulada de todos os alocadores
+ * @param saida Ponteiro para a estrutura que receberá os contadores
+ */
+void obterEstatisticasAlocacao(EstatisticasAlocacao *saida);
+
+/**
+ * Função para exibir o relatório da telemetria de alocação
+ * @param dados Contadores obtidos com obterEstatisticasAlocacao
+ */
+void exibirEstatisticasAlocacao(const EstatisticasAlocacao *dados);
+
 /**
  * Função auxiliar para determinar o melhor tipo de alocação com base na quantidade e tamanho
  *
@@ -31,26 +197,39 @@ TipoAlocacao escolherTipoAlocacao(int quantidade, size_t tamanhoElemento);
 
 /**
  * Função para alocar memória para territórios
+ *
+ * Mapas a partir de 4 MiB são pedidos já zerados ao alocador, que os entrega em
+ * páginas anônimas zeradas pelo núcleo sob demanda: o custo passa para as faltas
+ * de página do primeiro acesso (ver tocarPaginas) em vez de uma varredura inicial.
+ *
  * @param quantidade Quantidade de territórios a alocar
  * @param tipoAlocacao Ponteiro para receber o tipo de alocação escolhido
  * @return Ponteiro para o vetor de territórios alocado ou NULL em caso de falha
  */
 Territorio *alocarTerritorios(int quantidade, TipoAlocacao *tipoAlocacao);
 
-/**
- * Função para realocar memória para territórios
- * @param mapa Ponteiro atual para o vetor de territórios
- * @param quantidadeAtual Quantidade atual de territórios
- * @param novaQuantidade Nova quantidade de territórios
- * @param tipoAlocacao Ponteiro para o tipo de alocação (será atualizado se necessário)
- * @return Ponteiro para o novo vetor de territórios realocado ou NULL em caso de falha
- */
-Territorio *realocarTerritorios(Territorio *mapa, int quantidadeAtual, int novaQuantidade, TipoAlocacao *tipoAlocacao);
-
 /**
  * Função para liberar a memória alocada para o vetor de territórios
  * @param mapa Ponteiro para o vetor de territórios
  */
 void liberarMemoria(Territorio *mapa);
 
+/**
+ * Função para tocar pela primeira vez todas as páginas de um bloco, dividindo-as entre threads
+ *
+ * Mapas grandes chegam de alocarTerritorios com páginas ainda não mapeadas; cada
+ * página só é zerada pelo núcleo no primeiro acesso. Tocá-las em paralelo espalha
+ * essas faltas de página entre os núcleos (e, em máquinas NUMA, deixa cada fatia
+ * no nó da thread que a tocou). O conteúdo do bloco não é alterado.
+ *
+ * @param bloco Início do bloco
+ * @param bytes Tamanho do bloco em bytes
+ * @param threads Quantidade de threads (0 ou menos usa uma por núcleo)
+ * @return Quantidade de threads que efetivamente tocaram páginas
+ */
+int tocarPaginas(void *bloco, size_t bytes, int threads);
+
+// A partir deste tamanho o mapa é pedido já zerado: o núcleo entrega páginas zeradas sob demanda
+#define LIMIAR_MAPA_GRANDE ((size_t)4 << 20)
+
 #endif /* ALOCACAO_H */
@@ -0,0 +1,421 @@
+/**
+ * arquivomapa.c - Implementação do formato binário .wmap
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "arquivomapa.h"
+#include "cores.h"
+#include "nomes.h"
+
+// Buffer do arquivo durante a gravação
+#define BUFFER_GRAVACAO_MAPA (1 << 20)
+
+// A marca de ordem precisa cair no mesmo lugar em qualquer compilador: o cabeçalho tem 128 bytes fixos
+typedef char verificarTamanhoCabecalhoMapa[sizeof(CabecalhoMapaArquivo) == 128 ? 1 : -1];
+
+/**
+ * Função auxiliar que arredonda uma posição para o início da próxima seção
+ */
+static uint64_t alinharSecao(uint64_t posicao)
+{
+    return (posicao + ALINHAMENTO_SECAO_MAPA - 1) & ~(uint64_t)(ALINHAMENTO_SECAO_MAPA - 1);
+}
+
+/**
+ * Função auxiliar que grava uma seção precedida dos zeros que a alinham
+ */
+static int gravarSecao(FILE *arquivo, uint64_t *posicao, uint64_t inicio, const void *dados, size_t bytes)
+{
+    static const unsigned char zeros[ALINHAMENTO_SECAO_MAPA];
+    size_t preenchimento = (size_t)(inicio - *posicao);
+
+    if (fwrite(zeros, 1, preenchimento, arquivo) != preenchimento ||
+        (bytes > 0 && fwrite(dados, 1, bytes, arquivo) != bytes))
+    {
+        return 0;
+    }
+
+    *posicao = inicio + bytes;
+    return 1;
+}
+
+/**
+ * Função auxiliar que monta o cabeçalho e grava o arquivo a partir dos vetores já alocados
+ * Os deslocamentos das seções são calculados antes, então cada seção é gravada uma única vez
+ */
+static int gravarMapaArquivo(const char *caminho, const MapaSoA *mapa, const GrafoFronteiras *fronteiras,
+                             uint32_t *deslocamentosNomes)
+{
+    CabecalhoMapaArquivo cabecalho;
+    char cores[MAX_CORES][TAMANHO_COR];
+    FILE *arquivo;
+    uint32_t fim = 0;
+    int cobertos = 0;
+    uint64_t textos = 0, posicao = sizeof(CabecalhoMapaArquivo);
+    int quantidade = mapa->quantidade;
+    int quantidadeCores = 0;
+    int sucesso;
+
+    // Tropas e donos já estão no formato do arquivo; falta a posição de cada nome na tabela de textos
+    for (int i = 0; i < quantidade; i++)
+    {
+        deslocamentosNomes[i] = (uint32_t)textos;
+        textos += mapa->nomes[i].comprimento;
+        if (mapa->donos[i] >= quantidadeCores)
+        {
+            quantidadeCores = mapa->donos[i] + 1;
+        }
+        if (textos > UINT32_MAX)
+        {
+            return 0;
+        }
+    }
+    deslocamentosNomes[quantidade] = (uint32_t)textos;
+
+    // A tabela de cores repete a tabela global até o maior identificador usado
+    memset(cores, 0, sizeof(cores));
+    for (int c = 0; c < quantidadeCores; c++)
+    {
+        strncpy(cores[c], nomeCor((uint16_t)c), TAMANHO_COR - 1);
+    }
+
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.assinatura, MAPA_ARQUIVO_ASSINATURA, 4);
+    cabecalho.versao = MAPA_ARQUIVO_VERSAO;
+    cabecalho.ordemBytes = MAPA_ARQUIVO_ORDEM;
+    cabecalho.quantidadeTerritorios = (uint32_t)quantidade;
+    cabecalho.quantidadeCores = (uint32_t)quantidadeCores;
+    cabecalho.tamanhoTextos = textos;
+    cabecalho.entradasAdjacencia = fronteiras != NULL ? fronteiras->entradas : 0;
+    cabecalho.deslocamentoTropas = alinharSecao(sizeof(CabecalhoMapaArquivo));
+    cabecalho.deslocamentoDonos = alinharSecao(cabecalho.deslocamentoTropas + (uint64_t)quantidade * sizeof(int32_t));
+    cabecalho.deslocamentoNomes = alinharSecao(cabecalho.deslocamentoDonos + (uint64_t)quantidade * sizeof(uint16_t));
+    cabecalho.deslocamentoTextos = alinharSecao(cabecalho.deslocamentoNomes + ((uint64_t)quantidade + 1) * sizeof(uint32_t));
+    cabecalho.deslocamentoCores = alinharSecao(cabecalho.deslocamentoTextos + textos);
+    cabecalho.deslocamentoAdjacencia = alinharSecao(cabecalho.deslocamentoCores + (uint64_t)quantidadeCores * TAMANHO_COR);
+    cabecalho.deslocamentoVizinhos = alinharSecao(cabecalho.deslocamentoAdjacencia + ((uint64_t)quantidade + 1) * sizeof(uint32_t));
+    cabecalho.tamanhoArquivo = cabecalho.deslocamentoVizinhos + cabecalho.entradasAdjacencia * sizeof(uint32_t);
+
+    arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL)
+    {
+        return 0;
+    }
+    setvbuf(arquivo, NULL, _IOFBF, BUFFER_GRAVACAO_MAPA);
+
+    sucesso = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+              gravarSecao(arquivo, &posicao, cabecalho.deslocamentoTropas, mapa->tropas,
+                          (size_t)quantidade * sizeof(int32_t)) &&
+              gravarSecao(arquivo, &posicao, cabecalho.deslocamentoDonos, mapa->donos,
+                          (size_t)quantidade * sizeof(uint16_t)) &&
+              gravarSecao(arquivo, &posicao, cabecalho.deslocamentoNomes, deslocamentosNomes,
+                          ((size_t)quantidade + 1) * sizeof(uint32_t)) &&
+              gravarSecao(arquivo, &posicao, cabecalho.deslocamentoTextos, NULL, 0);
+
+    // Os nomes saem direto da arena, um após o outro
+    for (int i = 0; sucesso && i < quantidade; i++)
+    {
+        size_t comprimento = mapa->nomes[i].comprimento;
+        sucesso = fwrite(textoNome(mapa->nomes[i]), 1, comprimento, arquivo) == comprimento;
+        posicao += comprimento;
+    }
+
+    sucesso = sucesso &&
+              gravarSecao(arquivo, &posicao, cabecalho.deslocamentoCores, cores, (size_t)quantidadeCores * TAMANHO_COR);
+
+    // Sem fronteiras, a adjacência é uma linha de zeros: todo território tem grau 0
+    // Territórios além dos cobertos pelo grafo (ou todos, sem grafo) ganham grau 0
+    if (fronteiras != NULL)
+    {
+        sucesso = sucesso &&
+                  gravarSecao(arquivo, &posicao, cabecalho.deslocamentoAdjacencia, fronteiras->deslocamentos,
+                              ((size_t)fronteiras->quantidade + 1) * sizeof(uint32_t));
+        fim = fronteiras->entradas;
+        cobertos = fronteiras->quantidade + 1;
+    }
+    else
+    {
+        sucesso = sucesso && gravarSecao(arquivo, &posicao, cabecalho.deslocamentoAdjacencia, NULL, 0);
+    }
+    for (int i = cobertos; sucesso && i <= quantidade; i++)
+    {
+        sucesso = fwrite(&fim, sizeof(fim), 1, arquivo) == 1;
+    }
+    posicao += ((uint64_t)quantidade + 1 - cobertos) * sizeof(uint32_t);
+    sucesso = sucesso && gravarSecao(arquivo, &posicao, cabecalho.deslocamentoVizinhos,
+                                     fronteiras != NULL ? fronteiras->vizinhos : NULL, (size_t)fim * sizeof(uint32_t));
+
+    if (fclose(arquivo) != 0)
+    {
+        sucesso = 0;
+    }
+    return sucesso;
+}
+
+/**
+ * Função para gravar um mapa no formato .wmap
+ */
+int salvarMapaArquivo(const char *caminho, const MapaSoA *mapa, const GrafoFronteiras *fronteiras)
+{
+    uint32_t *deslocamentosNomes;
+    int sucesso = 0;
+
+    if (mapa->quantidade < 0 || (fronteiras != NULL && fronteiras->quantidade > mapa->quantidade))
+    {
+        return 0;
+    }
+
+    deslocamentosNomes = (uint32_t *)malloc(((size_t)mapa->quantidade + 1) * sizeof(uint32_t));
+    if (deslocamentosNomes != NULL)
+    {
+        sucesso = gravarMapaArquivo(caminho, mapa, fronteiras, deslocamentosNomes);
+    }
+
+    free(deslocamentosNomes);
+    return sucesso;
+}
+
+/**
+ * Função auxiliar que confere se uma seção alinhada cabe inteira no arquivo
+ */
+static int secaoValida(const MapaArquivo *mapa, uint64_t deslocamento, uint64_t bytes)
+{
+    return deslocamento % ALINHAMENTO_SECAO_MAPA == 0 && deslocamento <= mapa->tamanho &&
+           bytes <= mapa->tamanho - deslocamento;
+}
+
+/**
+ * Função auxiliar que confere um vetor de deslocamentos: começa em zero,
+ * nunca diminui e termina exatamente no total
+ */
+static int deslocamentosValidos(const uint32_t *deslocamentos, int quantidade, uint64_t total)
+{
+    if (deslocamentos[0] != 0 || deslocamentos[quantidade] != total)
+    {
+        return 0;
+    }
+    for (int i = 0; i < quantidade; i++)
+    {
+        if (deslocamentos[i + 1] < deslocamentos[i])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Função auxiliar que confere o cabeçalho e todas as seções do arquivo mapeado
+ */
+static int validarMapaArquivo(MapaArquivo *mapa)
+{
+    const CabecalhoMapaArquivo *cabecalho = (const CabecalhoMapaArquivo *)mapa->base;
+    const unsigned char *base = (const unsigned char *)mapa->base;
+    uint64_t n;
+
+    if (mapa->tamanho < sizeof(CabecalhoMapaArquivo) ||
+        memcmp(cabecalho->assinatura, MAPA_ARQUIVO_ASSINATURA, 4) != 0 ||
+        cabecalho->versao != MAPA_ARQUIVO_VERSAO || cabecalho->ordemBytes != MAPA_ARQUIVO_ORDEM ||
+        cabecalho->tamanhoArquivo != mapa->tamanho ||
+        cabecalho->quantidadeTerritorios > INT32_MAX - 1 || cabecalho->quantidadeCores > MAX_CORES ||
+        cabecalho->tamanhoTextos > UINT32_MAX || cabecalho->entradasAdjacencia > UINT32_MAX)
+    {
+        return 0;
+    }
+
+    n = cabecalho->quantidadeTerritorios;
+    if (!secaoValida(mapa, cabecalho->deslocamentoTropas, n * sizeof(int32_t)) ||
+        !secaoValida(mapa, cabecalho->deslocamentoDonos, n * sizeof(uint16_t)) ||
+        !secaoValida(mapa, cabecalho->deslocamentoNomes, (n + 1) * sizeof(uint32_t)) ||
+        !secaoValida(mapa, cabecalho->deslocamentoTextos, cabecalho->tamanhoTextos) ||
+        !secaoValida(mapa, cabecalho->deslocamentoCores, (uint64_t)cabecalho->quantidadeCores * TAMANHO_COR) ||
+        !secaoValida(mapa, cabecalho->deslocamentoAdjacencia, (n + 1) * sizeof(uint32_t)) ||
+        !secaoValida(mapa, cabecalho->deslocamentoVizinhos, cabecalho->entradasAdjacencia * sizeof(uint32_t)))
+    {
+        return 0;
+    }
+
+    mapa->cabecalho = cabecalho;
+    mapa->quantidade = (int)n;
+    mapa->tropas = (const int32_t *)(base + cabecalho->deslocamentoTropas);
+    mapa->donos = (const uint16_t *)(base + cabecalho->deslocamentoDonos);
+    mapa->deslocamentosNomes = (const uint32_t *)(base + cabecalho->deslocamentoNomes);
+    mapa->textos = (const char *)(base + cabecalho->deslocamentoTextos);
+
+    // O grafo aponta para o arquivo; o mapeamento é somente leitura, então nada ali é alterado
+    mapa->fronteiras.deslocamentos = (uint32_t *)(uintptr_t)(base + cabecalho->deslocamentoAdjacencia);
+    mapa->fronteiras.vizinhos = (uint32_t *)(uintptr_t)(base + cabecalho->deslocamentoVizinhos);
+    mapa->fronteiras.quantidade = (int)n;
+    mapa->fronteiras.entradas = (uint32_t)cabecalho->entradasAdjacencia;
+
+    if (!deslocamentosValidos(mapa->deslocamentosNomes, mapa->quantidade, cabecalho->tamanhoTextos) ||
+        !deslocamentosValidos(mapa->fronteiras.deslocamentos, mapa->quantidade, cabecalho->entradasAdjacencia))
+    {
+        return 0;
+    }
+    for (uint32_t k = 0; k < mapa->fronteiras.entradas; k++)
+    {
+        if (mapa->fronteiras.vizinhos[k] >= n)
+        {
+            return 0;
+        }
+    }
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        if (mapa->donos[i] >= cabecalho->quantidadeCores)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Função auxiliar que cadastra as cores do arquivo na tabela global
+ * Se algum identificador global diferir do do arquivo, cria a cópia traduzida dos donos
+ */
+static int associarCoresArquivo(MapaArquivo *mapa)
+{
+    const char *tabela = (const char *)mapa->base + mapa->cabecalho->deslocamentoCores;
+    uint16_t traducao[MAX_CORES];
+    int identidade = 1;
+
+    for (uint32_t c = 0; c < mapa->cabecalho->quantidadeCores; c++)
+    {
+        char nome[TAMANHO_COR];
+        int id;
+
+        memcpy(nome, tabela + (size_t)c * TAMANHO_COR, TAMANHO_COR);
+        nome[TAMANHO_COR - 1] = '\0';
+        id = internarCor(nome);
+        if (id < 0)
+        {
+            return 0;
+        }
+        traducao[c] = (uint16_t)id;
+        identidade = identidade && (uint32_t)id == c;
+    }
+
+    if (identidade)
+    {
+        return 1;
+    }
+
+    mapa->donosTraduzidos = (uint16_t *)malloc((size_t)(mapa->quantidade > 0 ? mapa->quantidade : 1) * sizeof(uint16_t));
+    if (mapa->donosTraduzidos == NULL)
+    {
+        return 0;
+    }
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        mapa->donosTraduzidos[i] = traducao[mapa->donos[i]];
+    }
+    return 1;
+}
+
+/**
+ * Função para abrir um arquivo .wmap mapeando-o em memória
+ */
+int abrirMapaArquivo(MapaArquivo *mapa, const char *caminho)
+{
+    struct stat informacoes;
+    int descritor;
+
+    memset(mapa, 0, sizeof(MapaArquivo));
+
+    descritor = open(caminho, O_RDONLY);
+    if (descritor < 0)
+    {
+        return 0;
+    }
+    if (fstat(descritor, &informacoes) != 0 || informacoes.st_size <= 0)
+    {
+        close(descritor);
+        return 0;
+    }
+
+    // Mapeamento compartilhado e somente leitura: as páginas vêm direto do cache de arquivos
+    mapa->tamanho = (size_t)informacoes.st_size;
+    mapa->base = mmap(NULL, mapa->tamanho, PROT_READ, MAP_SHARED, descritor, 0);
+    close(descritor);
+    if (mapa->base == MAP_FAILED)
+    {
+        memset(mapa, 0, sizeof(MapaArquivo));
+        return 0;
+    }
+
+    if (!validarMapaArquivo(mapa) || !associarCoresArquivo(mapa))
+    {
+        fecharMapaArquivo(mapa);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Função para desfazer o mapeamento de um arquivo .wmap
+ */
+void fecharMapaArquivo(MapaArquivo *mapa)
+{
+    if (mapa->base != NULL)
+    {
+        munmap(mapa->base, mapa->tamanho);
+    }
+    free(mapa->donosTraduzidos);
+    memset(mapa, 0, sizeof(MapaArquivo));
+}
+
+/**
+ * Função para obter o identificador global da cor do dono de um território
+ */
+uint16_t donoMapaArquivo(const MapaArquivo *mapa, int indice)
+{
+    return mapa->donosTraduzidos != NULL ? mapa->donosTraduzidos[indice] : mapa->donos[indice];
+}
+
+/**
+ * Função para obter o nome de um território, apontando para dentro do arquivo
+ */
+const char *nomeMapaArquivo(const MapaArquivo *mapa, int indice, uint32_t *comprimento)
+{
+    *comprimento = mapa->deslocamentosNomes[indice + 1] - mapa->deslocamentosNomes[indice];
+    return mapa->textos + mapa->deslocamentosNomes[indice];
+}
+
+/**
+ * Função para copiar todos os territórios do arquivo para um mapa da sessão
+ */
+int copiarMapaArquivo(const MapaArquivo *arquivo, MapaSoA *mapa)
+{
+    const uint16_t *donos = arquivo->donosTraduzidos != NULL ? arquivo->donosTraduzidos : arquivo->donos;
+    size_t quantidade = (size_t)arquivo->quantidade;
+
+    memcpy(mapa->tropas, arquivo->tropas, quantidade * sizeof(int32_t));
+    memcpy(mapa->donos, donos, quantidade * sizeof(uint16_t));
+
+    // Os nomes cabem numa única reserva: textos do arquivo mais um terminador por nome
+    reservarArenaNomes(arenaNomesPadrao(), arquivo->cabecalho->tamanhoTextos + quantidade);
+    for (int i = 0; i < arquivo->quantidade; i++)
+    {
+        uint32_t comprimento;
+        const char *nome = nomeMapaArquivo(arquivo, i, &comprimento);
+
+        if (!guardarNomeArena(arenaNomesPadrao(), nome, comprimento, &mapa->nomes[i]))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,145 @@
+/**
+ * arquivomapa.h - Formato binário .wmap, mapeado em memória e usado sem conversão
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef ARQUIVOMAPA_H
+#define ARQUIVOMAPA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mapa.h"
+#include "fronteiras.h"
+
+/**
+ * Formato do arquivo:
+ *
+ *   CabecalhoMapaArquivo
+ *   tropas:           int32[N]
+ *   donos:            uint16[N] (identificadores na tabela de cores do arquivo)
+ *   deslocamentos dos nomes: uint32[N + 1], posições na tabela de textos
+ *   textos:           bytes dos nomes, sem terminador
+ *   cores:            char[TAMANHO_COR] por cor; a cor i do arquivo é o dono i
+ *   adjacência:       uint32[N + 1] deslocamentos e uint32[entradas] vizinhos (CSR)
+ *
+ * Cada seção começa num múltiplo de ALINHAMENTO_SECAO_MAPA bytes e é localizada
+ * pelo deslocamento gravado no cabeçalho, então o arquivo pode ser mapeado e os
+ * vetores usados no lugar, sem leitura campo a campo. Por isso os inteiros ficam
+ * na ordem de bytes da máquina que gravou o mapa, sem conversão; o cabeçalho
+ * guarda MAPA_ARQUIVO_ORDEM nessa ordem, e uma máquina com a ordem inversa
+ * recusa o arquivo em vez de ler os vetores trocados.
+ */
+#define MAPA_ARQUIVO_ASSINATURA "WMAP"
+#define MAPA_ARQUIVO_VERSAO 2
+#define MAPA_ARQUIVO_ORDEM 0x01020304u
+#define ALINHAMENTO_SECAO_MAPA 64
+
+/**
+ * Cabeçalho do arquivo .wmap (128 bytes)
+ * - secoes: deslocamento de cada seção a partir do início do arquivo
+ * - ordemBytes: MAPA_ARQUIVO_ORDEM, gravado na ordem de bytes nativa
+ */
+typedef struct
+{
+    char assinatura[4];
+    uint32_t versao;
+    uint32_t quantidadeTerritorios;
+    uint32_t quantidadeCores;
+    uint64_t tamanhoArquivo;
+    uint64_t tamanhoTextos;
+    uint64_t entradasAdjacencia;
+    uint64_t deslocamentoTropas;
+    uint64_t deslocamentoDonos;
+    uint64_t deslocamentoNomes;
+    uint64_t deslocamentoTextos;
+    uint64_t deslocamentoCores;
+    uint64_t deslocamentoAdjacencia;
+    uint64_t deslocamentoVizinhos;
+    uint32_t ordemBytes;
+    uint8_t reservado[28];
+} CabecalhoMapaArquivo;
+
+/**
+ * Mapa aberto a partir de um arquivo .wmap
+ * - tropas/donos/deslocamentosNomes/textos: vetores dentro do próprio arquivo mapeado
+ * - fronteiras: grafo cujos vetores também apontam para o arquivo (não usar liberarGrafo)
+ * - donosTraduzidos: cópia dos donos com os identificadores da tabela global de cores,
+ *                    criada só quando eles diferem dos do arquivo (NULL caso contrário)
+ *
+ * O arquivo é mapeado somente para leitura e compartilhado: processos que abrem o
+ * mesmo mapa dividem as mesmas páginas do cache de arquivos.
+ */
+typedef struct
+{
+    void *base;
+    size_t tamanho;
+    const CabecalhoMapaArquivo *cabecalho;
+    int quantidade;
+    const int32_t *tropas;
+    const uint16_t *donos;
+    const uint32_t *deslocamentosNomes;
+    const char *textos;
+    GrafoFronteiras fronteiras;
+    uint16_t *donosTraduzidos;
+} MapaArquivo;
+
+/**
+ * Função para gravar um mapa no formato .wmap
+ * Os vetores de tropas e donos do mapa são gravados como estão, sem cópia
+ * @param caminho Caminho do arquivo
+ * @param mapa Mapa de territórios
+ * @param fronteiras Grafo de fronteiras (NULL grava um mapa sem fronteiras; territórios
+ *                   além dos cobertos pelo grafo ficam sem vizinhos)
+ * @return 1 em caso de sucesso, 0 em caso de erro de escrita ou parâmetros inválidos
+ */
+int salvarMapaArquivo(const char *caminho, const MapaSoA *mapa, const GrafoFronteiras *fronteiras);
+
+/**
+ * Função para abrir um arquivo .wmap mapeando-o em memória
+ *
+ * Confere assinatura, versão, limites de todas as seções e a ordem dos
+ * deslocamentos; nenhum território é copiado. As cores do arquivo são
+ * cadastradas na tabela global.
+ *
+ * @param mapa Ponteiro para a estrutura que receberá o mapa
+ * @param caminho Caminho do arquivo
+ * @return 1 em caso de sucesso, 0 se o arquivo não abrir ou for inválido
+ */
+int abrirMapaArquivo(MapaArquivo *mapa, const char *caminho);
+
+/**
+ * Função para desfazer o mapeamento de um arquivo .wmap
+ * @param mapa Ponteiro para o mapa
+ */
+void fecharMapaArquivo(MapaArquivo *mapa);
+
+/**
+ * Função para obter o identificador global da cor do dono de um território
+ * @param mapa Ponteiro para o mapa
+ * @param indice Índice do território
+ * @return Identificador da cor (ver cores.h)
+ */
+uint16_t donoMapaArquivo(const MapaArquivo *mapa, int indice);
+
+/**
+ * Função para obter o nome de um território, apontando para dentro do arquivo
+ * @param mapa Ponteiro para o mapa
+ * @param indice Índice do território
+ * @param comprimento Ponteiro para receber o comprimento do nome (sem terminador)
+ * @return Início do nome (não terminado em '\0')
+ */
+const char *nomeMapaArquivo(const MapaArquivo *mapa, int indice, uint32_t *comprimento);
+
+/**
+ * Função para copiar todos os territórios do arquivo para um mapa da sessão
+ *
+ * Tropas e donos vão de vetor para vetor com uma cópia de memória cada; só os
+ * nomes são cadastrados um a um na arena padrão de nomes.
+ *
+ * @param arquivo Ponteiro para o mapa aberto
+ * @param mapa Mapa de destino, já com pelo menos a quantidade de territórios do arquivo
+ * @return 1 em caso de sucesso, 0 se faltar memória para os nomes
+ */
+int copiarMapaArquivo(const MapaArquivo *arquivo, MapaSoA *mapa);
+
+#endif /* ARQUIVOMAPA_H */
@@ -0,0 +1,726 @@
+/**
+ * comandos.c - Implementação do modo de comandos em lote
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include "comandos.h"
+#include "territorio.h"
+#include "mapa.h"
+#include "combate.h"
+#include "cores.h"
+#include "nomes.h"
+#include "listagem.h"
+#include "salvamento.h"
+
+// Tamanho da página de list quando só --page é informado
+#define PAGINA_COMANDOS 50
+
+/**
+ * Buffer de resultados (o modo de comandos roda só na thread principal)
+ */
+typedef struct
+{
+    char dados[BUFFER_RESULTADOS];
+    size_t usado;
+    int falhou;
+} SaidaResultados;
+
+static SaidaResultados saida;
+
+/**
+ * Estado de uma execução em andamento
+ */
+typedef struct
+{
+    SessaoComandos *sessao;
+    ResultadoComandos *resultado;
+} ContextoComandos;
+
+/**
+ * Acompanhamentos de uma blitz: cada rodada vai para o diário e para o fluxo de eventos
+ */
+typedef struct
+{
+    AcompanhamentoAtaque registro;
+    AcompanhamentoEventos eventos;
+} AcompanhamentoLote;
+
+static const char *const NOMES_RESULTADO[] = {"atacante", "defensor", "empate"};
+
+/**
+ * Função auxiliar que envia o conteúdo do buffer com write, repetindo em escritas parciais
+ */
+static void descarregarSaida(void)
+{
+    size_t enviado = 0;
+
+    while (enviado < saida.usado && !saida.falhou)
+    {
+        ssize_t escritos = write(STDOUT_FILENO, saida.dados + enviado, saida.usado - enviado);
+
+        if (escritos < 0)
+        {
+            if (errno != EINTR)
+            {
+                saida.falhou = 1;
+            }
+            continue;
+        }
+        enviado += (size_t)escritos;
+    }
+    saida.usado = 0;
+}
+
+/**
+ * Função auxiliar que acrescenta bytes ao buffer, descarregando-o quando enche
+ */
+static void acrescentarBytes(const char *texto, size_t comprimento)
+{
+    while (comprimento > 0)
+    {
+        size_t livre = BUFFER_RESULTADOS - saida.usado;
+        size_t parte = comprimento < livre ? comprimento : livre;
+
+        memcpy(saida.dados + saida.usado, texto, parte);
+        saida.usado += parte;
+        texto += parte;
+        comprimento -= parte;
+        if (saida.usado == BUFFER_RESULTADOS)
+        {
+            descarregarSaida();
+        }
+    }
+}
+
+/**
+ * Função auxiliar que acrescenta um texto terminado em '\0'
+ */
+static void acrescentarTexto(const char *texto)
+{
+    acrescentarBytes(texto, strlen(texto));
+}
+
+/**
+ * Função auxiliar que acrescenta um espaço e um inteiro em decimal
+ */
+static void acrescentarInteiro(long long valor)
+{
+    char digitos[24];
+    int posicao = (int)sizeof(digitos);
+    unsigned long long absoluto = valor < 0 ? 0ULL - (unsigned long long)valor : (unsigned long long)valor;
+
+    do
+    {
+        digitos[--posicao] = (char)('0' + absoluto % 10);
+        absoluto /= 10;
+    } while (absoluto > 0);
+    if (valor < 0)
+    {
+        digitos[--posicao] = '-';
+    }
+    digitos[--posicao] = ' ';
+
+    acrescentarBytes(digitos + posicao, sizeof(digitos) - (size_t)posicao);
+}
+
+/**
+ * Função auxiliar que separa uma linha em argumentos, no lugar, terminando cada um com '\0'
+ * @param fim Posição logo após o último caractere da linha; precisa poder receber o '\0'
+ * @return Quantidade de argumentos, ou -1 se houver aspas sem fechamento ou argumentos demais
+ */
+static int separarArgumentos(char *inicio, char *fim, char **argumentos)
+{
+    int quantidade = 0;
+
+    *fim = '\0';
+    while (inicio < fim)
+    {
+        if (*inicio == ' ' || *inicio == '\t')
+        {
+            inicio++;
+            continue;
+        }
+
+        if (quantidade == MAXIMO_ARGUMENTOS)
+        {
+            return -1;
+        }
+
+        if (*inicio == '"')
+        {
+            char *aspas = (char *)memchr(inicio + 1, '"', (size_t)(fim - inicio - 1));
+
+            if (aspas == NULL)
+            {
+                return -1;
+            }
+            argumentos[quantidade++] = inicio + 1;
+            *aspas = '\0';
+            inicio = aspas + 1;
+        }
+        else
+        {
+            argumentos[quantidade++] = inicio;
+            while (inicio < fim && *inicio != ' ' && *inicio != '\t')
+            {
+                inicio++;
+            }
+            *inicio++ = '\0';
+        }
+    }
+
+    return quantidade;
+}
+
+/**
+ * Função auxiliar que converte um argumento inteiro, exigindo o texto inteiro numérico
+ * @return 1 se o argumento é um inteiro válido, 0 caso contrário
+ */
+static int converterInteiro(const char *texto, int *valor)
+{
+    char *fim;
+    long convertido;
+
+    errno = 0;
+    convertido = strtol(texto, &fim, 10);
+    if (fim == texto || *fim != '\0' || errno == ERANGE || convertido < INT_MIN || convertido > INT_MAX)
+    {
+        return 0;
+    }
+
+    *valor = (int)convertido;
+    return 1;
+}
+
+/**
+ * Função auxiliar que conta um comando rejeitado e escreve "erro linha: motivo"
+ * @param detalhe Texto acrescentado ao motivo (pode ser NULL)
+ */
+static void rejeitarComando(ContextoComandos *contexto, const char *motivo, const char *detalhe)
+{
+    ResultadoComandos *resultado = contexto->resultado;
+
+    resultado->erros++;
+    if (resultado->primeiroErro == 0)
+    {
+        resultado->primeiroErro = resultado->linhas;
+    }
+
+    acrescentarTexto("erro");
+    acrescentarInteiro(resultado->linhas);
+    acrescentarTexto(": ");
+    acrescentarTexto(motivo);
+    if (detalhe != NULL)
+    {
+        acrescentarTexto(detalhe);
+    }
+    acrescentarTexto("\n");
+}
+
+/**
+ * Função auxiliar que valida o par atacante/defensor, com as mesmas regras do menu
+ * @param idAtacante Recebe o índice (0 a N-1) do atacante
+ * @param idDefensor Recebe o índice (0 a N-1) do defensor
+ * @return 1 se o ataque é permitido, 0 caso contrário (o erro já foi escrito)
+ */
+static int validarAlvos(ContextoComandos *contexto, const char *textoAtacante, const char *textoDefensor,
+                        int *idAtacante, int *idDefensor)
+{
+    const MapaSoA *territorios = contexto->sessao->territorios;
+    const GrafoFronteiras *fronteiras = contexto->sessao->fronteiras;
+
+    if (!converterInteiro(textoAtacante, idAtacante) || !converterInteiro(textoDefensor, idDefensor) ||
+        *idAtacante < 1 || *idAtacante > territorios->quantidade ||
+        *idDefensor < 1 || *idDefensor > territorios->quantidade)
+    {
+        rejeitarComando(contexto, "territorio inexistente", NULL);
+        return 0;
+    }
+    if (*idAtacante == *idDefensor)
+    {
+        rejeitarComando(contexto, "atacante e defensor sao o mesmo territorio", NULL);
+        return 0;
+    }
+
+    // Ajusta os índices (interface usa 1-N, array usa 0-(N-1))
+    (*idAtacante)--;
+    (*idDefensor)--;
+
+    if (territorios->donos[*idAtacante] == territorios->donos[*idDefensor])
+    {
+        rejeitarComando(contexto, "territorios da mesma cor", NULL);
+        return 0;
+    }
+    if (fronteiras != NULL && !saoVizinhos(fronteiras, *idAtacante, *idDefensor))
+    {
+        rejeitarComando(contexto, "territorios sem fronteira", NULL);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Função auxiliar que escreve as tropas finais e a conquista, comuns a attack e blitz
+ */
+static void acrescentarDesfecho(const Territorio *atacante, const Territorio *defensor, int conquistado)
+{
+    acrescentarInteiro(atacante->tropas);
+    acrescentarInteiro(defensor->tropas);
+    acrescentarInteiro(conquistado);
+    acrescentarTexto("\n");
+}
+
+/**
+ * Comando add nome cor tropas
+ * @return 0 se faltou memória, 1 caso contrário
+ */
+static int comandoAdd(ContextoComandos *contexto, char **argumentos, int quantidade)
+{
+    MapaSoA *territorios = contexto->sessao->territorios;
+    Territorio territorio;
+    RefNome nome;
+    int idCor, tropas;
+
+    if (quantidade != 4 || argumentos[1][0] == '\0' || argumentos[2][0] == '\0')
+    {
+        rejeitarComando(contexto, "uso: add nome cor tropas", NULL);
+        return 1;
+    }
+    if (!converterInteiro(argumentos[3], &tropas) || tropas < 0)
+    {
+        rejeitarComando(contexto, "tropas invalidas: ", argumentos[3]);
+        return 1;
+    }
+    idCor = internarCor(argumentos[2]);
+    if (idCor < 0)
+    {
+        rejeitarComando(contexto, "limite de cores atingido: ", argumentos[2]);
+        return 1;
+    }
+
+    if (!guardarNomeArena(arenaNomesPadrao(), argumentos[1], strlen(argumentos[1]), &nome) ||
+        !crescerMapa(territorios, 1))
+    {
+        return 0;
+    }
+
+    territorio.nome = nome;
+    territorio.idCor = (uint16_t)idCor;
+    territorio.tropas = tropas;
+    guardarTerritorioMapa(territorios, territorios->quantidade - 1, &territorio);
+    registrarTerritorio(contexto->sessao->registro, &territorio);
+
+    acrescentarTexto("add");
+    acrescentarInteiro(territorios->quantidade);
+    acrescentarTexto("\n");
+    contexto->resultado->comandos++;
+    return 1;
+}
+
+/**
+ * Comando attack A B: uma rodada, como a opção 2 do menu
+ */
+static void comandoAttack(ContextoComandos *contexto, char **argumentos, int quantidade)
+{
+    SessaoComandos *sessao = contexto->sessao;
+    AcompanhamentoLote acompanhamento;
+    ResultadoCombate combate;
+    Territorio atacante, defensor;
+    int idAtacante, idDefensor;
+
+    if (quantidade != 3)
+    {
+        rejeitarComando(contexto, "uso: attack A B", NULL);
+        return;
+    }
+    if (!validarAlvos(contexto, argumentos[1], argumentos[2], &idAtacante, &idDefensor))
+    {
+        return;
+    }
+
+    // O combate trabalha numa cópia do par, devolvida ao mapa no fim
+    obterTerritorioMapa(sessao->territorios, idAtacante, &atacante);
+    obterTerritorioMapa(sessao->territorios, idDefensor, &defensor);
+    iniciarAcompanhamento(&acompanhamento.registro, sessao->registro, sessao->gerador, &atacante, &defensor,
+                          idAtacante, idDefensor);
+    iniciarAcompanhamentoEventos(&acompanhamento.eventos, sessao->eventos, &atacante, &defensor, idAtacante, idDefensor);
+    resolverAtaque(&atacante, &defensor, sessao->gerador, &combate);
+    registrarAtaqueObservado(&combate, &acompanhamento.registro);
+    emitirEventoObservado(&combate, &acompanhamento.eventos);
+    guardarTerritorioMapa(sessao->territorios, idAtacante, &atacante);
+    guardarTerritorioMapa(sessao->territorios, idDefensor, &defensor);
+
+    acrescentarTexto("attack");
+    acrescentarInteiro(idAtacante + 1);
+    acrescentarInteiro(idDefensor + 1);
+    acrescentarTexto(" ");
+    acrescentarTexto(NOMES_RESULTADO[combate.resultado]);
+    acrescentarInteiro(combate.dadosAtacante.dado1);
+    acrescentarInteiro(combate.dadosAtacante.dado2);
+    acrescentarInteiro(combate.dadosDefensor.dado1);
+    acrescentarInteiro(combate.dadosDefensor.dado2);
+    acrescentarInteiro(combate.tropasPerdidasAtacante);
+    acrescentarInteiro(combate.tropasPerdidasDefensor);
+    acrescentarDesfecho(&atacante, &defensor, combate.conquistado);
+    contexto->resultado->comandos++;
+}
+
+/**
+ * Observador das rodadas de uma blitz: grava no diário e emite o evento
+ */
+static void observarRodadaLote(const ResultadoCombate *combate, void *contexto)
+{
+    AcompanhamentoLote *acompanhamento = (AcompanhamentoLote *)contexto;
+
+    registrarAtaqueObservado(combate, &acompanhamento->registro);
+    emitirEventoObservado(combate, &acompanhamento->eventos);
+}
+
+/**
+ * Comando blitz A B [piso]: rodadas até a conquista ou até o piso, como a opção 4 do menu
+ */
+static void comandoBlitz(ContextoComandos *contexto, char **argumentos, int quantidade)
+{
+    SessaoComandos *sessao = contexto->sessao;
+    AcompanhamentoLote acompanhamento;
+    ResultadoBatalha batalha;
+    Territorio atacante, defensor;
+    int idAtacante, idDefensor;
+    int piso = 1;
+
+    if (quantidade != 3 && quantidade != 4)
+    {
+        rejeitarComando(contexto, "uso: blitz A B [piso]", NULL);
+        return;
+    }
+    if (quantidade == 4 && !converterInteiro(argumentos[3], &piso))
+    {
+        rejeitarComando(contexto, "piso invalido: ", argumentos[3]);
+        return;
+    }
+    if (!validarAlvos(contexto, argumentos[1], argumentos[2], &idAtacante, &idDefensor))
+    {
+        return;
+    }
+    if (piso < 1)
+    {
+        piso = 1;
+    }
+
+    obterTerritorioMapa(sessao->territorios, idAtacante, &atacante);
+    obterTerritorioMapa(sessao->territorios, idDefensor, &defensor);
+    iniciarAcompanhamento(&acompanhamento.registro, sessao->registro, sessao->gerador, &atacante, &defensor,
+                          idAtacante, idDefensor);
+    iniciarAcompanhamentoEventos(&acompanhamento.eventos, sessao->eventos, &atacante, &defensor, idAtacante, idDefensor);
+
+    // Sem diário nem eventos, a batalha roda sem observador
+    simularBatalhaObservada(&atacante, &defensor, piso, sessao->gerador,
+                            sessao->registro != NULL || sessao->eventos != NULL ? observarRodadaLote : NULL,
+                            &acompanhamento, &batalha);
+    guardarTerritorioMapa(sessao->territorios, idAtacante, &atacante);
+    guardarTerritorioMapa(sessao->territorios, idDefensor, &defensor);
+
+    acrescentarTexto("blitz");
+    acrescentarInteiro(idAtacante + 1);
+    acrescentarInteiro(idDefensor + 1);
+    acrescentarInteiro(batalha.rodadas);
+    acrescentarInteiro(batalha.vitoriasAtacante);
+    acrescentarInteiro(batalha.vitoriasDefensor);
+    acrescentarInteiro(batalha.empates);
+    acrescentarInteiro(batalha.tropasPerdidasAtacante);
+    acrescentarInteiro(batalha.tropasPerdidasDefensor);
+    acrescentarDesfecho(&atacante, &defensor, batalha.conquistado);
+    contexto->resultado->comandos++;
+}
+
+/**
+ * Comando list [--color cor] [--min N] [--max N] [--page P] [--size N] [--full]
+ */
+static void comandoList(ContextoComandos *contexto, char **argumentos, int quantidade)
+{
+    const MapaSoA *territorios = contexto->sessao->territorios;
+    FiltroListagem filtro;
+    int tamanhoPagina = 0, pagina = 1;
+    int valido = 1;
+
+    iniciarFiltroListagem(&filtro);
+    filtro.compacto = 1;
+
+    for (int i = 1; i < quantidade && valido; i++)
+    {
+        if (strcmp(argumentos[i], "--full") == 0)
+        {
+            filtro.compacto = 0;
+        }
+        else if (strcmp(argumentos[i], "--color") == 0 && i + 1 < quantidade)
+        {
+            filtro.idCor = procurarCor(argumentos[++i]);
+            if (filtro.idCor < 0)
+            {
+                rejeitarComando(contexto, "nenhum territorio tem a cor ", argumentos[i]);
+                return;
+            }
+        }
+        else if (strcmp(argumentos[i], "--min") == 0 && i + 1 < quantidade)
+        {
+            valido = converterInteiro(argumentos[++i], &filtro.tropasMinimas);
+        }
+        else if (strcmp(argumentos[i], "--max") == 0 && i + 1 < quantidade)
+        {
+            valido = converterInteiro(argumentos[++i], &filtro.tropasMaximas);
+        }
+        else if (strcmp(argumentos[i], "--page") == 0 && i + 1 < quantidade)
+        {
+            valido = converterInteiro(argumentos[++i], &pagina);
+            if (tamanhoPagina == 0)
+            {
+                tamanhoPagina = PAGINA_COMANDOS;
+            }
+        }
+        else if (strcmp(argumentos[i], "--size") == 0 && i + 1 < quantidade)
+        {
+            valido = converterInteiro(argumentos[++i], &tamanhoPagina);
+        }
+        else
+        {
+            valido = 0;
+        }
+    }
+
+    if (!valido || tamanhoPagina < 0 || pagina < 1 || (long long)(pagina - 1) * tamanhoPagina > INT_MAX)
+    {
+        rejeitarComando(contexto, "uso: list [--color cor] [--min N] [--max N] [--page P] [--size N] [--full]", NULL);
+        return;
+    }
+    filtro.limite = tamanhoPagina;
+    filtro.pular = tamanhoPagina > 0 ? (pagina - 1) * tamanhoPagina : 0;
+
+    // A listagem escreve direto no descritor: os resultados anteriores precisam sair antes
+    descarregarSaida();
+    if (!renderizarTerritorios(territorios, &filtro, NULL))
+    {
+        saida.falhou = 1;
+    }
+    contexto->resultado->comandos++;
+}
+
+/**
+ * Comando save caminho: grava a partida no formato de --carregar
+ */
+static void comandoSave(ContextoComandos *contexto, char **argumentos, int quantidade)
+{
+    SessaoComandos *sessao = contexto->sessao;
+
+    if (quantidade != 2 || argumentos[1][0] == '\0')
+    {
+        rejeitarComando(contexto, "uso: save caminho", NULL);
+        return;
+    }
+    if (!salvarJogo(argumentos[1], sessao->territorios, sessao->fronteiras, sessao->gerador, sessao->semente))
+    {
+        rejeitarComando(contexto, "nao foi possivel salvar em ", argumentos[1]);
+        return;
+    }
+
+    acrescentarTexto("save ");
+    acrescentarTexto(argumentos[1]);
+    acrescentarInteiro(sessao->territorios->quantidade);
+    acrescentarTexto("\n");
+    contexto->resultado->comandos++;
+}
+
+/**
+ * Comando hash: assinatura do mapa, a mesma gravada no fim do diário
+ */
+static void comandoHash(ContextoComandos *contexto, int quantidade)
+{
+    static const char HEXA[] = "0123456789abcdef";
+    const MapaSoA *territorios = contexto->sessao->territorios;
+    char texto[] = "hash 0000000000000000\n";
+    uint64_t assinatura;
+
+    if (quantidade != 1)
+    {
+        rejeitarComando(contexto, "uso: hash", NULL);
+        return;
+    }
+
+    assinatura = calcularHashMapa(territorios);
+    for (int i = 20; i >= 5; i--)
+    {
+        texto[i] = HEXA[assinatura & 0xF];
+        assinatura >>= 4;
+    }
+    acrescentarBytes(texto, sizeof(texto) - 1);
+    contexto->resultado->comandos++;
+}
+
+/**
+ * Função auxiliar que interpreta e executa uma linha [inicio, fim), sem o '\n'
+ * @param fim Precisa poder receber o '\0' que termina o último argumento
+ * @return 1 se a linha foi tratada (executada, ignorada ou rejeitada), 0 se faltou memória
+ */
+static int processarLinha(ContextoComandos *contexto, char *inicio, char *fim)
+{
+    char *argumentos[MAXIMO_ARGUMENTOS];
+    int quantidade;
+
+    contexto->resultado->linhas++;
+    if (fim > inicio && fim[-1] == '\r')
+    {
+        fim--;
+    }
+
+    while (inicio < fim && (*inicio == ' ' || *inicio == '\t'))
+    {
+        inicio++;
+    }
+    if (inicio == fim || *inicio == '#')
+    {
+        return 1;
+    }
+
+    quantidade = separarArgumentos(inicio, fim, argumentos);
+    if (quantidade <= 0)
+    {
+        rejeitarComando(contexto, "aspas sem fechamento ou argumentos demais", NULL);
+        return 1;
+    }
+
+    if (strcmp(argumentos[0], "attack") == 0)
+    {
+        comandoAttack(contexto, argumentos, quantidade);
+    }
+    else if (strcmp(argumentos[0], "blitz") == 0)
+    {
+        comandoBlitz(contexto, argumentos, quantidade);
+    }
+    else if (strcmp(argumentos[0], "add") == 0)
+    {
+        return comandoAdd(contexto, argumentos, quantidade);
+    }
+    else if (strcmp(argumentos[0], "list") == 0)
+    {
+        comandoList(contexto, argumentos, quantidade);
+    }
+    else if (strcmp(argumentos[0], "save") == 0)
+    {
+        comandoSave(contexto, argumentos, quantidade);
+    }
+    else if (strcmp(argumentos[0], "hash") == 0)
+    {
+        comandoHash(contexto, quantidade);
+    }
+    else
+    {
+        rejeitarComando(contexto, "comando desconhecido: ", argumentos[0]);
+    }
+
+    return 1;
+}
+
+/**
+ * Função para executar os comandos lidos de um descritor até o fim da entrada
+ * Uma linha maior que o buffer é rejeitada e descartada até o próximo '\n'
+ */
+int executarComandos(int descritor, SessaoComandos *sessao, ResultadoComandos *resultado)
+{
+    ContextoComandos contexto;
+    char *buffer;
+    size_t usado = 0;
+    int descartando = 0, sucesso = 1;
+
+    memset(resultado, 0, sizeof(ResultadoComandos));
+    saida.usado = 0;
+    saida.falhou = 0;
+
+    // Um byte a mais para o '\0' da última linha, quando a entrada não termina em '\n'
+    buffer = (char *)malloc(BUFFER_COMANDOS + 1);
+    if (buffer == NULL)
+    {
+        return 0;
+    }
+
+    contexto.sessao = sessao;
+    contexto.resultado = resultado;
+
+    while (sucesso && !saida.falhou)
+    {
+        ssize_t lidos;
+        char *inicio = buffer, *limite, *fimLinha;
+
+        // A leitura pode bloquear num terminal ou pipe: os eventos depois dela relêem o relógio
+        if (sessao->eventos != NULL)
+        {
+            renovarInstanteEventos(sessao->eventos);
+        }
+        lidos = read(descritor, buffer + usado, BUFFER_COMANDOS - usado);
+
+        if (lidos < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            sucesso = 0;
+            break;
+        }
+
+        resultado->bytes += (size_t)lidos;
+        usado += (size_t)lidos;
+        limite = buffer + usado;
+
+        while (sucesso && (fimLinha = (char *)memchr(inicio, '\n', (size_t)(limite - inicio))) != NULL)
+        {
+            // Restante de uma linha longa demais, já contada como erro
+            if (descartando)
+            {
+                descartando = 0;
+            }
+            else
+            {
+                sucesso = processarLinha(&contexto, inicio, fimLinha);
+            }
+            inicio = fimLinha + 1;
+        }
+
+        if (lidos == 0)
+        {
+            // Última linha sem '\n'
+            if (sucesso && !descartando && inicio < limite)
+            {
+                sucesso = processarLinha(&contexto, inicio, limite);
+            }
+            break;
+        }
+
+        usado = (size_t)(limite - inicio);
+        if (usado == BUFFER_COMANDOS)
+        {
+            if (!descartando)
+            {
+                resultado->linhas++;
+                rejeitarComando(&contexto, "linha longa demais", NULL);
+                descartando = 1;
+            }
+            usado = 0;
+        }
+        else
+        {
+            memmove(buffer, inicio, usado);
+        }
+    }
+
+    descarregarSaida();
+    free(buffer);
+    return sucesso && !saida.falhou;
+}
@@ -0,0 +1,96 @@
+/**
+ * comandos.h - Modo de comandos em lote, sem menus nem perguntas
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef COMANDOS_H
+#define COMANDOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mapa.h"
+#include "aleatorio.h"
+#include "fronteiras.h"
+#include "registro.h"
+#include "eventos.h"
+
+/**
+ * Formato: um comando por linha, com os argumentos separados por espaços ou
+ * tabulações. Aspas duplas agrupam um argumento com espaços ("Nova Iorque").
+ * Linhas vazias ou iniciadas por '#' são ignoradas, e o '\r' de arquivos do
+ * Windows é descartado. Os territórios são numerados de 1 a N, como no menu.
+ * Cada comando escreve só o seu resultado, numa linha que começa pelo próprio nome:
+ *
+ *   add nome cor tropas     -> add N
+ *   attack A B              -> attack A B resultado dA1 dA2 dD1 dD2 perdaA perdaD tropasA tropasD conquista
+ *   blitz A B [piso]        -> blitz A B rodadas vitorias defesas empates perdaA perdaD tropasA tropasD conquista
+ *   list [opções]           -> listagem compacta (ou completa) com o rodapé da listagem
+ *   save caminho            -> save caminho territorios
+ *   hash                    -> hash assinatura (16 dígitos hexadecimais)
+ *
+ * "resultado" é atacante, defensor ou empate; "conquista" é 1 se o defensor
+ * mudou de cor. As opções de list são --color cor, --min tropas, --max tropas,
+ * --page página, --size territórios por página (0 para todos) e --full. Um
+ * comando inválido escreve "erro linha: motivo" e a execução continua.
+ */
+
+// Tamanho do bloco lido da entrada a cada chamada de read (limite de uma linha)
+#define BUFFER_COMANDOS (1 << 20)
+
+// Tamanho do buffer de resultados, enviado com write quando enche
+#define BUFFER_RESULTADOS (64 * 1024)
+
+// Máximo de argumentos de um comando, incluindo o nome
+#define MAXIMO_ARGUMENTOS 16
+
+/**
+ * Estado compartilhado com a sessão que executa os comandos
+ * - territorios/gerador/semente: mapa, gerador dos dados e semente usada em save
+ * - fronteiras: grafo de fronteiras (NULL permite atacar qualquer território)
+ * - registro/eventos: diário e fluxo de eventos (NULL desativa cada um)
+ */
+typedef struct
+{
+    MapaSoA *territorios;
+    GeradorAleatorio *gerador;
+    uint64_t semente;
+    const GrafoFronteiras *fronteiras;
+    RegistroPartida *registro;
+    SaidaEventos *eventos;
+} SessaoComandos;
+
+/**
+ * Resultado de uma execução em lote
+ * - linhas: linhas lidas, incluindo vazias e comentários
+ * - comandos: comandos executados com sucesso
+ * - erros: comandos rejeitados (desconhecidos, com argumentos inválidos ou ataques proibidos)
+ * - primeiroErro: número (a partir de 1) da linha do primeiro erro, ou 0
+ * - bytes: tamanho lido da entrada
+ */
+typedef struct
+{
+    long long linhas;
+    long long comandos;
+    long long erros;
+    long long primeiroErro;
+    size_t bytes;
+} ResultadoComandos;
+
+/**
+ * Função para executar os comandos lidos de um descritor até o fim da entrada
+ *
+ * A entrada é lida em blocos de BUFFER_COMANDOS bytes e cada linha é separada
+ * em argumentos direto no buffer. Os resultados são formatados sem printf num
+ * buffer de BUFFER_RESULTADOS bytes e enviados à saída padrão com write, então
+ * milhões de comandos custam poucas chamadas ao sistema. Ataques passam pelo
+ * diário e pelo fluxo de eventos da sessão, quando ativos.
+ *
+ * @param descritor Descritor de leitura (arquivo ou STDIN_FILENO)
+ * @param sessao Estado da sessão
+ * @param resultado Ponteiro para receber as contagens
+ * @return 1 se a entrada foi lida até o fim, 0 se a leitura ou a escrita falhou
+ *         ou faltou memória
+ */
+int executarComandos(int descritor, SessaoComandos *sessao, ResultadoComandos *resultado);
+
+#endif /* COMANDOS_H */
@@ -6,116 +6,317 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 #include "combate.h"
 #include "territorio.h"
+#include "cores.h"
+#include "nomes.h"
+#include "aleatorio.h"
 
 /**
  * Função para lançar dois dados e retornar o resultado
  * Implementa passagem por referência usando ponteiro
  */
-void lancarDados(ResultadoDados *resultado)
+void lancarDados(ResultadoDados *resultado, GeradorAleatorio *gerador)
 {
-    resultado->dado1 = rand() % 6 + 1;
-    resultado->dado2 = rand() % 6 + 1;
+    int faces[2];
+
+    lancarFaces(gerador, faces, 2);
+    resultado->dado1 = faces[0];
+    resultado->dado2 = faces[1];
     resultado->soma = resultado->dado1 + resultado->dado2;
 }
 
 /**
- * Função para simular um ataque entre territórios
- * Implementa passagem por referência usando ponteiros
+ * Função para lançar os dois dados de muitas jogadas de uma só vez
+ * A soma é um laço simples sobre bytes, que o compilador vetoriza
  */
-ResultadoAtaque atacar(Territorio *atacante, Territorio *defensor)
+void lancarDadosLote(GeradorLote *gerador, uint8_t *dado1, uint8_t *dado2, uint8_t *soma, size_t quantidade)
 {
-    ResultadoDados dadosAtacante, dadosDefensor;
-    ResultadoAtaque resultado;
+    lancarFacesLote(gerador, dado1, quantidade);
+    lancarFacesLote(gerador, dado2, quantidade);
 
-    // Simula a rolagem de dois dados de 1 a 6 para cada lado
-    lancarDados(&dadosAtacante);
-    lancarDados(&dadosDefensor);
+    for (size_t i = 0; i < quantidade; i++)
+    {
+        soma[i] = (uint8_t)(dado1[i] + dado2[i]);
+    }
+}
 
-    printf("\n===================================\n");
-    printf("        SIMULACAO DE ATAQUE       \n");
-    printf("===================================\n");
-    printf("Atacante: %s (%s)\n", atacante->nome, atacante->cor);
-    printf("  Dados: %d e %d (Total: %d)\n", dadosAtacante.dado1, dadosAtacante.dado2, dadosAtacante.soma);
-    printf("Defensor: %s (%s)\n", defensor->nome, defensor->cor);
-    printf("  Dados: %d e %d (Total: %d)\n", dadosDefensor.dado1, dadosDefensor.dado2, dadosDefensor.soma);
+/**
+ * Função para preparar uma fonte de dados em lote
+ * A posição no fim força o sorteio do primeiro lote no primeiro ataque
+ */
+void iniciarFonteDadosLote(FonteDadosLote *fonte, uint64_t semente)
+{
+    inicializarGeradorLote(&fonte->gerador, semente, 0);
+    fonte->posicao = JOGADAS_FONTE_LOTE;
+}
 
-    // Determina o resultado do ataque
-    if (dadosAtacante.soma > dadosDefensor.soma)
+/**
+ * Função para aplicar as perdas de um ataque cujo resultado já é conhecido
+ * Não escreve nada no console
+ */
+void aplicarResultadoAtaque(Territorio *atacante, Territorio *defensor, ResultadoCombate *combate)
+{
+    int tropasAntes;
+
+    combate->tropasPerdidasAtacante = 0;
+    combate->tropasPerdidasDefensor = 0;
+    combate->conquistado = 0;
+
+    switch (combate->resultado)
     {
-        resultado = VITORIA_ATACANTE;
+    case VITORIA_ATACANTE:
+        // Defensor perde 15% das tropas e possivelmente muda de cor
+        tropasAntes = defensor->tropas;
+        combate->tropasPerdidasDefensor = conquistarTerritorioPB(defensor, atacante->idCor, PERDA_VITORIA_PB);
+
+        // A cor só muda quando as tropas do defensor chegam a zero
+        combate->conquistado = (tropasAntes - combate->tropasPerdidasDefensor <= 0);
+        break;
+
+    case VITORIA_DEFENSOR:
+        // Atacante perde 15% das tropas
+        combate->tropasPerdidasAtacante = reduzirTropasPB(atacante, PERDA_VITORIA_PB);
+        break;
+
+    case EMPATE:
+        // Em caso de empate, ambos perdem 5% das tropas
+        combate->tropasPerdidasAtacante = reduzirTropasPB(atacante, PERDA_EMPATE_PB);
+        combate->tropasPerdidasDefensor = reduzirTropasPB(defensor, PERDA_EMPATE_PB);
+        break;
     }
-    else if (dadosAtacante.soma < dadosDefensor.soma)
+}
+
+/**
+ * Função auxiliar que compara as somas já lançadas e aplica as perdas
+ */
+static void decidirAtaque(Territorio *atacante, Territorio *defensor, ResultadoCombate *saida)
+{
+    if (saida->dadosAtacante.soma > saida->dadosDefensor.soma)
     {
-        resultado = VITORIA_DEFENSOR;
+        saida->resultado = VITORIA_ATACANTE;
+    }
+    else if (saida->dadosAtacante.soma < saida->dadosDefensor.soma)
+    {
+        saida->resultado = VITORIA_DEFENSOR;
     }
     else
     {
-        resultado = EMPATE;
+        saida->resultado = EMPATE;
     }
 
-    // Processa o resultado do ataque
-    processarResultadoAtaque(atacante, defensor, resultado, &dadosAtacante, &dadosDefensor);
-
-    return resultado;
+    aplicarResultadoAtaque(atacante, defensor, saida);
 }
 
 /**
- * Função para processar o resultado de um ataque
+ * Função para resolver um ataque entre territórios sem nenhuma saída no console
  * Implementa passagem por referência usando ponteiros
  */
-void processarResultadoAtaque(
+void resolverAtaque(Territorio *atacante, Territorio *defensor, GeradorAleatorio *gerador, ResultadoCombate *saida)
+{
+    int faces[4];
+
+    // Simula a rolagem de dois dados de 1 a 6 para cada lado (uma única saída do gerador)
+    lancarFaces(gerador, faces, 4);
+    saida->dadosAtacante.dado1 = faces[0];
+    saida->dadosAtacante.dado2 = faces[1];
+    saida->dadosAtacante.soma = faces[0] + faces[1];
+    saida->dadosDefensor.dado1 = faces[2];
+    saida->dadosDefensor.dado2 = faces[3];
+    saida->dadosDefensor.soma = faces[2] + faces[3];
+
+    decidirAtaque(atacante, defensor, saida);
+}
+
+/**
+ * Função auxiliar que resolve um ataque com duas jogadas da fonte em lote
+ */
+static void resolverAtaqueLote(Territorio *atacante, Territorio *defensor, FonteDadosLote *fonte, ResultadoCombate *saida)
+{
+    int i;
+
+    if (fonte->posicao + 2 > JOGADAS_FONTE_LOTE)
+    {
+        lancarDadosLote(&fonte->gerador, fonte->dado1, fonte->dado2, fonte->soma, JOGADAS_FONTE_LOTE);
+        fonte->posicao = 0;
+    }
+
+    i = fonte->posicao;
+    fonte->posicao += 2;
+    saida->dadosAtacante.dado1 = fonte->dado1[i];
+    saida->dadosAtacante.dado2 = fonte->dado2[i];
+    saida->dadosAtacante.soma = fonte->soma[i];
+    saida->dadosDefensor.dado1 = fonte->dado1[i + 1];
+    saida->dadosDefensor.dado2 = fonte->dado2[i + 1];
+    saida->dadosDefensor.soma = fonte->soma[i + 1];
+
+    decidirAtaque(atacante, defensor, saida);
+}
+
+/**
+ * Função auxiliar que soma uma rodada ao resumo da batalha
+ */
+static void acumularRodada(ResultadoBatalha *saida, const ResultadoCombate *combate)
+{
+    saida->rodadas++;
+    saida->tropasPerdidasAtacante += combate->tropasPerdidasAtacante;
+    saida->tropasPerdidasDefensor += combate->tropasPerdidasDefensor;
+    saida->conquistado = combate->conquistado;
+
+    switch (combate->resultado)
+    {
+    case VITORIA_ATACANTE:
+        saida->vitoriasAtacante++;
+        break;
+    case VITORIA_DEFENSOR:
+        saida->vitoriasDefensor++;
+        break;
+    case EMPATE:
+        saida->empates++;
+        break;
+    }
+}
+
+/**
+ * Função para repetir ataques até a conquista ou até o atacante chegar ao piso de tropas
+ */
+void simularBatalha(Territorio *atacante, Territorio *defensor, int tropasMinimas, GeradorAleatorio *gerador, ResultadoBatalha *saida)
+{
+    simularBatalhaObservada(atacante, defensor, tropasMinimas, gerador, NULL, NULL, saida);
+}
+
+/**
+ * Função para simular uma batalha avisando um observador a cada rodada
+ * Cada rodada reduz as tropas de pelo menos um dos lados, então a batalha sempre termina
+ */
+void simularBatalhaObservada(
     Territorio *atacante,
     Territorio *defensor,
-    ResultadoAtaque resultadoAtaque,
-    const ResultadoDados *dadosAtacante,
-    const ResultadoDados *dadosDefensor)
+    int tropasMinimas,
+    GeradorAleatorio *gerador,
+    ObservadorCombate observador,
+    void *contexto,
+    ResultadoBatalha *saida)
 {
-    int tropasPerdidas;
+    ResultadoCombate combate;
 
-    switch (resultadoAtaque)
+    memset(saida, 0, sizeof(ResultadoBatalha));
+
+    if (tropasMinimas < 1)
     {
-    case VITORIA_ATACANTE:
-        printf("\nResultado: %s venceu o ataque!\n", atacante->nome);
+        tropasMinimas = 1;
+    }
 
-        // Defensor perde 15% das tropas e possivelmente muda de cor
-        tropasPerdidas = conquistarTerritorio(defensor, atacante->cor, 15.0);
+    while (atacante->tropas > tropasMinimas && !saida->conquistado)
+    {
+        resolverAtaque(atacante, defensor, gerador, &combate);
+        acumularRodada(saida, &combate);
 
-        // Verifica se a cor do território mudou (ou seja, se as tropas chegaram a zero)
-        if (strcmp(defensor->cor, atacante->cor) == 0)
+        if (observador != NULL)
         {
-            printf("O territorio %s foi conquistado e agora pertence ao exercito %s\n", defensor->nome, defensor->cor);
+            observador(&combate, contexto);
+        }
+    }
+}
+
+/**
+ * Versão de simularBatalha para simulações em massa, com os dados de uma fonte em lote
+ */
+void simularBatalhaLote(Territorio *atacante, Territorio *defensor, int tropasMinimas, FonteDadosLote *fonte,
+                        ResultadoBatalha *saida)
+{
+    ResultadoCombate combate;
+
+    memset(saida, 0, sizeof(ResultadoBatalha));
+
+    if (tropasMinimas < 1)
+    {
+        tropasMinimas = 1;
+    }
+
+    while (atacante->tropas > tropasMinimas && !saida->conquistado)
+    {
+        resolverAtaqueLote(atacante, defensor, fonte, &combate);
+        acumularRodada(saida, &combate);
+    }
+}
+
+/**
+ * Função para exibir no console o desfecho de um ataque já resolvido
+ */
+void exibirResultadoCombate(const Territorio *atacante, const Territorio *defensor, const ResultadoCombate *combate)
+{
+    printf("\n===================================\n");
+    printf("        SIMULACAO DE ATAQUE       \n");
+    printf("===================================\n");
+    printf("Atacante: %s (%s)\n", textoNome(atacante->nome), nomeCor(atacante->idCor));
+    printf("  Dados: %d e %d (Total: %d)\n", combate->dadosAtacante.dado1, combate->dadosAtacante.dado2, combate->dadosAtacante.soma);
+    printf("Defensor: %s (%s)\n", textoNome(defensor->nome), nomeCor(defensor->idCor));
+    printf("  Dados: %d e %d (Total: %d)\n", combate->dadosDefensor.dado1, combate->dadosDefensor.dado2, combate->dadosDefensor.soma);
+
+    switch (combate->resultado)
+    {
+    case VITORIA_ATACANTE:
+        printf("\nResultado: %s venceu o ataque!\n", textoNome(atacante->nome));
+
+        if (combate->conquistado)
+        {
+            printf("O territorio %s foi conquistado e agora pertence ao exercito %s\n", textoNome(defensor->nome), nomeCor(defensor->idCor));
         }
         else
         {
-            printf("O territorio %s sofreu danos mas manteve sua cor %s\n", defensor->nome, defensor->cor);
+            printf("O territorio %s sofreu danos mas manteve sua cor %s\n", textoNome(defensor->nome), nomeCor(defensor->idCor));
         }
-        printf("O defensor perdeu %d tropas (15%% do total)\n", tropasPerdidas);
+        printf("O defensor perdeu %d tropas (15%% do total)\n", combate->tropasPerdidasDefensor);
         break;
 
     case VITORIA_DEFENSOR:
-        printf("\nResultado: %s defendeu com sucesso!\n", defensor->nome);
-
-        // Atacante perde 15% das tropas
-        tropasPerdidas = reduzirTropas(atacante, 15.0);
-
-        printf("%s perdeu %d tropas no ataque (15%% do total)!\n", atacante->nome, tropasPerdidas);
+        printf("\nResultado: %s defendeu com sucesso!\n", textoNome(defensor->nome));
+        printf("%s perdeu %d tropas no ataque (15%% do total)!\n", textoNome(atacante->nome), combate->tropasPerdidasAtacante);
         break;
 
     case EMPATE:
         printf("\nResultado: Empate! Ambos os lados mantêm suas posições.\n");
-
-        // Em caso de empate, ambos perdem 5% das tropas
-        int tropasPerdidas1 = reduzirTropas(atacante, 5.0);
-        int tropasPerdidas2 = reduzirTropas(defensor, 5.0);
-
         printf("Ambos os lados sofreram baixas!\n");
-        printf("%s perdeu %d tropas (5%% do total)\n", atacante->nome, tropasPerdidas1);
-        printf("%s perdeu %d tropas (5%% do total)\n", defensor->nome, tropasPerdidas2);
+        printf("%s perdeu %d tropas (5%% do total)\n", textoNome(atacante->nome), combate->tropasPerdidasAtacante);
+        printf("%s perdeu %d tropas (5%% do total)\n", textoNome(defensor->nome), combate->tropasPerdidasDefensor);
         break;
     }
 
     printf("===================================\n\n");
 }
+
+/**
+ * Função para simular um ataque entre territórios e exibir o resultado
+ * Mantida para compatibilidade: combina resolverAtaque e exibirResultadoCombate
+ */
+ResultadoAtaque atacar(Territorio *atacante, Territorio *defensor, GeradorAleatorio *gerador)
+{
+    ResultadoCombate combate;
+
+    resolverAtaque(atacante, defensor, gerador, &combate);
+    exibirResultadoCombate(atacante, defensor, &combate);
+
+    return combate.resultado;
+}
+
+/**
+ * Função para processar o resultado de um ataque
+ * Implementa passagem por referência usando ponteiros
+ */
+void processarResultadoAtaque(
+    Territorio *atacante,
+    Territorio *defensor,
+    ResultadoAtaque resultadoAtaque,
+    const ResultadoDados *dadosAtacante,
+    const ResultadoDados *dadosDefensor)
+{
+    ResultadoCombate combate;
+
+    combate.dadosAtacante = *dadosAtacante;
+    combate.dadosDefensor = *dadosDefensor;
+    combate.resultado = resultadoAtaque;
+
+    aplicarResultadoAtaque(atacante, defensor, &combate);
+    exibirResultadoCombate(atacante, defensor, &combate);
+}
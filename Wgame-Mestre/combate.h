@@ -6,7 +6,10 @@
 #ifndef COMBATE_H
 #define COMBATE_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "territorio.h"
+#include "aleatorio.h"
 
 /**
  * Estrutura para armazenar os resultados dos dados
@@ -28,22 +31,187 @@ typedef enum
     EMPATE
 } ResultadoAtaque;
 
+/**
+ * Estrutura com o desfecho completo de um ataque já resolvido:
+ * - dadosAtacante/dadosDefensor: dados lançados por cada lado
+ * - resultado: vencedor da rodada (ou empate)
+ * - tropasPerdidasAtacante/tropasPerdidasDefensor: baixas aplicadas a cada lado
+ * - conquistado: 1 se o defensor mudou para a cor do atacante, 0 caso contrário
+ */
+typedef struct
+{
+    ResultadoDados dadosAtacante;
+    ResultadoDados dadosDefensor;
+    ResultadoAtaque resultado;
+    int tropasPerdidasAtacante;
+    int tropasPerdidasDefensor;
+    int conquistado;
+} ResultadoCombate;
+
+/**
+ * Estrutura com o resumo de uma batalha (sequência de ataques repetidos):
+ * - rodadas: quantidade de ataques resolvidos
+ * - vitoriasAtacante/vitoriasDefensor/empates: contagem de cada resultado
+ * - tropasPerdidasAtacante/tropasPerdidasDefensor: baixas acumuladas
+ * - conquistado: 1 se a batalha terminou com a conquista do defensor
+ */
+typedef struct
+{
+    int rodadas;
+    int vitoriasAtacante;
+    int vitoriasDefensor;
+    int empates;
+    int tropasPerdidasAtacante;
+    int tropasPerdidasDefensor;
+    int conquistado;
+} ResultadoBatalha;
+
+// Jogadas (pares de dados) sorteadas de cada vez por uma fonte de dados em lote
+#define JOGADAS_FONTE_LOTE 4096
+
+/**
+ * Fonte de dados em lote para batalhas em massa
+ *
+ * Guarda JOGADAS_FONTE_LOTE jogadas sorteadas de uma vez por lancarDadosLote e
+ * as entrega uma a uma; cada ataque consome duas (atacante e defensor). Quando
+ * acabam, o próximo lote é sorteado.
+ */
+typedef struct
+{
+    GeradorLote gerador;
+    int posicao;
+    uint8_t dado1[JOGADAS_FONTE_LOTE];
+    uint8_t dado2[JOGADAS_FONTE_LOTE];
+    uint8_t soma[JOGADAS_FONTE_LOTE];
+} FonteDadosLote;
+
+/**
+ * Tipo de função chamada após cada rodada de uma batalha
+ * @param combate Desfecho da rodada que acabou de ser resolvida
+ * @param contexto Ponteiro repassado sem alterações por quem iniciou a batalha
+ */
+typedef void (*ObservadorCombate)(const ResultadoCombate *combate, void *contexto);
+
 /**
  * Função para lançar dois dados e retornar o resultado
  * @param resultado Ponteiro para estrutura onde o resultado será armazenado
+ * @param gerador Gerador de números aleatórios usado no lançamento
+ */
+void lancarDados(ResultadoDados *resultado, GeradorAleatorio *gerador);
+
+/**
+ * Função para lançar os dois dados de muitas jogadas de uma só vez
+ *
+ * Versão em lote de lancarDados para simulações em massa: os vetores são
+ * preenchidos pelo gerador vetorizado (AVX2/SSE2 quando disponível).
+ *
+ * @param gerador Gerador em lote
+ * @param dado1 Vetor que receberá o primeiro dado de cada jogada
+ * @param dado2 Vetor que receberá o segundo dado de cada jogada
+ * @param soma Vetor que receberá a soma de cada jogada
+ * @param quantidade Quantidade de jogadas
+ */
+void lancarDadosLote(GeradorLote *gerador, uint8_t *dado1, uint8_t *dado2, uint8_t *soma, size_t quantidade);
+
+/**
+ * Função para preparar uma fonte de dados em lote
+ * @param fonte Ponteiro para a fonte
+ * @param semente Semente do gerador em lote da fonte
  */
-void lancarDados(ResultadoDados *resultado);
+void iniciarFonteDadosLote(FonteDadosLote *fonte, uint64_t semente);
 
 /**
- * Função para simular um ataque entre territórios
+ * Função para resolver um ataque entre territórios sem nenhuma saída no console
+ *
+ * Lança os dados, compara as somas e aplica as perdas nos territórios. É o núcleo
+ * usado tanto pelo menu interativo quanto pelas simulações em massa.
+ *
  * @param atacante Ponteiro para o território atacante
  * @param defensor Ponteiro para o território defensor
+ * @param gerador Gerador de números aleatórios usado nos dados
+ * @param saida Ponteiro para a estrutura que receberá o desfecho do ataque
+ */
+void resolverAtaque(Territorio *atacante, Territorio *defensor, GeradorAleatorio *gerador, ResultadoCombate *saida);
+
+/**
+ * Função para repetir ataques até a conquista ou até o atacante chegar ao piso de tropas
+ *
+ * O atacante só ataca enquanto tiver mais tropas que 'tropasMinimas' (no mínimo 1,
+ * já que um território nunca fica com menos de uma tropa). Não escreve no console.
+ *
+ * @param atacante Ponteiro para o território atacante
+ * @param defensor Ponteiro para o território defensor
+ * @param tropasMinimas Piso de tropas abaixo do qual o atacante deixa de atacar
+ * @param gerador Gerador de números aleatórios usado nos dados
+ * @param saida Ponteiro para a estrutura que receberá o resumo da batalha
+ */
+void simularBatalha(Territorio *atacante, Territorio *defensor, int tropasMinimas, GeradorAleatorio *gerador, ResultadoBatalha *saida);
+
+/**
+ * Versão de simularBatalha para simulações em massa, com os dados de uma fonte em lote
+ *
+ * Mesmas regras e mesmo resumo; só muda a origem dos dados, que são sorteados
+ * milhares de cada vez pelo gerador vetorizado.
+ *
+ * @param atacante Ponteiro para o território atacante
+ * @param defensor Ponteiro para o território defensor
+ * @param tropasMinimas Piso de tropas abaixo do qual o atacante deixa de atacar
+ * @param fonte Fonte de dados em lote
+ * @param saida Ponteiro para a estrutura que receberá o resumo da batalha
+ */
+void simularBatalhaLote(Territorio *atacante, Territorio *defensor, int tropasMinimas, FonteDadosLote *fonte,
+                        ResultadoBatalha *saida);
+
+/**
+ * Função para simular uma batalha avisando um observador a cada rodada
+ *
+ * Igual a simularBatalha, mas chama 'observador' (se não for NULL) após cada
+ * ataque resolvido, para quem precisa acompanhar as rodadas individualmente.
+ *
+ * @param atacante Ponteiro para o território atacante
+ * @param defensor Ponteiro para o território defensor
+ * @param tropasMinimas Piso de tropas abaixo do qual o atacante deixa de atacar
+ * @param gerador Gerador de números aleatórios usado nos dados
+ * @param observador Função chamada após cada rodada (pode ser NULL)
+ * @param contexto Ponteiro repassado ao observador
+ * @param saida Ponteiro para a estrutura que receberá o resumo da batalha
+ */
+void simularBatalhaObservada(
+    Territorio *atacante,
+    Territorio *defensor,
+    int tropasMinimas,
+    GeradorAleatorio *gerador,
+    ObservadorCombate observador,
+    void *contexto,
+    ResultadoBatalha *saida);
+
+/**
+ * Função para exibir no console o desfecho de um ataque já resolvido
+ * @param atacante Ponteiro para o território atacante (estado após o ataque)
+ * @param defensor Ponteiro para o território defensor (estado após o ataque)
+ * @param combate Desfecho retornado por resolverAtaque
+ */
+void exibirResultadoCombate(const Territorio *atacante, const Territorio *defensor, const ResultadoCombate *combate);
+
+/**
+ * Função para simular um ataque entre territórios e exibir o resultado
+ * @param atacante Ponteiro para o território atacante
+ * @param defensor Ponteiro para o território defensor
+ * @param gerador Gerador de números aleatórios usado nos dados
  * @return Resultado do ataque (VITORIA_ATACANTE, VITORIA_DEFENSOR ou EMPATE)
  */
-ResultadoAtaque atacar(Territorio *atacante, Territorio *defensor);
+ResultadoAtaque atacar(Territorio *atacante, Territorio *defensor, GeradorAleatorio *gerador);
+
+/**
+ * Função para aplicar as perdas de um ataque cujo resultado já é conhecido
+ * @param atacante Ponteiro para o território atacante
+ * @param defensor Ponteiro para o território defensor
+ * @param combate Desfecho com dados e resultado preenchidos; recebe as perdas e a conquista
+ */
+void aplicarResultadoAtaque(Territorio *atacante, Territorio *defensor, ResultadoCombate *combate);
 
 /**
- * Função para processar o resultado de um ataque
+ * Função para processar e exibir o resultado de um ataque
  * @param atacante Ponteiro para o território atacante
  * @param defensor Ponteiro para o território defensor
  * @param resultadoAtaque Resultado do ataque
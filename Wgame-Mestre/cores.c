@@ -0,0 +1,200 @@
+/**
+ * cores.c - Implementação da tabela global de cores de exército
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#include <string.h>
+#include <pthread.h>
+#include "cores.h"
+
+// Posições do índice de busca (potência de 2, pelo menos o dobro de MAX_CORES)
+#define POSICOES_INDICE 2048
+
+/**
+ * Tabela de cores
+ * - nomes: nome de cada cor, na ordem de cadastro
+ * - indice: endereçamento aberto de hash do nome para identificador + 1 (0 = vazio)
+ *
+ * Os nomes nunca mudam depois de publicados, então a leitura dispensa trava;
+ * apenas o cadastro de uma cor nova é serializado.
+ */
+typedef struct
+{
+    char nomes[MAX_CORES][TAMANHO_COR];
+    uint16_t indice[POSICOES_INDICE];
+    int quantidade;
+    int inicializada;
+    pthread_mutex_t trava;
+} TabelaCores;
+
+static const char *NOMES_PADRAO[CORES_PADRAO] = {
+    "Vermelho", "Azul", "Verde", "Amarelo", "Preto", "Branco"};
+
+static TabelaCores tabela = {.trava = PTHREAD_MUTEX_INITIALIZER};
+
+/**
+ * Função auxiliar: hash FNV-1a de 32 bits do nome truncado
+ */
+static uint32_t calcularHashCor(const char *nome, size_t tamanho)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < tamanho; i++)
+    {
+        hash ^= (unsigned char)nome[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * Função auxiliar: comprimento do nome depois do truncamento
+ */
+static size_t comprimentoCor(const char *nome)
+{
+    size_t comprimento = 0;
+
+    while (comprimento < TAMANHO_COR - 1 && nome[comprimento] != '\0')
+    {
+        comprimento++;
+    }
+
+    return comprimento;
+}
+
+/**
+ * Função auxiliar: procura no índice; devolve a posição do nome ou da vaga onde ele entraria
+ */
+static uint32_t localizarCor(const char *nome, size_t comprimento, int *idCor)
+{
+    uint32_t posicao = calcularHashCor(nome, comprimento) & (POSICOES_INDICE - 1);
+
+    for (;;)
+    {
+        uint16_t entrada = __atomic_load_n(&tabela.indice[posicao], __ATOMIC_ACQUIRE);
+
+        if (entrada == 0)
+        {
+            *idCor = -1;
+            return posicao;
+        }
+        if (strncmp(tabela.nomes[entrada - 1], nome, comprimento) == 0 &&
+            tabela.nomes[entrada - 1][comprimento] == '\0')
+        {
+            *idCor = entrada - 1;
+            return posicao;
+        }
+        posicao = (posicao + 1) & (POSICOES_INDICE - 1);
+    }
+}
+
+/**
+ * Função auxiliar que cadastra uma cor; deve ser chamada com a trava obtida
+ */
+static int cadastrarCor(const char *nome, size_t comprimento)
+{
+    int idCor;
+    uint32_t posicao = localizarCor(nome, comprimento, &idCor);
+
+    if (idCor >= 0)
+    {
+        return idCor;
+    }
+    if (tabela.quantidade == MAX_CORES)
+    {
+        return -1;
+    }
+
+    idCor = tabela.quantidade;
+    memcpy(tabela.nomes[idCor], nome, comprimento);
+    tabela.nomes[idCor][comprimento] = '\0';
+    __atomic_store_n(&tabela.quantidade, idCor + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&tabela.indice[posicao], (uint16_t)(idCor + 1), __ATOMIC_RELEASE);
+
+    return idCor;
+}
+
+/**
+ * Função auxiliar que cadastra as cores padrão no primeiro uso
+ */
+static void prepararTabela(void)
+{
+    if (__atomic_load_n(&tabela.inicializada, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&tabela.trava);
+    if (!tabela.inicializada)
+    {
+        for (int i = 0; i < CORES_PADRAO; i++)
+        {
+            cadastrarCor(NOMES_PADRAO[i], strlen(NOMES_PADRAO[i]));
+        }
+        __atomic_store_n(&tabela.inicializada, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&tabela.trava);
+}
+
+/**
+ * Função para obter o identificador de uma cor, cadastrando-a se for nova
+ */
+int internarCor(const char *nome)
+{
+    size_t comprimento = comprimentoCor(nome);
+    int idCor;
+
+    prepararTabela();
+
+    // Caminho rápido: a cor já existe
+    localizarCor(nome, comprimento, &idCor);
+    if (idCor >= 0)
+    {
+        return idCor;
+    }
+
+    pthread_mutex_lock(&tabela.trava);
+    idCor = cadastrarCor(nome, comprimento);
+    pthread_mutex_unlock(&tabela.trava);
+
+    return idCor;
+}
+
+/**
+ * Função para procurar uma cor sem cadastrá-la
+ */
+int procurarCor(const char *nome)
+{
+    int idCor;
+
+    prepararTabela();
+    localizarCor(nome, comprimentoCor(nome), &idCor);
+    return idCor;
+}
+
+/**
+ * Função para obter o nome de uma cor
+ * As cores padrão têm nome conhecido mesmo antes do primeiro cadastro
+ */
+const char *nomeCor(uint16_t idCor)
+{
+    if (idCor < CORES_PADRAO)
+    {
+        return NOMES_PADRAO[idCor];
+    }
+    if (idCor >= __atomic_load_n(&tabela.quantidade, __ATOMIC_ACQUIRE))
+    {
+        return "?";
+    }
+    return tabela.nomes[idCor];
+}
+
+/**
+ * Função para obter a quantidade de cores cadastradas
+ */
+int quantidadeCores(void)
+{
+    prepararTabela();
+    return __atomic_load_n(&tabela.quantidade, __ATOMIC_ACQUIRE);
+}
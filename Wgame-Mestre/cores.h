@@ -0,0 +1,55 @@
+/**
+ * cores.h - Tabela global de cores de exército
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef CORES_H
+#define CORES_H
+
+#include <stdint.h>
+
+// Tamanho máximo do nome de uma cor (incluindo o '\0')
+#define TAMANHO_COR 10
+
+// Quantidade máxima de cores distintas na tabela
+#define MAX_CORES 1024
+
+/**
+ * Cores pré-cadastradas, com identificadores fixos de 0 a CORES_PADRAO - 1:
+ * Vermelho, Azul, Verde, Amarelo, Preto e Branco
+ */
+#define CORES_PADRAO 6
+
+/**
+ * Função para obter o identificador de uma cor, cadastrando-a se for nova
+ *
+ * Cada cor distinta é guardada uma única vez; os territórios guardam apenas o
+ * identificador, então comparar ou transferir a posse é comparar ou copiar um
+ * inteiro. Pode ser chamada de várias threads ao mesmo tempo.
+ *
+ * @param nome Nome da cor (truncado em TAMANHO_COR - 1 caracteres)
+ * @return Identificador da cor, ou -1 se a tabela estiver cheia
+ */
+int internarCor(const char *nome);
+
+/**
+ * Função para procurar uma cor sem cadastrá-la
+ * @param nome Nome da cor (truncado em TAMANHO_COR - 1 caracteres)
+ * @return Identificador da cor, ou -1 se ela não existir
+ */
+int procurarCor(const char *nome);
+
+/**
+ * Função para obter o nome de uma cor
+ * @param idCor Identificador da cor
+ * @return Nome da cor, ou "?" se o identificador não existir
+ */
+const char *nomeCor(uint16_t idCor);
+
+/**
+ * Função para obter a quantidade de cores cadastradas
+ * @return Quantidade de cores, incluindo as pré-cadastradas
+ */
+int quantidadeCores(void);
+
+#endif /* CORES_H */
@@ -0,0 +1,363 @@
+/**
+ * eventos.c - Implementação do fluxo de eventos de combate em NDJSON
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "eventos.h"
+#include "cores.h"
+
+#define TEXTO_RESULTADO(texto) {texto, sizeof(texto) - 1}
+
+static const struct
+{
+    char texto[16];
+    size_t comprimento;
+} NOMES_RESULTADO[] = {TEXTO_RESULTADO("\"atacante\""), TEXTO_RESULTADO("\"defensor\""), TEXTO_RESULTADO("\"empate\"")};
+
+/**
+ * Função auxiliar que envia o buffer com write, repetindo em escritas parciais
+ */
+static void enviarBuffer(SaidaEventos *saida)
+{
+    size_t enviado = 0;
+
+    while (enviado < saida->usado && !saida->falhou)
+    {
+        ssize_t escritos = write(saida->descritor, saida->buffer + enviado, saida->usado - enviado);
+
+        if (escritos < 0)
+        {
+            if (errno != EINTR)
+            {
+                saida->falhou = 1;
+            }
+            continue;
+        }
+        enviado += (size_t)escritos;
+    }
+    saida->usado = 0;
+
+    // Depois de um envio (que pode ter esperado o leitor do pipe), o próximo evento relê o relógio
+    saida->usosInstante = 0;
+}
+
+/**
+ * Função auxiliar que garante espaço para um evento inteiro, sem verificar cada campo
+ * @return Posição livre do buffer
+ */
+static char *reservarEvento(SaidaEventos *saida)
+{
+    if (BUFFER_EVENTOS - saida->usado < TAMANHO_MAXIMO_EVENTO)
+    {
+        enviarBuffer(saida);
+    }
+    return saida->buffer + saida->usado;
+}
+
+/**
+ * Função auxiliar que copia um texto literal (sem o '\0') e devolve a posição seguinte
+ */
+static char *escreverLiteral(char *destino, const char *texto, size_t comprimento)
+{
+    memcpy(destino, texto, comprimento);
+    return destino + comprimento;
+}
+
+#define LITERAL(destino, texto) escreverLiteral((destino), (texto), sizeof(texto) - 1)
+
+/**
+ * Função auxiliar que escreve um inteiro em decimal direto no destino, dois dígitos por vez
+ */
+static char *escreverInteiro(char *destino, long long valor)
+{
+    static const char PARES[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    unsigned long long absoluto = valor < 0 ? 0ULL - (unsigned long long)valor : (unsigned long long)valor;
+    unsigned long long resto = absoluto;
+    int digitos = 1;
+    char *fim;
+
+    // Atalho para dados, perdas e ids pequenos, que são a maioria dos números de um evento
+    if (valor >= 0 && valor < 10)
+    {
+        *destino = (char)('0' + valor);
+        return destino + 1;
+    }
+
+    if (valor < 0)
+    {
+        *destino++ = '-';
+    }
+
+    // Conta os dígitos para escrever de trás para frente já na posição final
+    while (resto >= 10)
+    {
+        resto /= 10;
+        digitos++;
+    }
+    fim = destino + digitos;
+
+    while (absoluto >= 100)
+    {
+        unsigned par = (unsigned)(absoluto % 100) * 2;
+
+        absoluto /= 100;
+        *--fim = PARES[par + 1];
+        *--fim = PARES[par];
+    }
+    if (absoluto >= 10)
+    {
+        *--fim = PARES[absoluto * 2 + 1];
+        *--fim = PARES[absoluto * 2];
+    }
+    else
+    {
+        *--fim = (char)('0' + absoluto);
+    }
+
+    return destino + digitos;
+}
+
+/**
+ * Função auxiliar que escreve o nome de uma cor entre aspas, escapando-o só na primeira vez
+ */
+static char *escreverCor(SaidaEventos *saida, char *destino, uint16_t idCor)
+{
+    static const char HEXA[] = "0123456789abcdef";
+    CorJson *cor = &saida->cores[idCor < MAX_CORES ? idCor : 0];
+
+    if (cor->comprimento == 0)
+    {
+        const unsigned char *nome = (const unsigned char *)nomeCor(idCor);
+        char *texto = cor->texto;
+
+        *texto++ = '"';
+        for (; *nome != '\0'; nome++)
+        {
+            if (*nome == '"' || *nome == '\\')
+            {
+                *texto++ = '\\';
+                *texto++ = (char)*nome;
+            }
+            else if (*nome < 0x20)
+            {
+                texto = LITERAL(texto, "\\u00");
+                *texto++ = HEXA[*nome >> 4];
+                *texto++ = HEXA[*nome & 0xF];
+            }
+            else
+            {
+                *texto++ = (char)*nome;
+            }
+        }
+        *texto++ = '"';
+        cor->comprimento = (uint8_t)(texto - cor->texto);
+    }
+
+    // Cópia de tamanho fixo: a folga de TAMANHO_MAXIMO_EVENTO comporta os bytes além do nome
+    memcpy(destino, cor->texto, sizeof(cor->texto));
+    return destino + cor->comprimento;
+}
+
+/**
+ * Função auxiliar que escreve o início comum dos eventos: tipo, instante e partida
+ *
+ * O instante tem 16 dígitos e muda só a cada EVENTOS_POR_RELOGIO eventos, então
+ * o trecho com instante e partida é formatado uma vez e copiado nos eventos seguintes.
+ */
+static char *escreverInicio(SaidaEventos *saida, char *destino, const char *tipo, size_t comprimentoTipo)
+{
+    if (saida->usosInstante == 0)
+    {
+        struct timespec agora;
+
+        clock_gettime(CLOCK_REALTIME, &agora);
+        saida->instante = (long long)agora.tv_sec * 1000000 + agora.tv_nsec / 1000;
+        saida->usosInstante = EVENTOS_POR_RELOGIO;
+        saida->comprimentoMarca = 0;
+    }
+    saida->usosInstante--;
+
+    if (saida->comprimentoMarca == 0 || saida->partidaMarca != saida->partida)
+    {
+        char *marca = saida->marca;
+
+        marca = LITERAL(marca, "\",\"instante\":");
+        marca = escreverInteiro(marca, saida->instante);
+        marca = LITERAL(marca, ",\"partida\":");
+        marca = escreverInteiro(marca, saida->partida);
+        saida->comprimentoMarca = (size_t)(marca - saida->marca);
+        saida->partidaMarca = saida->partida;
+    }
+
+    destino = LITERAL(destino, "{\"tipo\":\"");
+    destino = escreverLiteral(destino, tipo, comprimentoTipo);
+
+    // Cópia de tamanho fixo, como a das cores
+    memcpy(destino, saida->marca, sizeof(saida->marca));
+    return destino + saida->comprimentoMarca;
+}
+
+/**
+ * Função para abrir o destino dos eventos
+ */
+int abrirEventos(SaidaEventos *saida, const char *caminho)
+{
+    memset(saida, 0, sizeof(SaidaEventos));
+
+    if (strcmp(caminho, "-") == 0)
+    {
+        saida->descritor = STDOUT_FILENO;
+        return 1;
+    }
+
+    saida->descritor = open(caminho, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    saida->fecharDescritor = 1;
+    return saida->descritor >= 0;
+}
+
+/**
+ * Função para emitir o evento de uma rodada de ataque
+ */
+void emitirAtaque(SaidaEventos *saida, int idAtacante, int idDefensor, uint16_t corAtacante, uint16_t corDefensor,
+                  const ResultadoCombate *combate)
+{
+    char *destino = reservarEvento(saida);
+
+    destino = escreverInicio(saida, destino, "ataque", sizeof("ataque") - 1);
+    destino = LITERAL(destino, ",\"atacante\":");
+    destino = escreverInteiro(destino, idAtacante + 1);
+    destino = LITERAL(destino, ",\"defensor\":");
+    destino = escreverInteiro(destino, idDefensor + 1);
+    destino = LITERAL(destino, ",\"corAtacante\":");
+    destino = escreverCor(saida, destino, corAtacante);
+    destino = LITERAL(destino, ",\"corDefensor\":");
+    destino = escreverCor(saida, destino, corDefensor);
+
+    // Dados de 1 a 6: um caractere cada
+    destino = LITERAL(destino, ",\"dados\":[");
+    *destino++ = (char)('0' + combate->dadosAtacante.dado1);
+    *destino++ = ',';
+    *destino++ = (char)('0' + combate->dadosAtacante.dado2);
+    *destino++ = ',';
+    *destino++ = (char)('0' + combate->dadosDefensor.dado1);
+    *destino++ = ',';
+    *destino++ = (char)('0' + combate->dadosDefensor.dado2);
+
+    destino = LITERAL(destino, "],\"resultado\":");
+    memcpy(destino, NOMES_RESULTADO[combate->resultado].texto, sizeof(NOMES_RESULTADO[0].texto));
+    destino += NOMES_RESULTADO[combate->resultado].comprimento;
+    destino = LITERAL(destino, ",\"perdaAtacante\":");
+    destino = escreverInteiro(destino, combate->tropasPerdidasAtacante);
+    destino = LITERAL(destino, ",\"perdaDefensor\":");
+    destino = escreverInteiro(destino, combate->tropasPerdidasDefensor);
+    destino = LITERAL(destino, "}\n");
+
+    saida->usado = (size_t)(destino - saida->buffer);
+    saida->eventos++;
+}
+
+/**
+ * Função para emitir o evento de uma conquista
+ */
+void emitirConquista(SaidaEventos *saida, int idAtacante, int idTerritorio, uint16_t corAnterior, uint16_t corNova,
+                     int tropas)
+{
+    char *destino = reservarEvento(saida);
+
+    destino = escreverInicio(saida, destino, "conquista", sizeof("conquista") - 1);
+    destino = LITERAL(destino, ",\"territorio\":");
+    destino = escreverInteiro(destino, idTerritorio + 1);
+    destino = LITERAL(destino, ",\"atacante\":");
+    destino = escreverInteiro(destino, idAtacante + 1);
+    destino = LITERAL(destino, ",\"corAnterior\":");
+    destino = escreverCor(saida, destino, corAnterior);
+    destino = LITERAL(destino, ",\"corNova\":");
+    destino = escreverCor(saida, destino, corNova);
+    destino = LITERAL(destino, ",\"tropas\":");
+    destino = escreverInteiro(destino, tropas);
+    destino = LITERAL(destino, "}\n");
+
+    saida->usado = (size_t)(destino - saida->buffer);
+    saida->eventos++;
+}
+
+/**
+ * Função para preparar o acompanhamento de ataques entre dois territórios
+ */
+void iniciarAcompanhamentoEventos(AcompanhamentoEventos *acompanhamento, SaidaEventos *saida,
+                                  const Territorio *atacante, const Territorio *defensor, int idAtacante, int idDefensor)
+{
+    acompanhamento->saida = saida;
+    acompanhamento->atacante = atacante;
+    acompanhamento->defensor = defensor;
+    acompanhamento->idAtacante = idAtacante;
+    acompanhamento->idDefensor = idDefensor;
+    acompanhamento->corAtacante = atacante->idCor;
+    acompanhamento->corDefensor = defensor->idCor;
+}
+
+/**
+ * Observador de combate que emite o evento de cada rodada e o da conquista
+ */
+void emitirEventoObservado(const ResultadoCombate *combate, void *contexto)
+{
+    AcompanhamentoEventos *acompanhamento = (AcompanhamentoEventos *)contexto;
+
+    if (acompanhamento == NULL || acompanhamento->saida == NULL)
+    {
+        return;
+    }
+
+    emitirAtaque(acompanhamento->saida, acompanhamento->idAtacante, acompanhamento->idDefensor,
+                 acompanhamento->corAtacante, acompanhamento->corDefensor, combate);
+
+    if (combate->conquistado)
+    {
+        emitirConquista(acompanhamento->saida, acompanhamento->idAtacante, acompanhamento->idDefensor,
+                        acompanhamento->corDefensor, acompanhamento->corAtacante, acompanhamento->defensor->tropas);
+        acompanhamento->corDefensor = acompanhamento->corAtacante;
+    }
+}
+
+/**
+ * Função para fazer o próximo evento reler o relógio
+ */
+void renovarInstanteEventos(SaidaEventos *saida)
+{
+    saida->usosInstante = 0;
+}
+
+/**
+ * Função para enviar os eventos pendentes
+ */
+int descarregarEventosPendentes(SaidaEventos *saida)
+{
+    enviarBuffer(saida);
+    return !saida->falhou;
+}
+
+/**
+ * Função para enviar os eventos pendentes e fechar o destino
+ */
+int fecharEventos(SaidaEventos *saida)
+{
+    int sucesso = descarregarEventosPendentes(saida);
+
+    if (saida->fecharDescritor && close(saida->descritor) != 0)
+    {
+        sucesso = 0;
+    }
+    saida->descritor = -1;
+    saida->fecharDescritor = 0;
+    return sucesso;
+}
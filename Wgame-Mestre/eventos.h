@@ -0,0 +1,175 @@
+/**
+ * eventos.h - Fluxo de eventos de combate em NDJSON para análise
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef EVENTOS_H
+#define EVENTOS_H
+
+#include <stdint.h>
+#include "territorio.h"
+#include "combate.h"
+
+/**
+ * Formato: um objeto JSON por linha (NDJSON), com os territórios numerados de 1 a N
+ * como na interface e o instante em microssegundos desde 1970 (UTC):
+ *
+ *   {"tipo":"ataque","instante":...,"partida":0,"atacante":3,"defensor":7,
+ *    "corAtacante":"Azul","corDefensor":"Verde","dados":[4,3,6,5],
+ *    "resultado":"defensor","perdaAtacante":12,"perdaDefensor":0}
+ *   {"tipo":"conquista","instante":...,"partida":0,"territorio":7,"atacante":3,
+ *    "corAnterior":"Verde","corNova":"Azul","tropas":41}
+ *
+ * "dados" traz os dois dados do atacante e depois os dois do defensor; "resultado"
+ * é "atacante", "defensor" ou "empate".
+ */
+
+// Bytes acumulados antes de cada write
+#define BUFFER_EVENTOS (64 * 1024)
+
+// Maior evento possível: folga que precisa restar no buffer antes de formatar um evento
+#define TAMANHO_MAXIMO_EVENTO 512
+
+// Espaço de uma cor já escapada e entre aspas (até 6 bytes por caractere, como em \u0001),
+// arredondado para 63 para que cada CorJson ocupe 64 bytes
+#define TAMANHO_COR_JSON 63
+
+// Eventos que reaproveitam o mesmo instante antes de uma nova leitura do relógio
+#define EVENTOS_POR_RELOGIO 16
+
+// Espaço do trecho ,"instante":...,"partida":... já formatado (copiado inteiro em cada evento)
+#define TAMANHO_MARCA_EVENTO 64
+
+/**
+ * Nome de uma cor já pronto para o JSON; comprimento 0 indica que ainda não foi preparado
+ *
+ * O texto é sempre copiado inteiro (tamanho fixo, sem chamada a memcpy) e só o
+ * comprimento avança no buffer.
+ */
+typedef struct
+{
+    uint8_t comprimento;
+    char texto[TAMANHO_COR_JSON];
+} CorJson;
+
+/**
+ * Destino dos eventos (arquivo, pipe ou saída padrão)
+ * - partida: número copiado em cada evento; quem joga várias partidas o atualiza entre elas
+ * - eventos: eventos emitidos desde a abertura
+ * - instante/usosInstante: último instante lido do relógio e quantos eventos ainda podem
+ *   reaproveitá-lo; a leitura custa tanto quanto formatar meio evento, então é feita a cada
+ *   EVENTOS_POR_RELOGIO eventos, sempre depois de um envio e depois de renovarInstanteEventos
+ * - marca/comprimentoMarca/partidaMarca: instante e partida já formatados, refeitos só
+ *   quando o relógio é relido ou a partida muda (comprimento 0 indica que estão desatualizados)
+ * - falhou: diferente de zero depois de uma escrita com erro (os eventos seguintes são descartados)
+ * - cores: cache dos nomes de cor escapados, preenchido na primeira vez que cada cor aparece
+ *
+ * Não é protegida para uso por várias threads ao mesmo tempo.
+ */
+typedef struct
+{
+    int descritor;
+    int fecharDescritor;
+    int falhou;
+    long long partida;
+    uint64_t eventos;
+    long long instante;
+    int usosInstante;
+    long long partidaMarca;
+    size_t comprimentoMarca;
+    char marca[TAMANHO_MARCA_EVENTO];
+    size_t usado;
+    char buffer[BUFFER_EVENTOS];
+    CorJson cores[MAX_CORES];
+} SaidaEventos;
+
+/**
+ * Estrutura que acompanha um par atacante/defensor para emitir seus eventos
+ *
+ * Guarda as cores antes da primeira rodada, porque o defensor muda de cor na
+ * conquista e o evento precisa das duas.
+ */
+typedef struct
+{
+    SaidaEventos *saida;
+    const Territorio *atacante;
+    const Territorio *defensor;
+    int idAtacante;
+    int idDefensor;
+    uint16_t corAtacante;
+    uint16_t corDefensor;
+} AcompanhamentoEventos;
+
+/**
+ * Função para abrir o destino dos eventos
+ * @param saida Ponteiro para o destino
+ * @param caminho Arquivo ou pipe nomeado a ser criado/truncado; "-" usa a saída padrão
+ * @return 1 em caso de sucesso, 0 se o arquivo não puder ser aberto
+ */
+int abrirEventos(SaidaEventos *saida, const char *caminho);
+
+/**
+ * Função para emitir o evento de uma rodada de ataque
+ * @param saida Destino dos eventos
+ * @param idAtacante Índice (0 a N-1) do atacante
+ * @param idDefensor Índice (0 a N-1) do defensor
+ * @param corAtacante Cor do atacante
+ * @param corDefensor Cor do defensor antes da rodada
+ * @param combate Desfecho da rodada
+ */
+void emitirAtaque(SaidaEventos *saida, int idAtacante, int idDefensor, uint16_t corAtacante, uint16_t corDefensor,
+                  const ResultadoCombate *combate);
+
+/**
+ * Função para emitir o evento de uma conquista
+ * @param saida Destino dos eventos
+ * @param idAtacante Índice do território que conquistou
+ * @param idTerritorio Índice do território conquistado
+ * @param corAnterior Cor de quem perdeu o território
+ * @param corNova Cor de quem o conquistou
+ * @param tropas Tropas no território conquistado após a conquista
+ */
+void emitirConquista(SaidaEventos *saida, int idAtacante, int idTerritorio, uint16_t corAnterior, uint16_t corNova,
+                     int tropas);
+
+/**
+ * Função para preparar o acompanhamento de ataques entre dois territórios
+ * @param acompanhamento Ponteiro para a estrutura de acompanhamento
+ * @param saida Destino dos eventos (NULL desativa a emissão)
+ * @param atacante Território atacante
+ * @param defensor Território defensor
+ * @param idAtacante Índice do atacante
+ * @param idDefensor Índice do defensor
+ */
+void iniciarAcompanhamentoEventos(AcompanhamentoEventos *acompanhamento, SaidaEventos *saida,
+                                  const Territorio *atacante, const Territorio *defensor, int idAtacante, int idDefensor);
+
+/**
+ * Observador de combate que emite o evento de cada rodada e o da conquista
+ * Compatível com ObservadorCombate; o contexto é um AcompanhamentoEventos
+ */
+void emitirEventoObservado(const ResultadoCombate *combate, void *contexto);
+
+/**
+ * Função para fazer o próximo evento reler o relógio
+ * Quem pode ficar parado entre dois eventos (esperando entrada, por exemplo) a chama
+ * antes de esperar, para que o evento seguinte não herde um instante antigo
+ * @param saida Destino dos eventos
+ */
+void renovarInstanteEventos(SaidaEventos *saida);
+
+/**
+ * Função para enviar os eventos pendentes
+ * @param saida Destino dos eventos
+ * @return 1 em caso de sucesso, 0 se alguma escrita falhou
+ */
+int descarregarEventosPendentes(SaidaEventos *saida);
+
+/**
+ * Função para enviar os eventos pendentes e fechar o destino
+ * @param saida Destino dos eventos
+ * @return 1 em caso de sucesso, 0 se alguma escrita falhou
+ */
+int fecharEventos(SaidaEventos *saida);
+
+#endif /* EVENTOS_H */
@@ -0,0 +1,203 @@
+/**
+ * fronteiras.c - Implementação do grafo de fronteiras em formato CSR
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fronteiras.h"
+
+// Tamanho de uma linha do arquivo de fronteiras
+#define TAMANHO_LINHA_FRONTEIRA 128
+
+/**
+ * Função auxiliar de comparação para ordenar os vizinhos de cada linha
+ */
+static int compararVizinhos(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Função para montar o grafo a partir de uma lista de fronteiras
+ * Conta os graus, acumula os deslocamentos, espalha as pontas e depois ordena
+ * e compacta cada linha, removendo repetições
+ */
+int construirGrafo(GrafoFronteiras *grafo, int quantidade, const ParFronteira *pares, int totalPares)
+{
+    uint32_t *cursor;
+    uint32_t escrita = 0;
+
+    memset(grafo, 0, sizeof(GrafoFronteiras));
+
+    if (quantidade < 0 || totalPares < 0)
+    {
+        return 0;
+    }
+    for (int k = 0; k < totalPares; k++)
+    {
+        if (pares[k].a < 0 || pares[k].a >= quantidade || pares[k].b < 0 ||
+            pares[k].b >= quantidade || pares[k].a == pares[k].b)
+        {
+            return 0;
+        }
+    }
+
+    grafo->deslocamentos = (uint32_t *)calloc((size_t)quantidade + 1, sizeof(uint32_t));
+    grafo->vizinhos = (uint32_t *)malloc((size_t)(totalPares > 0 ? totalPares : 1) * 2 * sizeof(uint32_t));
+    cursor = (uint32_t *)malloc((size_t)(quantidade > 0 ? quantidade : 1) * sizeof(uint32_t));
+
+    if (grafo->deslocamentos == NULL || grafo->vizinhos == NULL || cursor == NULL)
+    {
+        free(cursor);
+        liberarGrafo(grafo);
+        return 0;
+    }
+
+    // Grau de cada território, depois soma acumulada: deslocamentos[i] é o início da linha i
+    for (int k = 0; k < totalPares; k++)
+    {
+        grafo->deslocamentos[pares[k].a + 1]++;
+        grafo->deslocamentos[pares[k].b + 1]++;
+    }
+    for (int i = 0; i < quantidade; i++)
+    {
+        grafo->deslocamentos[i + 1] += grafo->deslocamentos[i];
+        cursor[i] = grafo->deslocamentos[i];
+    }
+
+    for (int k = 0; k < totalPares; k++)
+    {
+        grafo->vizinhos[cursor[pares[k].a]++] = (uint32_t)pares[k].b;
+        grafo->vizinhos[cursor[pares[k].b]++] = (uint32_t)pares[k].a;
+    }
+    free(cursor);
+
+    // Ordena cada linha e a copia para a posição compactada, sem repetições
+    for (int i = 0; i < quantidade; i++)
+    {
+        uint32_t inicio = grafo->deslocamentos[i];
+        uint32_t fim = grafo->deslocamentos[i + 1];
+
+        qsort(&grafo->vizinhos[inicio], fim - inicio, sizeof(uint32_t), compararVizinhos);
+
+        grafo->deslocamentos[i] = escrita;
+        for (uint32_t j = inicio; j < fim; j++)
+        {
+            if (j == inicio || grafo->vizinhos[j] != grafo->vizinhos[j - 1])
+            {
+                grafo->vizinhos[escrita++] = grafo->vizinhos[j];
+            }
+        }
+    }
+    grafo->deslocamentos[quantidade] = escrita;
+
+    grafo->quantidade = quantidade;
+    grafo->entradas = escrita;
+    return 1;
+}
+
+/**
+ * Função para carregar as fronteiras de um arquivo texto
+ */
+int carregarFronteiras(GrafoFronteiras *grafo, const char *caminho, int quantidade)
+{
+    FILE *arquivo = fopen(caminho, "r");
+    char linha[TAMANHO_LINHA_FRONTEIRA];
+    ParFronteira *pares = NULL;
+    int total = 0, capacidade = 0;
+    int valido = 1;
+
+    memset(grafo, 0, sizeof(GrafoFronteiras));
+    if (arquivo == NULL)
+    {
+        return 0;
+    }
+
+    while (valido && fgets(linha, sizeof(linha), arquivo) != NULL)
+    {
+        char *texto = linha + strspn(linha, " \t");
+        int a, b;
+
+        if (*texto == '\0' || *texto == '\n' || *texto == '\r' || *texto == '#')
+        {
+            continue;
+        }
+
+        if (sscanf(texto, "%d %d", &a, &b) != 2 || a < 1 || a > quantidade || b < 1 || b > quantidade || a == b)
+        {
+            valido = 0;
+            break;
+        }
+
+        if (total == capacidade)
+        {
+            int novaCapacidade = capacidade > 0 ? capacidade * 2 : 64;
+            ParFronteira *novos = (ParFronteira *)realloc(pares, (size_t)novaCapacidade * sizeof(ParFronteira));
+
+            if (novos == NULL)
+            {
+                valido = 0;
+                break;
+            }
+            pares = novos;
+            capacidade = novaCapacidade;
+        }
+
+        // O arquivo numera de 1 a N, como a interface; o grafo usa índices a partir de 0
+        pares[total].a = a - 1;
+        pares[total].b = b - 1;
+        total++;
+    }
+    fclose(arquivo);
+
+    valido = valido && construirGrafo(grafo, quantidade, pares, total);
+    free(pares);
+    return valido;
+}
+
+/**
+ * Função para liberar os vetores do grafo
+ */
+void liberarGrafo(GrafoFronteiras *grafo)
+{
+    free(grafo->deslocamentos);
+    free(grafo->vizinhos);
+    memset(grafo, 0, sizeof(GrafoFronteiras));
+}
+
+/**
+ * Função para obter os vizinhos de um território
+ */
+const uint32_t *vizinhosTerritorio(const GrafoFronteiras *grafo, int territorio, int *grau)
+{
+    if (territorio < 0 || territorio >= grafo->quantidade)
+    {
+        *grau = 0;
+        return grafo->vizinhos;
+    }
+
+    *grau = (int)(grafo->deslocamentos[territorio + 1] - grafo->deslocamentos[territorio]);
+    return &grafo->vizinhos[grafo->deslocamentos[territorio]];
+}
+
+/**
+ * Função para verificar se dois territórios fazem fronteira, em O(grau)
+ */
+int saoVizinhos(const GrafoFronteiras *grafo, int a, int b)
+{
+    int grau;
+    const uint32_t *vizinhos = vizinhosTerritorio(grafo, a, &grau);
+
+    for (int k = 0; k < grau; k++)
+    {
+        if (vizinhos[k] == (uint32_t)b)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * fronteiras.h - Grafo de fronteiras entre territórios em formato CSR
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef FRONTEIRAS_H
+#define FRONTEIRAS_H
+
+#include <stdint.h>
+
+/**
+ * Fronteira entre dois territórios (índices a partir de 0)
+ */
+typedef struct
+{
+    int a;
+    int b;
+} ParFronteira;
+
+/**
+ * Grafo de fronteiras em linhas esparsas comprimidas (CSR)
+ * - deslocamentos: quantidade + 1 posições; os vizinhos do território i ocupam
+ *                  vizinhos[deslocamentos[i]] até vizinhos[deslocamentos[i + 1] - 1]
+ * - vizinhos: índices dos vizinhos, em ordem crescente e sem repetição dentro de cada linha
+ * - quantidade: quantidade de territórios cobertos pelo grafo
+ * - entradas: tamanho do vetor de vizinhos (cada fronteira aparece uma vez em cada ponta)
+ *
+ * Os vizinhos de um território ficam contíguos, então percorrê-los lê uma
+ * sequência de inteiros sem saltos de ponteiro.
+ */
+typedef struct
+{
+    uint32_t *deslocamentos;
+    uint32_t *vizinhos;
+    int quantidade;
+    uint32_t entradas;
+} GrafoFronteiras;
+
+/**
+ * Função para montar o grafo a partir de uma lista de fronteiras
+ *
+ * As fronteiras são simétricas: cada par liga os dois territórios. Pares
+ * repetidos são guardados uma única vez.
+ *
+ * @param grafo Ponteiro para o grafo a ser inicializado
+ * @param quantidade Quantidade de territórios
+ * @param pares Lista de fronteiras
+ * @param totalPares Quantidade de pares na lista
+ * @return 1 em caso de sucesso, 0 se algum par for inválido ou faltar memória
+ */
+int construirGrafo(GrafoFronteiras *grafo, int quantidade, const ParFronteira *pares, int totalPares);
+
+/**
+ * Função para carregar as fronteiras de um arquivo texto
+ *
+ * Cada linha traz dois números de território (1 a quantidade) separados por
+ * espaço; linhas vazias e linhas iniciadas por '#' são ignoradas.
+ *
+ * @param grafo Ponteiro para o grafo a ser inicializado
+ * @param caminho Caminho do arquivo
+ * @param quantidade Quantidade de territórios do mapa
+ * @return 1 em caso de sucesso, 0 se o arquivo não abrir ou tiver uma linha inválida
+ */
+int carregarFronteiras(GrafoFronteiras *grafo, const char *caminho, int quantidade);
+
+/**
+ * Função para liberar os vetores do grafo
+ * @param grafo Ponteiro para o grafo
+ */
+void liberarGrafo(GrafoFronteiras *grafo);
+
+/**
+ * Função para obter os vizinhos de um território
+ * @param grafo Ponteiro para o grafo
+ * @param territorio Índice do território
+ * @param grau Ponteiro para receber a quantidade de vizinhos
+ * @return Início da lista de vizinhos (grau 0 para territórios fora do grafo)
+ */
+const uint32_t *vizinhosTerritorio(const GrafoFronteiras *grafo, int territorio, int *grau);
+
+/**
+ * Função para verificar se dois territórios fazem fronteira, em O(grau)
+ * @param grafo Ponteiro para o grafo
+ * @param a Índice do primeiro território
+ * @param b Índice do segundo território
+ * @return 1 se fazem fronteira, 0 caso contrário
+ */
+int saoVizinhos(const GrafoFronteiras *grafo, int a, int b);
+
+#endif /* FRONTEIRAS_H */
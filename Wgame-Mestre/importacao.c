@@ -0,0 +1,323 @@
+/**
+ * importacao.c - Implementação da importação em massa de territórios
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "importacao.h"
+#include "cores.h"
+#include "nomes.h"
+
+// Posições do cache de cores de uma importação (potência de 2)
+#define CACHE_CORES_IMPORTACAO 64
+
+/**
+ * Cor já internada nesta importação, para que linhas repetidas não consultem a tabela global
+ */
+typedef struct
+{
+    char texto[TAMANHO_COR];
+    size_t comprimento;
+    int idCor;
+} CorImportada;
+
+/**
+ * Estado de uma importação em andamento
+ */
+typedef struct
+{
+    MapaSoA *mapa;
+    ResultadoImportacao *resultado;
+    CorImportada cores[CACHE_CORES_IMPORTACAO];
+} ContextoImportacao;
+
+/**
+ * Função auxiliar que descarta espaços nas pontas de um campo [inicio, fim)
+ */
+static void apararCampo(const char **inicio, const char **fim)
+{
+    while (*inicio < *fim && **inicio == ' ')
+    {
+        (*inicio)++;
+    }
+    while (*fim > *inicio && (*fim)[-1] == ' ')
+    {
+        (*fim)--;
+    }
+}
+
+/**
+ * Função auxiliar que converte o campo de tropas: só dígitos, com '+' opcional, até INT_MAX
+ * @return 1 se o campo é um número válido, 0 caso contrário
+ */
+static int converterTropas(const char *inicio, const char *fim, int *valor)
+{
+    long long total = 0;
+
+    if (inicio < fim && *inicio == '+')
+    {
+        inicio++;
+    }
+    if (inicio == fim)
+    {
+        return 0;
+    }
+
+    for (; inicio < fim; inicio++)
+    {
+        unsigned digito = (unsigned)(unsigned char)*inicio - '0';
+
+        if (digito > 9)
+        {
+            return 0;
+        }
+        total = total * 10 + digito;
+        if (total > INT_MAX)
+        {
+            return 0;
+        }
+    }
+
+    *valor = (int)total;
+    return 1;
+}
+
+/**
+ * Função auxiliar que obtém o identificador de uma cor, passando antes pelo cache local
+ * @return Identificador da cor, ou -1 se a tabela de cores estiver cheia
+ */
+static int obterCor(ContextoImportacao *contexto, const char *texto, size_t comprimento)
+{
+    CorImportada *entrada;
+    unsigned posicao;
+
+    // A tabela global trunca os nomes do mesmo jeito, então o cache usa a forma truncada
+    if (comprimento > TAMANHO_COR - 1)
+    {
+        comprimento = TAMANHO_COR - 1;
+    }
+
+    posicao = ((unsigned)comprimento * 31u + (unsigned char)texto[0] * 7u +
+               (unsigned char)texto[comprimento - 1]) & (CACHE_CORES_IMPORTACAO - 1);
+    entrada = &contexto->cores[posicao];
+
+    if (entrada->comprimento != comprimento || memcmp(entrada->texto, texto, comprimento) != 0)
+    {
+        int idCor;
+
+        memcpy(entrada->texto, texto, comprimento);
+        entrada->texto[comprimento] = '\0';
+        idCor = internarCor(entrada->texto);
+        if (idCor < 0)
+        {
+            entrada->comprimento = 0;
+            return -1;
+        }
+        entrada->comprimento = comprimento;
+        entrada->idCor = idCor;
+    }
+
+    return entrada->idCor;
+}
+
+/**
+ * Função auxiliar que anota uma linha rejeitada
+ */
+static void rejeitarLinha(ResultadoImportacao *resultado)
+{
+    resultado->rejeitadas++;
+    if (resultado->primeiraRejeitada == 0)
+    {
+        resultado->primeiraRejeitada = resultado->linhas;
+    }
+}
+
+/**
+ * Função auxiliar que interpreta uma linha [inicio, fim), sem o '\n'
+ * @return 1 se a linha foi tratada (importada, ignorada ou rejeitada), 0 se faltou memória
+ */
+static int processarLinha(ContextoImportacao *contexto, const char *inicio, const char *fim)
+{
+    ResultadoImportacao *resultado = contexto->resultado;
+    const char *nome, *fimNome, *cor, *fimCor, *tropas, *fimTropas;
+    RefNome referencia;
+    MapaSoA *mapa = contexto->mapa;
+    int idCor, valor;
+
+    resultado->linhas++;
+    if (fim > inicio && fim[-1] == '\r')
+    {
+        fim--;
+    }
+
+    if (resultado->linhas == 1)
+    {
+        resultado->separador = memchr(inicio, '\t', (size_t)(fim - inicio)) != NULL ? '\t' : ',';
+    }
+
+    apararCampo(&inicio, &fim);
+    if (inicio == fim || *inicio == '#')
+    {
+        return 1;
+    }
+
+    // Separa os três campos direto no buffer
+    nome = inicio;
+    fimNome = (const char *)memchr(nome, resultado->separador, (size_t)(fim - nome));
+    if (fimNome == NULL)
+    {
+        rejeitarLinha(resultado);
+        return 1;
+    }
+    cor = fimNome + 1;
+    fimCor = (const char *)memchr(cor, resultado->separador, (size_t)(fim - cor));
+    if (fimCor == NULL)
+    {
+        rejeitarLinha(resultado);
+        return 1;
+    }
+    tropas = fimCor + 1;
+    fimTropas = fim;
+
+    apararCampo(&nome, &fimNome);
+    apararCampo(&cor, &fimCor);
+    apararCampo(&tropas, &fimTropas);
+
+    if (!converterTropas(tropas, fimTropas, &valor))
+    {
+        // Na primeira linha, tropas não numéricas indicam o cabeçalho
+        if (resultado->linhas > 1)
+        {
+            rejeitarLinha(resultado);
+        }
+        return 1;
+    }
+
+    if (nome == fimNome || cor == fimCor || (idCor = obterCor(contexto, cor, (size_t)(fimCor - cor))) < 0)
+    {
+        rejeitarLinha(resultado);
+        return 1;
+    }
+
+    if (!guardarNomeArena(arenaNomesPadrao(), nome, (size_t)(fimNome - nome), &referencia) ||
+        !crescerMapa(mapa, 1))
+    {
+        return 0;
+    }
+
+    mapa->nomes[mapa->quantidade - 1] = referencia;
+    mapa->donos[mapa->quantidade - 1] = (uint16_t)idCor;
+    mapa->tropas[mapa->quantidade - 1] = valor;
+    resultado->importadas++;
+    return 1;
+}
+
+/**
+ * Função para importar territórios de um arquivo CSV/TSV
+ * Uma linha maior que o buffer é rejeitada e descartada até o próximo '\n'
+ */
+int importarTerritorios(const char *caminho, MapaSoA *mapa, ResultadoImportacao *resultado)
+{
+    ContextoImportacao contexto;
+    struct stat informacoes;
+    char *buffer;
+    size_t usado = 0;
+    int descartando = 0, sucesso = 1;
+    int arquivo = open(caminho, O_RDONLY);
+
+    memset(resultado, 0, sizeof(ResultadoImportacao));
+    resultado->separador = ',';
+    if (arquivo < 0)
+    {
+        return 0;
+    }
+
+    buffer = (char *)malloc(BUFFER_IMPORTACAO);
+    if (buffer == NULL)
+    {
+        close(arquivo);
+        return 0;
+    }
+
+    memset(&contexto, 0, sizeof(contexto));
+    contexto.mapa = mapa;
+    contexto.resultado = resultado;
+
+    // Os nomes somados nunca passam do tamanho do arquivo: uma reserva evita as dobras da arena
+    if (fstat(arquivo, &informacoes) == 0 && informacoes.st_size > 0)
+    {
+        reservarArenaNomes(arenaNomesPadrao(), (size_t)informacoes.st_size);
+    }
+
+    while (sucesso)
+    {
+        ssize_t lidos = read(arquivo, buffer + usado, BUFFER_IMPORTACAO - usado);
+        const char *inicio = buffer, *limite, *fimLinha;
+
+        if (lidos < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            sucesso = 0;
+            break;
+        }
+
+        resultado->bytes += (size_t)lidos;
+        usado += (size_t)lidos;
+        limite = buffer + usado;
+
+        while (sucesso && (fimLinha = (const char *)memchr(inicio, '\n', (size_t)(limite - inicio))) != NULL)
+        {
+            // Restante de uma linha longa demais, já contada como rejeitada
+            if (descartando)
+            {
+                descartando = 0;
+            }
+            else
+            {
+                sucesso = processarLinha(&contexto, inicio, fimLinha);
+            }
+            inicio = fimLinha + 1;
+        }
+
+        if (lidos == 0)
+        {
+            // Última linha sem '\n'
+            if (sucesso && !descartando && inicio < limite)
+            {
+                sucesso = processarLinha(&contexto, inicio, limite);
+            }
+            break;
+        }
+
+        usado = (size_t)(limite - inicio);
+        if (usado == BUFFER_IMPORTACAO)
+        {
+            if (!descartando)
+            {
+                resultado->linhas++;
+                rejeitarLinha(resultado);
+                descartando = 1;
+            }
+            usado = 0;
+        }
+        else
+        {
+            memmove(buffer, inicio, usado);
+        }
+    }
+
+    free(buffer);
+    close(arquivo);
+    return sucesso;
+}
@@ -0,0 +1,64 @@
+/**
+ * importacao.h - Importação em massa de territórios a partir de CSV/TSV
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef IMPORTACAO_H
+#define IMPORTACAO_H
+
+#include <stddef.h>
+#include "mapa.h"
+
+/**
+ * Formato aceito: uma linha por território com nome, cor e tropas.
+ *
+ *   nome,cor,tropas        (CSV)
+ *   nome<TAB>cor<TAB>tropas (TSV)
+ *
+ * O separador é detectado na primeira linha: tabulação, se houver alguma, ou
+ * vírgula. Não há aspas; nomes com vírgula devem vir em TSV. Espaços nas pontas
+ * de cada campo e o '\r' de arquivos do Windows são descartados. Uma primeira
+ * linha cujo campo de tropas não é numérico é tratada como cabeçalho, e linhas
+ * vazias ou iniciadas por '#' são ignoradas.
+ */
+
+// Tamanho do bloco lido do arquivo a cada chamada de read
+#define BUFFER_IMPORTACAO (1 << 20)
+
+/**
+ * Resultado de uma importação
+ * - linhas: linhas lidas, incluindo cabeçalho, comentários e rejeitadas
+ * - importadas: territórios acrescentados ao mapa
+ * - rejeitadas: linhas com campos faltando, nome vazio, tropas inválidas ou
+ *   cor nova com a tabela de cores cheia
+ * - primeiraRejeitada: número (a partir de 1) da primeira linha rejeitada, ou 0
+ * - bytes: tamanho lido do arquivo
+ * - separador: ',' ou '\t'
+ */
+typedef struct
+{
+    long long linhas;
+    long long importadas;
+    long long rejeitadas;
+    long long primeiraRejeitada;
+    size_t bytes;
+    char separador;
+} ResultadoImportacao;
+
+/**
+ * Função para importar territórios de um arquivo CSV/TSV
+ *
+ * Lê o arquivo em blocos de BUFFER_IMPORTACAO bytes e separa os campos direto
+ * no buffer, sem scanf nem cópia por linha. Os nomes vão para a arena padrão
+ * (reservada de uma vez pelo tamanho do arquivo) e as cores são internadas à
+ * medida que aparecem. Linhas inválidas são contadas e puladas.
+ *
+ * @param caminho Caminho do arquivo
+ * @param mapa Mapa já iniciado; os territórios são acrescentados ao final
+ * @param resultado Ponteiro para receber as contagens
+ * @return 1 se o arquivo foi lido até o fim, 0 se não abriu, falhou na leitura
+ *         ou faltou memória (o que já foi importado permanece no mapa)
+ */
+int importarTerritorios(const char *caminho, MapaSoA *mapa, ResultadoImportacao *resultado);
+
+#endif /* IMPORTACAO_H */
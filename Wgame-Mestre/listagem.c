@@ -0,0 +1,259 @@
+/**
+ * listagem.c - Implementação da listagem de territórios com buffer de saída
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include "listagem.h"
+#include "cores.h"
+#include "nomes.h"
+
+/**
+ * Buffer de saída, reutilizado por todas as listagens (a listagem é feita só pela thread principal)
+ */
+typedef struct
+{
+    char dados[BUFFER_LISTAGEM];
+    size_t usado;
+    int falhou;
+} SaidaListagem;
+
+static SaidaListagem saida;
+
+static const char cabecalhoCompleto[] =
+    "\n===================================\n"
+    "     TERRITORIOS CADASTRADOS      \n"
+    "===================================\n\n";
+
+static const char separadorCompleto[] = "----------------------------------\n\n";
+
+/**
+ * Função auxiliar que envia o conteúdo do buffer com write, repetindo em escritas parciais
+ */
+static void descarregarSaida(void)
+{
+    size_t enviado = 0;
+
+    while (enviado < saida.usado && !saida.falhou)
+    {
+        ssize_t escritos = write(STDOUT_FILENO, saida.dados + enviado, saida.usado - enviado);
+
+        if (escritos < 0)
+        {
+            if (errno != EINTR)
+            {
+                saida.falhou = 1;
+            }
+            continue;
+        }
+        enviado += (size_t)escritos;
+    }
+    saida.usado = 0;
+}
+
+/**
+ * Função auxiliar que acrescenta bytes ao buffer, descarregando-o quando enche
+ */
+static void acrescentarBytes(const char *texto, size_t comprimento)
+{
+    while (comprimento > 0)
+    {
+        size_t livre = BUFFER_LISTAGEM - saida.usado;
+        size_t parte = comprimento < livre ? comprimento : livre;
+
+        memcpy(saida.dados + saida.usado, texto, parte);
+        saida.usado += parte;
+        texto += parte;
+        comprimento -= parte;
+        if (saida.usado == BUFFER_LISTAGEM)
+        {
+            descarregarSaida();
+        }
+    }
+}
+
+/**
+ * Função auxiliar que acrescenta um texto terminado em '\0'
+ */
+static void acrescentarTexto(const char *texto)
+{
+    acrescentarBytes(texto, strlen(texto));
+}
+
+/**
+ * Função auxiliar que acrescenta um inteiro em decimal, alinhado à direita em 'largura' colunas
+ */
+static void acrescentarInteiro(long long valor, int largura)
+{
+    char digitos[24];
+    int posicao = (int)sizeof(digitos);
+    unsigned long long absoluto = valor < 0 ? 0ULL - (unsigned long long)valor : (unsigned long long)valor;
+
+    do
+    {
+        digitos[--posicao] = (char)('0' + absoluto % 10);
+        absoluto /= 10;
+    } while (absoluto > 0);
+    if (valor < 0)
+    {
+        digitos[--posicao] = '-';
+    }
+
+    while (largura-- > (int)sizeof(digitos) - posicao)
+    {
+        acrescentarBytes(" ", 1);
+    }
+    acrescentarBytes(digitos + posicao, sizeof(digitos) - (size_t)posicao);
+}
+
+/**
+ * Função auxiliar que acrescenta um texto completado com espaços até 'largura' colunas
+ */
+static void acrescentarAlinhado(const char *texto, int largura)
+{
+    size_t comprimento = strlen(texto);
+
+    acrescentarBytes(texto, comprimento);
+    while (largura-- > (int)comprimento)
+    {
+        acrescentarBytes(" ", 1);
+    }
+}
+
+/**
+ * Função auxiliar que formata um território no formato de exibirTerritorio
+ */
+static void formatarCompleto(const MapaSoA *mapa, int indice)
+{
+    acrescentarTexto("Territorio ");
+    acrescentarInteiro(indice + 1, 0);
+    acrescentarTexto(": ");
+    acrescentarBytes(textoNome(mapa->nomes[indice]), mapa->nomes[indice].comprimento);
+    acrescentarTexto("\n  Cor do exercito: ");
+    acrescentarTexto(nomeCor(mapa->donos[indice]));
+    acrescentarTexto("\n  Tropas: ");
+    acrescentarInteiro(mapa->tropas[indice], 0);
+    acrescentarTexto("\n");
+    acrescentarBytes(separadorCompleto, sizeof(separadorCompleto) - 1);
+}
+
+/**
+ * Função auxiliar que formata um território numa linha: número, cor, tropas e nome
+ */
+static void formatarCompacto(const MapaSoA *mapa, int indice)
+{
+    acrescentarInteiro(indice + 1, 9);
+    acrescentarTexto("  ");
+    acrescentarAlinhado(nomeCor(mapa->donos[indice]), TAMANHO_COR - 1);
+    acrescentarInteiro(mapa->tropas[indice], 11);
+    acrescentarTexto("  ");
+    acrescentarBytes(textoNome(mapa->nomes[indice]), mapa->nomes[indice].comprimento);
+    acrescentarTexto("\n");
+}
+
+/**
+ * Função auxiliar que verifica se um território atende ao filtro
+ */
+static int atendeFiltro(const MapaSoA *mapa, int indice, const FiltroListagem *filtro)
+{
+    return (filtro->idCor < 0 || mapa->donos[indice] == filtro->idCor) &&
+           mapa->tropas[indice] >= filtro->tropasMinimas && mapa->tropas[indice] <= filtro->tropasMaximas;
+}
+
+/**
+ * Função para preencher um filtro que aceita todos os territórios, no formato completo
+ */
+void iniciarFiltroListagem(FiltroListagem *filtro)
+{
+    filtro->pular = 0;
+    filtro->limite = 0;
+    filtro->idCor = -1;
+    filtro->tropasMinimas = INT_MIN;
+    filtro->tropasMaximas = INT_MAX;
+    filtro->compacto = 0;
+}
+
+/**
+ * Função para listar os territórios que atendem a um filtro
+ * O mapa é percorrido inteiro para contar os correspondentes, mas só a página pedida é formatada
+ */
+int renderizarTerritorios(const MapaSoA *mapa, const FiltroListagem *filtro, ResumoListagem *resumo)
+{
+    int correspondentes = 0, exibidos = 0;
+    int filtrado = filtro->idCor >= 0 || filtro->tropasMinimas != INT_MIN || filtro->tropasMaximas != INT_MAX;
+
+    // O que o printf ainda guarda precisa sair antes do que vai direto para o descritor
+    fflush(stdout);
+    saida.usado = 0;
+    saida.falhou = 0;
+
+    if (filtro->compacto)
+    {
+        acrescentarTexto("\n   Numero  Cor           Tropas  Nome\n");
+    }
+    else
+    {
+        acrescentarBytes(cabecalhoCompleto, sizeof(cabecalhoCompleto) - 1);
+    }
+
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        if (!atendeFiltro(mapa, i, filtro))
+        {
+            continue;
+        }
+
+        if (correspondentes++ < filtro->pular || (filtro->limite > 0 && exibidos >= filtro->limite))
+        {
+            continue;
+        }
+
+        if (filtro->compacto)
+        {
+            formatarCompacto(mapa, i);
+        }
+        else
+        {
+            formatarCompleto(mapa, i);
+        }
+        exibidos++;
+    }
+
+    // A listagem completa sem filtro mantém o formato de sempre, sem rodapé
+    if (filtrado || filtro->pular > 0 || filtro->limite > 0 || filtro->compacto)
+    {
+        if (filtro->compacto)
+        {
+            acrescentarTexto("\n");
+        }
+        acrescentarTexto("Exibidos ");
+        acrescentarInteiro(exibidos, 0);
+        acrescentarTexto(" de ");
+        acrescentarInteiro(correspondentes, 0);
+        acrescentarTexto(filtrado ? " territorios que atendem ao filtro" : " territorios");
+        if (exibidos > 0)
+        {
+            acrescentarTexto(" (");
+            acrescentarInteiro(filtro->pular + 1, 0);
+            acrescentarTexto(" a ");
+            acrescentarInteiro((long long)filtro->pular + exibidos, 0);
+            acrescentarTexto(")");
+        }
+        acrescentarTexto("\n\n");
+    }
+
+    descarregarSaida();
+
+    if (resumo != NULL)
+    {
+        resumo->correspondentes = correspondentes;
+        resumo->exibidos = exibidos;
+    }
+    return !saida.falhou;
+}
@@ -0,0 +1,68 @@
+/**
+ * listagem.h - Listagem de territórios com buffer de saída, páginas e filtros
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef LISTAGEM_H
+#define LISTAGEM_H
+
+#include "mapa.h"
+
+// Tamanho do buffer de saída reutilizado entre listagens (um write por buffer cheio)
+#define BUFFER_LISTAGEM (1 << 20)
+
+/**
+ * Critérios de uma listagem
+ * - pular: territórios que atendem ao filtro a pular antes do primeiro exibido
+ *   (página * tamanho da página)
+ * - limite: máximo de territórios exibidos; 0 exibe todos a partir de 'pular'
+ * - idCor: só territórios desta cor; -1 aceita qualquer cor
+ * - tropasMinimas/tropasMaximas: faixa de tropas aceita, inclusive
+ * - compacto: diferente de zero para uma linha por território
+ */
+typedef struct
+{
+    int pular;
+    int limite;
+    int idCor;
+    int tropasMinimas;
+    int tropasMaximas;
+    int compacto;
+} FiltroListagem;
+
+/**
+ * Resumo de uma listagem
+ * - correspondentes: territórios que atendem ao filtro, em todo o mapa
+ * - exibidos: territórios efetivamente escritos (depois de 'pular' e 'limite')
+ */
+typedef struct
+{
+    int correspondentes;
+    int exibidos;
+} ResumoListagem;
+
+/**
+ * Função para preencher um filtro que aceita todos os territórios, no formato completo
+ * @param filtro Ponteiro para o filtro
+ */
+void iniciarFiltroListagem(FiltroListagem *filtro);
+
+/**
+ * Função para listar os territórios que atendem a um filtro
+ *
+ * Monta o texto num buffer de BUFFER_LISTAGEM bytes, com conversão de inteiros
+ * própria em vez de printf, e o envia à saída padrão com write: uma única
+ * chamada por página, ou uma por buffer cheio numa listagem muito longa. O
+ * formato completo é o mesmo de exibirTerritorio. Com filtro ou página, um
+ * rodapé informa quantos territórios correspondem e quais foram exibidos. O
+ * filtro lê só os vetores de tropas e donos; os nomes são consultados apenas
+ * para os territórios exibidos.
+ *
+ * @param mapa Mapa de territórios
+ * @param filtro Critérios da listagem
+ * @param resumo Recebe as contagens (pode ser NULL)
+ * @return 1 em caso de sucesso, 0 se a escrita falhar
+ */
+int renderizarTerritorios(const MapaSoA *mapa, const FiltroListagem *filtro, ResumoListagem *resumo);
+
+#endif /* LISTAGEM_H */
@@ -11,61 +11,1508 @@
  * Data: 15/08/2025
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
 #include "territorio.h"
 #include "alocacao.h"
 #include "combate.h"
+#include "aleatorio.h"
+#include "montecarlo.h"
+#include "probabilidades.h"
+#include "registro.h"
+#include "partida.h"
+#include "torneio.h"
+#include "mapa.h"
+#include "cores.h"
+#include "nomes.h"
+#include "fronteiras.h"
+#include "arquivomapa.h"
+#include "importacao.h"
+#include "salvamento.h"
+#include "listagem.h"
+#include "eventos.h"
+#include "comandos.h"
+
+/**
+ * Função auxiliar para medir tempo decorrido em segundos (relógio monotônico)
+ */
+static double segundosDecorridos(void)
+{
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return agora.tv_sec + agora.tv_nsec / 1e9;
+}
+
+/**
+ * Modo --montecarlo: estima a probabilidade de conquista sem nenhuma interação
+ */
+static int executarModoMonteCarlo(ConfiguracaoMonteCarlo *configuracao)
+{
+    EstatisticasMonteCarlo estatisticas;
+    double inicio, duracao;
+    int threads;
+
+    if (configuracao->tropasAtacante <= 0 || configuracao->tropasDefensor <= 0 || configuracao->tentativas <= 0)
+    {
+        printf("Parametros invalidos! Use: --montecarlo <tropas atacante> <tropas defensor>\n");
+        return 1;
+    }
+
+    inicio = segundosDecorridos();
+    threads = executarMonteCarlo(configuracao, &estatisticas);
+    duracao = segundosDecorridos() - inicio;
+
+    if (threads == 0)
+    {
+        printf("Erro na alocacao de memoria!\n");
+        return 1;
+    }
+
+    exibirMonteCarlo(configuracao, &estatisticas);
+    printf("Semente: %llu | Threads: %d | Dados em lote: %s | Tempo: %.3f s (%.0f batalhas/s)\n",
+           (unsigned long long)configuracao->semente, threads, implementacaoLote(), duracao,
+           duracao > 0 ? estatisticas.tentativas / duracao : 0.0);
+
+    return 0;
+}
+
+/**
+ * Modo --conferir-lote: compara as versões do lançamento em lote e mede a vazão de cada caminho
+ */
+static int executarModoConferirLote(long long quantidade, uint64_t semente)
+{
+    GeradorLote lote;
+    GeradorAleatorio gerador;
+    uint8_t *facesLote;
+    int *faces;
+    double inicio, tempoLote, tempoEscalar;
+    int versoes, iguais;
+
+    if (quantidade <= 0)
+    {
+        printf("Quantidade invalida! Use: --conferir-lote <faces>\n");
+        return 1;
+    }
+
+    facesLote = (uint8_t *)malloc((size_t)quantidade);
+    faces = (int *)malloc((size_t)quantidade * sizeof(int));
+    if (facesLote == NULL || faces == NULL)
+    {
+        printf("Erro na alocacao de memoria!\n");
+        free(facesLote);
+        free(faces);
+        return 1;
+    }
+
+    iguais = conferirVersoesLote(semente, (size_t)quantidade, &versoes);
+    printf("Versoes comparadas: %d (em uso: %s) | %lld faces: %s\n", versoes, implementacaoLote(), quantidade,
+           iguais ? "identicas" : "DIVERGENTES");
+
+    inicializarGeradorLote(&lote, semente, 0);
+    inicio = segundosDecorridos();
+    lancarFacesLote(&lote, facesLote, (size_t)quantidade);
+    tempoLote = segundosDecorridos() - inicio;
+
+    inicializarGerador(&gerador, semente);
+    inicio = segundosDecorridos();
+    lancarFaces(&gerador, faces, (int)(quantidade < INT_MAX ? quantidade : INT_MAX));
+    tempoEscalar = segundosDecorridos() - inicio;
+
+    printf("lancarFacesLote: %.0f milhoes de faces/s | lancarFaces: %.0f milhoes de faces/s\n",
+           tempoLote > 0 ? quantidade / tempoLote / 1e6 : 0.0, tempoEscalar > 0 ? quantidade / tempoEscalar / 1e6 : 0.0);
+
+    free(facesLote);
+    free(faces);
+    return iguais ? 0 : 2;
+}
+
+/**
+ * Modo --exato: calcula o desfecho exato da batalha pela cadeia de Markov
+ */
+static int executarModoExato(int tropasAtacante, int tropasDefensor, int tropasMinimas)
+{
+    SolucionadorBatalha solucionador;
+    ResultadoExato resultado;
+    double inicio, duracao;
+    int sucesso;
+
+    inicializarSolucionador(&solucionador, tropasMinimas);
+
+    inicio = segundosDecorridos();
+    sucesso = resolverBatalhaExata(&solucionador, tropasAtacante, tropasDefensor, &resultado);
+    duracao = segundosDecorridos() - inicio;
+
+    if (!sucesso)
+    {
+        printf("Parametros invalidos! Use: --exato <tropas atacante> <tropas defensor>\n");
+        liberarSolucionador(&solucionador);
+        return 1;
+    }
+
+    exibirBatalhaExata(tropasAtacante, tropasDefensor, solucionador.tropasMinimas, &resultado);
+    printf("Tempo: %.1f us (%d x %d estados memorizados)\n", duracao * 1e6,
+           solucionador.maximoAtacante, solucionador.maximoDefensor);
+
+    liberarSolucionador(&solucionador);
+    return 0;
+}
+
+/**
+ * Função auxiliar para ler uma lista de estratégias separadas por vírgula
+ * @return 1 se todos os nomes são válidos, 0 caso contrário
+ */
+static int lerListaEstrategias(const char *lista, ConfiguracaoPartida *configuracao)
+{
+    char copia[128];
+    char *nome;
+    int jogador = 0;
+
+    strncpy(copia, lista, sizeof(copia) - 1);
+    copia[sizeof(copia) - 1] = '\0';
+
+    for (nome = strtok(copia, ","); nome != NULL && jogador < MAX_JOGADORES; nome = strtok(NULL, ","))
+    {
+        if (!lerEstrategia(nome, &configuracao->estrategias[jogador++]))
+        {
+            return 0;
+        }
+    }
+
+    // Jogadores sem estratégia explícita repetem a lista desde o início
+    for (int j = jogador; j < MAX_JOGADORES && jogador > 0; j++)
+    {
+        configuracao->estrategias[j] = configuracao->estrategias[j % jogador];
+    }
+
+    return 1;
+}
+
+/**
+ * Modo --autoplay: joga partidas completas entre jogadores automáticos
+ */
+static int executarModoAutoplay(ConfiguracaoPartida *configuracao, int partidas)
+{
+    ResultadoPartida resultado;
+    long long vitorias[MAX_JOGADORES] = {0};
+    long long empates = 0, ataques = 0, turnos = 0;
+    uint64_t semente = configuracao->semente;
+    double inicio, duracao;
+    FILE *relatorio = stdout;
+
+    if (partidas <= 0)
+    {
+        printf("Quantidade de partidas invalida!\n");
+        return 1;
+    }
+
+    // Com os eventos na saída padrão, o relatório vai para a saída de erro e não se mistura ao NDJSON
+    if (configuracao->eventos != NULL && configuracao->eventos->descritor == STDOUT_FILENO)
+    {
+        relatorio = stderr;
+    }
+
+    inicio = segundosDecorridos();
+    for (int p = 0; p < partidas; p++)
+    {
+        configuracao->semente = derivarSemente(semente, (uint64_t)p);
+        if (configuracao->eventos != NULL)
+        {
+            configuracao->eventos->partida = p;
+        }
+
+        if (!jogarPartida(configuracao, &resultado))
+        {
+            fprintf(relatorio, "Parametros invalidos! Verifique --territorios, --jogadores e --tropas.\n");
+            return 1;
+        }
+
+        turnos += resultado.turnos;
+        ataques += resultado.ataques;
+        if (resultado.vencedor >= 0)
+        {
+            vitorias[resultado.vencedor]++;
+        }
+        else
+        {
+            empates++;
+        }
+    }
+    duracao = segundosDecorridos() - inicio;
+
+    fprintf(relatorio, "\n===================================\n");
+    fprintf(relatorio, "       PARTIDAS AUTOMATICAS       \n");
+    fprintf(relatorio, "===================================\n");
+    fprintf(relatorio, "Mapa: %d territorios | Jogadores: %d | Tropas iniciais: %d\n",
+            configuracao->territorios, configuracao->jogadores, configuracao->tropasIniciais);
+    fprintf(relatorio, "Partidas: %d | Semente: %llu\n\n", partidas, (unsigned long long)semente);
+
+    for (int j = 0; j < configuracao->jogadores; j++)
+    {
+        fprintf(relatorio, "  %-9s (%-9s): %lld vitorias\n", corJogador(j),
+               nomeEstrategia(configuracao->estrategias[j]), vitorias[j]);
+    }
+    fprintf(relatorio, "  Limite de %d turnos atingido: %lld partidas\n\n", configuracao->maxTurnos, empates);
+
+    fprintf(relatorio, "Duracao media: %.1f turnos, %.1f ataques por partida\n",
+            (double)turnos / partidas, (double)ataques / partidas);
+    fprintf(relatorio, "Tempo: %.3f s | %.1f partidas/s | %.0f ataques/s\n", duracao,
+            duracao > 0 ? partidas / duracao : 0.0, duracao > 0 ? ataques / duracao : 0.0);
+    if (configuracao->eventos != NULL)
+    {
+        fprintf(relatorio, "Eventos emitidos: %llu\n", (unsigned long long)configuracao->eventos->eventos);
+    }
+    fprintf(relatorio, "===================================\n\n");
+
+    return 0;
+}
+
+/**
+ * Modo --torneio: distribui partidas com sementes, mapas e confrontos variados entre as threads
+ */
+static int executarModoTorneio(ConfiguracaoTorneio *configuracao)
+{
+    ResultadoTorneio resultado;
+    double inicio, duracao;
+
+    if (configuracao->territoriosMaximo == 0)
+    {
+        configuracao->territoriosMaximo = configuracao->territoriosMinimo * 2;
+    }
+
+    inicio = segundosDecorridos();
+    if (!executarTorneio(configuracao, &resultado))
+    {
+        printf("Parametros invalidos! Verifique a quantidade de partidas e --territorios/--territorios-max.\n");
+        return 1;
+    }
+    duracao = segundosDecorridos() - inicio;
+
+    exibirTorneio(configuracao, &resultado, duracao);
+    return 0;
+}
+
+/**
+ * Função registrada com atexit por --estatisticas: relatório de memória ao fim de qualquer modo
+ */
+static void exibirEstatisticasAoSair(void)
+{
+    EstatisticasAlocacao dados;
+
+    obterEstatisticasAlocacao(&dados);
+    exibirEstatisticasAlocacao(&dados);
+}
+
+// Tamanho máximo do caminho digitado ao salvar o mapa ou o jogo
+#define TAMANHO_CAMINHO_ARQUIVO 256
+
+/**
+ * Listagem antes de cada escolha: mapas com até LIMITE_LISTAGEM_COMPLETA territórios
+ * aparecem inteiros; os maiores, só a primeira página no formato compacto
+ */
+#define LIMITE_LISTAGEM_COMPLETA 100
+#define PAGINA_LISTAGEM 50
+
+// Passadas de cada varredura medida no modo --varredura
+#define PASSADAS_VARREDURA 20
+
+/**
+ * Modo --varredura: compara varreduras de tropas e donos no vetor de Territorio e no MapaSoA
+ */
+static int executarModoVarredura(int quantidade, int threads, uint64_t semente)
+{
+    MapaSoA mapaSoA;
+    MapaQuente mapaQuente;
+    Territorio *mapa;
+    TipoAlocacao tipoAlocacao;
+    GeradorAleatorio gerador;
+    long long somaAoS = 0, somaSoA = 0, somaQuente = 0, tropasDono = 0;
+    int contagemAoS = 0, contagemSoA = 0, contagemQuente = 0;
+    double inicio, tempoAlocacao, tempoToque, tempoSomaAoS, tempoSomaSoA, tempoSomaQuente;
+    double tempoDonoAoS, tempoDonoSoA, tempoDonoQuente;
+    int threadsToque;
+
+    if (quantidade <= 0)
+    {
+        printf("Quantidade de territorios invalida!\n");
+        return 1;
+    }
+
+    inicio = segundosDecorridos();
+    mapa = alocarTerritorios(quantidade, &tipoAlocacao);
+    if (mapa == NULL || !iniciarMapa(&mapaSoA, quantidade) || !crescerMapa(&mapaSoA, quantidade))
+    {
+        printf("Erro ao alocar memoria para %d territorios!\n", quantidade);
+        liberarMapa(&mapaSoA);
+        liberarMemoria(mapa);
+        return 1;
+    }
+    if (!criarMapaQuente(&mapaQuente, quantidade, NULL))
+    {
+        printf("Erro ao alocar memoria para %d territorios!\n", quantidade);
+        liberarMapa(&mapaSoA);
+        liberarMemoria(mapa);
+        return 1;
+    }
+    tempoAlocacao = segundosDecorridos() - inicio;
+
+    // Primeiro toque em paralelo: as faltas de página saem do laço de preenchimento, que é serial
+    inicio = segundosDecorridos();
+    threadsToque = tocarPaginas(mapa, (size_t)quantidade * sizeof(Territorio), threads);
+    tocarPaginas(mapaSoA.tropas, (size_t)quantidade * sizeof(int32_t), threads);
+    tocarPaginas(mapaSoA.donos, (size_t)quantidade * sizeof(uint16_t), threads);
+    tocarPaginas(mapaSoA.nomes, (size_t)quantidade * sizeof(RefNome), threads);
+    tocarPaginas(mapaQuente.quentes, (size_t)quantidade * sizeof(TerritorioQuente), threads);
+    tocarPaginas(mapaQuente.nomes, (size_t)quantidade * sizeof(RefNome), threads);
+    tempoToque = segundosDecorridos() - inicio;
+
+    // Os dois formatos recebem exatamente os mesmos territórios; os nomes cabem numa única reserva
+    reservarArenaNomes(arenaNomesPadrao(), (size_t)quantidade * sizeof("T2147483647"));
+    inicializarGerador(&gerador, semente);
+    for (int i = 0; i < quantidade; i++)
+    {
+        char nome[sizeof("T2147483647")];
+
+        snprintf(nome, sizeof(nome), "T%d", i + 1);
+        mapa[i].nome = internarNome(nome);
+        mapa[i].idCor = (uint16_t)sortearIntervalo(&gerador, MAX_JOGADORES);
+        mapa[i].tropas = 1 + (int)sortearIntervalo(&gerador, 1000);
+        guardarTerritorioMapa(&mapaSoA, i, &mapa[i]);
+        guardarTerritorioQuente(&mapaQuente, i, &mapa[i]);
+    }
+
+    inicio = segundosDecorridos();
+    for (int passada = 0; passada < PASSADAS_VARREDURA; passada++)
+    {
+        somaAoS = 0;
+        for (int i = 0; i < quantidade; i++)
+        {
+            somaAoS += mapa[i].tropas;
+        }
+    }
+    tempoSomaAoS = (segundosDecorridos() - inicio) / PASSADAS_VARREDURA;
+
+    inicio = segundosDecorridos();
+    for (int passada = 0; passada < PASSADAS_VARREDURA; passada++)
+    {
+        somaSoA = somarTropasMapa(&mapaSoA);
+    }
+    tempoSomaSoA = (segundosDecorridos() - inicio) / PASSADAS_VARREDURA;
+
+    inicio = segundosDecorridos();
+    for (int passada = 0; passada < PASSADAS_VARREDURA; passada++)
+    {
+        somaQuente = somarTropasQuente(&mapaQuente);
+    }
+    tempoSomaQuente = (segundosDecorridos() - inicio) / PASSADAS_VARREDURA;
+
+    inicio = segundosDecorridos();
+    for (int passada = 0; passada < PASSADAS_VARREDURA; passada++)
+    {
+        contagemAoS = 0;
+        for (int i = 0; i < quantidade; i++)
+        {
+            contagemAoS += mapa[i].idCor == 0;
+        }
+    }
+    tempoDonoAoS = (segundosDecorridos() - inicio) / PASSADAS_VARREDURA;
+
+    inicio = segundosDecorridos();
+    for (int passada = 0; passada < PASSADAS_VARREDURA; passada++)
+    {
+        contagemSoA = contarTerritoriosDono(&mapaSoA, 0, &tropasDono);
+    }
+    tempoDonoSoA = (segundosDecorridos() - inicio) / PASSADAS_VARREDURA;
+
+    inicio = segundosDecorridos();
+    for (int passada = 0; passada < PASSADAS_VARREDURA; passada++)
+    {
+        contagemQuente = contarTerritoriosDonoQuente(&mapaQuente, 0, NULL);
+    }
+    tempoDonoQuente = (segundosDecorridos() - inicio) / PASSADAS_VARREDURA;
+
+    printf("\n===================================\n");
+    printf("     VARREDURA DO MAPA (%d)\n", quantidade);
+    printf("===================================\n");
+    printf("Alocacao: %8.3f ms | primeiro toque: %8.3f ms (%d threads)\n",
+           tempoAlocacao * 1e3, tempoToque * 1e3, threadsToque);
+    printf("Soma das tropas:   Territorio %8.3f ms | SoA %8.3f ms (%.2f GB/s) | Quente %8.3f ms%s\n",
+           tempoSomaAoS * 1e3, tempoSomaSoA * 1e3,
+           tempoSomaSoA > 0 ? quantidade * sizeof(int32_t) / tempoSomaSoA / 1e9 : 0.0,
+           tempoSomaQuente * 1e3,
+           somaAoS == somaSoA && somaAoS == somaQuente ? "" : " DIVERGENTE");
+    printf("Territorios de %s: Territorio %8.3f ms | SoA %8.3f ms (%.2f GB/s) | Quente %8.3f ms%s\n", corJogador(0),
+           tempoDonoAoS * 1e3, tempoDonoSoA * 1e3,
+           tempoDonoSoA > 0 ? quantidade * (sizeof(int32_t) + sizeof(uint16_t)) / tempoDonoSoA / 1e9 : 0.0,
+           tempoDonoQuente * 1e3,
+           contagemAoS == contagemSoA && contagemAoS == contagemQuente ? "" : " DIVERGENTE");
+    printf("Memoria: Territorio %zu bytes/territorio | SoA %zu bytes nos vetores varridos | Quente %zu bytes/territorio\n",
+           sizeof(Territorio), sizeof(int32_t) + sizeof(uint16_t), sizeof(TerritorioQuente));
+    printf("===================================\n\n");
+
+    liberarMapaQuente(&mapaQuente);
+    liberarMemoria(mapa);
+    liberarMapa(&mapaSoA);
+
+    return (somaAoS == somaSoA && somaAoS == somaQuente &&
+            contagemAoS == contagemSoA && contagemAoS == contagemQuente) ? 0 : 1;
+}
+
+/**
+ * Modo --gerar-mapa: grava um mapa .wmap aleatório com fronteiras em grade
+ * Cada território faz fronteira com os vizinhos à direita e abaixo numa grade quase quadrada
+ */
+static int executarModoGerarMapa(int quantidade, const char *caminho, uint64_t semente)
+{
+    MapaSoA mapa;
+    GeradorAleatorio gerador;
+    GrafoFronteiras grafo;
+    ParFronteira *pares;
+    int largura = 1, totalPares = 0, sucesso;
+    double inicio;
+
+    if (quantidade <= 0)
+    {
+        printf("Quantidade de territorios invalida!\n");
+        return 1;
+    }
+
+    while ((long long)largura * largura < quantidade)
+    {
+        largura++;
+    }
+
+    pares = (ParFronteira *)malloc((size_t)quantidade * 2 * sizeof(ParFronteira));
+    if (!iniciarMapa(&mapa, quantidade) || !crescerMapa(&mapa, quantidade) || pares == NULL)
+    {
+        printf("Erro ao alocar memoria para %d territorios!\n", quantidade);
+        liberarMapa(&mapa);
+        free(pares);
+        return 1;
+    }
+
+    reservarArenaNomes(arenaNomesPadrao(), (size_t)quantidade * sizeof("T2147483647"));
+    inicializarGerador(&gerador, semente);
+    for (int i = 0; i < quantidade; i++)
+    {
+        char nome[sizeof("T2147483647")];
+
+        snprintf(nome, sizeof(nome), "T%d", i + 1);
+        mapa.nomes[i] = internarNome(nome);
+        mapa.donos[i] = (uint16_t)sortearIntervalo(&gerador, MAX_JOGADORES);
+        mapa.tropas[i] = 1 + (int)sortearIntervalo(&gerador, 1000);
+
+        if ((i + 1) % largura != 0 && i + 1 < quantidade)
+        {
+            pares[totalPares].a = i;
+            pares[totalPares++].b = i + 1;
+        }
+        if (i + largura < quantidade)
+        {
+            pares[totalPares].a = i;
+            pares[totalPares++].b = i + largura;
+        }
+    }
+
+    sucesso = construirGrafo(&grafo, quantidade, pares, totalPares);
+    free(pares);
+
+    inicio = segundosDecorridos();
+    sucesso = sucesso && salvarMapaArquivo(caminho, &mapa, &grafo);
+    if (sucesso)
+    {
+        printf("Mapa %s gravado: %d territorios, %d fronteiras, %.3f ms\n", caminho, quantidade, totalPares,
+               (segundosDecorridos() - inicio) * 1e3);
+    }
+    else
+    {
+        printf("Erro ao gravar o mapa %s!\n", caminho);
+    }
+
+    liberarGrafo(&grafo);
+    liberarMapa(&mapa);
+    return sucesso ? 0 : 1;
+}
+
+/**
+ * Modo --info-mapa: abre um .wmap sem copiá-lo e resume o conteúdo
+ */
+static int executarModoInfoMapa(const char *caminho)
+{
+    MapaArquivo mapa;
+    int territoriosCor[MAX_JOGADORES] = {0};
+    long long tropas = 0;
+    double inicio, tempoAbertura, tempoSoma;
+
+    inicio = segundosDecorridos();
+    if (!abrirMapaArquivo(&mapa, caminho))
+    {
+        printf("Nao foi possivel abrir o mapa %s (arquivo ausente ou invalido)!\n", caminho);
+        return 1;
+    }
+    tempoAbertura = segundosDecorridos() - inicio;
+
+    // Tropas e donos são lidos direto das páginas do arquivo
+    inicio = segundosDecorridos();
+    for (int i = 0; i < mapa.quantidade; i++)
+    {
+        uint16_t dono = donoMapaArquivo(&mapa, i);
+
+        tropas += mapa.tropas[i];
+        if (dono < MAX_JOGADORES)
+        {
+            territoriosCor[dono]++;
+        }
+    }
+    tempoSoma = segundosDecorridos() - inicio;
+
+    printf("\n===================================\n");
+    printf("     MAPA %s\n", caminho);
+    printf("===================================\n");
+    printf("Versao %u | %d territorios | %u cores | %u fronteiras | %zu bytes\n",
+           mapa.cabecalho->versao, mapa.quantidade, mapa.cabecalho->quantidadeCores,
+           mapa.fronteiras.entradas / 2, mapa.tamanho);
+    printf("Abertura (mmap + validacao): %.3f ms | soma das tropas no lugar: %.3f ms\n",
+           tempoAbertura * 1e3, tempoSoma * 1e3);
+    printf("Tropas: %lld\n", tropas);
+    for (int c = 0; c < MAX_JOGADORES; c++)
+    {
+        if (territoriosCor[c] > 0)
+        {
+            printf("  %-10s %d territorios\n", nomeCor((uint16_t)c), territoriosCor[c]);
+        }
+    }
+    printf("===================================\n\n");
+
+    fecharMapaArquivo(&mapa);
+    return 0;
+}
+
+/**
+ * Função auxiliar que resume uma importação CSV/TSV com a vazão obtida
+ */
+static void exibirResultadoImportacao(FILE *destino, const char *caminho, const ResultadoImportacao *resultado,
+                                      double segundos)
+{
+    fprintf(destino, "Importacao de %s (%s): %lld linhas, %lld territorios, %lld rejeitadas",
+            caminho, resultado->separador == '\t' ? "TSV" : "CSV",
+            resultado->linhas, resultado->importadas, resultado->rejeitadas);
+    if (resultado->primeiraRejeitada > 0)
+    {
+        fprintf(destino, " (primeira na linha %lld)", resultado->primeiraRejeitada);
+    }
+    fprintf(destino, "\n");
+
+    if (segundos > 0.0)
+    {
+        fprintf(destino, "Tempo: %.3f ms | %.1f MB/s | %.1f milhoes de linhas/minuto\n",
+                segundos * 1e3, resultado->bytes / segundos / 1e6, resultado->linhas / segundos * 60.0 / 1e6);
+    }
+}
+
+/**
+ * Modo --converter: importa um CSV/TSV e grava o mapa correspondente em .wmap
+ */
+static int executarModoConverter(const char *entrada, const char *saida)
+{
+    MapaSoA territorios;
+    ResultadoImportacao resultado;
+    double inicio, tempoImportacao;
+    int sucesso;
+
+    iniciarMapa(&territorios, 0);
+
+    inicio = segundosDecorridos();
+    sucesso = importarTerritorios(entrada, &territorios, &resultado);
+    tempoImportacao = segundosDecorridos() - inicio;
+
+    if (!sucesso)
+    {
+        printf("Erro ao importar %s (arquivo ausente, falha de leitura ou falta de memoria)!\n", entrada);
+        liberarMapa(&territorios);
+        return 1;
+    }
+    exibirResultadoImportacao(stdout, entrada, &resultado, tempoImportacao);
+
+    sucesso = territorios.quantidade > 0 && salvarMapaArquivo(saida, &territorios, NULL);
+    if (sucesso)
+    {
+        printf("Mapa %s gravado: %d territorios\n", saida, territorios.quantidade);
+    }
+    else
+    {
+        printf("Erro ao gravar o mapa %s!\n", saida);
+    }
+
+    liberarMapa(&territorios);
+    return sucesso ? 0 : 1;
+}
+
+/**
+ * Modo --replay: reaplica um diário gravado com --registrar e confere o hash final
+ */
+static int executarModoReplay(const char *caminho)
+{
+    ResultadoReproducao reproducao;
+    double inicio, duracao;
+    int sucesso;
+
+    inicio = segundosDecorridos();
+    sucesso = reproduzirRegistro(caminho, &reproducao);
+    duracao = segundosDecorridos() - inicio;
+
+    if (!sucesso)
+    {
+        printf("Diario invalido ou inacessivel: %s\n", caminho);
+        return 1;
+    }
+
+    if (reproducao.mapa.quantidade <= 100)
+    {
+        listarTerritoriosMapa(&reproducao.mapa);
+    }
+
+    printf("Diario: %s | Semente: %llu\n", caminho, (unsigned long long)reproducao.semente);
+    printf("Eventos reaplicados: %llu em %.3f s (%.0f eventos/s)\n", (unsigned long long)reproducao.eventos,
+           duracao, duracao > 0 ? reproducao.eventos / duracao : 0.0);
+    printf("Territorios: %d | Hash final: %016llx\n", reproducao.mapa.quantidade, (unsigned long long)reproducao.hashFinal);
+
+    if (!reproducao.possuiFim)
+    {
+        printf("Diario sem evento final (sessao interrompida): hash nao verificado.\n");
+        sucesso = 1;
+    }
+    else if (reproducao.hashFinal == reproducao.hashEsperado)
+    {
+        printf("Hash confere com o gravado no fim da sessao.\n");
+    }
+    else
+    {
+        printf("DIVERGENCIA: hash gravado %016llx\n", (unsigned long long)reproducao.hashEsperado);
+        sucesso = 0;
+    }
+
+    liberarReproducao(&reproducao);
+    return sucesso ? 0 : 2;
+}
+
+/**
+ * Modo --comandos: executa um lote de comandos (de um arquivo ou, com "-", da entrada padrão)
+ *
+ * A saída padrão recebe só os resultados; o resumo e a vazão vão para a saída de erro.
+ *
+ * @return 0 se a entrada foi processada até o fim (mesmo com comandos rejeitados), 1 caso contrário
+ */
+static int executarModoComandos(const char *caminho, SessaoComandos *sessao)
+{
+    ResultadoComandos resultado;
+    double inicio, duracao;
+    int descritor = strcmp(caminho, "-") == 0 ? STDIN_FILENO : open(caminho, O_RDONLY);
+    int sucesso;
+
+    if (descritor < 0)
+    {
+        fprintf(stderr, "Nao foi possivel abrir os comandos de %s!\n", caminho);
+        return 1;
+    }
+
+    inicio = segundosDecorridos();
+    sucesso = executarComandos(descritor, sessao, &resultado);
+    duracao = segundosDecorridos() - inicio;
+    if (descritor != STDIN_FILENO)
+    {
+        close(descritor);
+    }
+
+    fprintf(stderr, "Comandos: %lld executados, %lld com erro", resultado.comandos, resultado.erros);
+    if (resultado.primeiroErro > 0)
+    {
+        fprintf(stderr, " (primeiro na linha %lld)", resultado.primeiroErro);
+    }
+    fprintf(stderr, ", %lld linhas em %.3f s (%.0f comandos/s)\n", resultado.linhas, duracao,
+            duracao > 0 ? (resultado.comandos + resultado.erros) / duracao : 0.0);
+
+    if (!sucesso)
+    {
+        fprintf(stderr, "Erro ao ler os comandos ou escrever os resultados!\n");
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Função auxiliar que lista o mapa antes de uma escolha, sem inundar o terminal com mapas grandes
+ */
+static void listarParaEscolha(const MapaSoA *mapa)
+{
+    FiltroListagem filtro;
+
+    iniciarFiltroListagem(&filtro);
+    if (mapa->quantidade > LIMITE_LISTAGEM_COMPLETA)
+    {
+        filtro.compacto = 1;
+        filtro.limite = PAGINA_LISTAGEM;
+    }
+    renderizarTerritorios(mapa, &filtro, NULL);
+
+    if (mapa->quantidade > LIMITE_LISTAGEM_COMPLETA)
+    {
+        printf("Use a opcao 9 do menu para consultar o mapa com filtros e paginas.\n\n");
+    }
+}
+
+/**
+ * Função auxiliar que lê um inteiro opcional: ENTER (ou texto não numérico) mantém o padrão
+ */
+static int lerInteiroOpcional(const char *mensagem, int padrao)
+{
+    char texto[32];
+    char *fim;
+    long valor;
+
+    lerString(texto, sizeof(texto), mensagem);
+    valor = strtol(texto, &fim, 10);
+    if (fim == texto || valor < INT_MIN || valor > INT_MAX)
+    {
+        return padrao;
+    }
+    return (int)valor;
+}
+
+/**
+ * Função auxiliar da opção 9: consulta o mapa por cor, faixa de tropas e página
+ */
+static void consultarTerritorios(const MapaSoA *mapa)
+{
+    FiltroListagem filtro;
+    ResumoListagem resumo;
+    char resposta[TAMANHO_COR];
+    int tamanhoPagina, pagina;
+
+    iniciarFiltroListagem(&filtro);
+
+    lerString(resposta, sizeof(resposta), "Formato compacto? (s/n): ");
+    filtro.compacto = resposta[0] == 's' || resposta[0] == 'S';
+
+    lerString(resposta, sizeof(resposta), "Cor do exercito (ENTER para todas): ");
+    if (resposta[0] != '\0')
+    {
+        filtro.idCor = procurarCor(resposta);
+        if (filtro.idCor < 0)
+        {
+            printf("\nNenhum territorio tem a cor %s.\n\n", resposta);
+            return;
+        }
+    }
+
+    filtro.tropasMinimas = lerInteiroOpcional("Tropas minimas (ENTER para sem limite): ", INT_MIN);
+    filtro.tropasMaximas = lerInteiroOpcional("Tropas maximas (ENTER para sem limite): ", INT_MAX);
+    tamanhoPagina = lerInteiroOpcional("Territorios por pagina (ENTER para 50, 0 para todos): ", PAGINA_LISTAGEM);
+    pagina = tamanhoPagina > 0 ? lerInteiroOpcional("Pagina (ENTER para 1): ", 1) : 1;
+
+    if (tamanhoPagina < 0 || pagina < 1 || (long long)(pagina - 1) * tamanhoPagina > INT_MAX)
+    {
+        printf("\nPagina invalida!\n\n");
+        return;
+    }
+    filtro.limite = tamanhoPagina;
+    filtro.pular = (pagina - 1) * tamanhoPagina;
+
+    if (!renderizarTerritorios(mapa, &filtro, &resumo))
+    {
+        printf("Erro ao escrever a listagem!\n\n");
+    }
+    else if (resumo.exibidos == 0 && resumo.correspondentes > 0)
+    {
+        printf("A pagina %d esta alem do fim (%d territorios atendem ao filtro).\n\n", pagina, resumo.correspondentes);
+    }
+}
+
+/**
+ * Função auxiliar para ler e validar o par atacante/defensor escolhido no menu
+ * @param fronteiras Grafo de fronteiras (NULL permite atacar qualquer território)
+ * @param idAtacante Recebe o índice (0 a N-1) do atacante
+ * @param idDefensor Recebe o índice (0 a N-1) do defensor
+ * @return 1 se a escolha é válida, 0 caso contrário (a mensagem já foi exibida)
+ */
+static int escolherAlvosAtaque(const MapaSoA *mapa, const GrafoFronteiras *fronteiras, int *idAtacante, int *idDefensor)
+{
+    int quantidade = mapa->quantidade;
+
+    listarParaEscolha(mapa);
+
+    printf("Escolha o territorio atacante (1 a %d): ", quantidade);
+    scanf("%d", idAtacante);
+    limparBuffer();
+
+    printf("Escolha o territorio defensor (1 a %d): ", quantidade);
+    scanf("%d", idDefensor);
+    limparBuffer();
+
+    // Valida as escolhas
+    if (*idAtacante < 1 || *idAtacante > quantidade ||
+        *idDefensor < 1 || *idDefensor > quantidade ||
+        *idAtacante == *idDefensor)
+    {
+        printf("\nEscolha invalida! Tente novamente.\n\n");
+        return 0;
+    }
+
+    // Ajusta os índices (interface usa 1-N, array usa 0-(N-1))
+    (*idAtacante)--;
+    (*idDefensor)--;
+
+    // Verifica se os territórios pertencem ao mesmo jogador
+    if (mapa->donos[*idAtacante] == mapa->donos[*idDefensor])
+    {
+        printf("\nVoce nao pode atacar um territorio da sua propria cor!\n\n");
+        return 0;
+    }
+
+    // Com fronteiras carregadas, só é possível atacar um vizinho
+    if (fronteiras != NULL && !saoVizinhos(fronteiras, *idAtacante, *idDefensor))
+    {
+        int grau;
+        const uint32_t *vizinhos = vizinhosTerritorio(fronteiras, *idAtacante, &grau);
+
+        printf("\nOs territorios %d e %d nao fazem fronteira! Vizinhos de %d:", *idAtacante + 1, *idDefensor + 1,
+               *idAtacante + 1);
+        for (int k = 0; k < grau; k++)
+        {
+            printf(" %u", vizinhos[k] + 1);
+        }
+        printf("%s\n\n", grau == 0 ? " nenhum" : "");
+        return 0;
+    }
+
+    return 1;
+}
+
+// Quantidade de rodadas por linha no placar compacto do ataque relâmpago
+#define RODADAS_POR_LINHA 50
+
+/**
+ * Estrutura do placar compacto: uma letra por rodada, impressa em linhas
+ */
+typedef struct
+{
+    char linha[RODADAS_POR_LINHA + 1];
+    int posicao;
+    int rodadasImpressas;
+    AcompanhamentoAtaque *acompanhamento;
+    AcompanhamentoEventos *eventos;
+} PlacarBlitz;
+
+/**
+ * Função auxiliar para imprimir a linha pendente do placar
+ */
+static void descarregarPlacar(PlacarBlitz *placar)
+{
+    if (placar->posicao == 0)
+    {
+        return;
+    }
+
+    placar->linha[placar->posicao] = '\0';
+    printf("  %5d | %s\n", placar->rodadasImpressas + 1, placar->linha);
+    placar->rodadasImpressas += placar->posicao;
+    placar->posicao = 0;
+}
+
+/**
+ * Observador de rodadas do ataque relâmpago: anota V, D ou E no placar
+ */
+static void anotarRodadaBlitz(const ResultadoCombate *combate, void *contexto)
+{
+    static const char SIMBOLOS[] = {'V', 'D', 'E'};
+    PlacarBlitz *placar = (PlacarBlitz *)contexto;
+
+    placar->linha[placar->posicao++] = SIMBOLOS[combate->resultado];
+    if (placar->posicao == RODADAS_POR_LINHA)
+    {
+        descarregarPlacar(placar);
+    }
+
+    // Cada rodada também vai para o diário e para o fluxo de eventos, quando estiverem ativos
+    registrarAtaqueObservado(combate, placar->acompanhamento);
+    emitirEventoObservado(combate, placar->eventos);
+}
+
+/**
+ * Função para executar o ataque relâmpago e exibir apenas o placar e o resumo
+ */
+static void executarBlitz(Territorio *atacante, Territorio *defensor, int piso, GeradorAleatorio *gerador,
+                          AcompanhamentoAtaque *acompanhamento, AcompanhamentoEventos *eventos)
+{
+    PlacarBlitz placar = {{0}, 0, 0, acompanhamento, eventos};
+    ResultadoBatalha batalha;
+
+    if (piso < 1)
+    {
+        piso = 1;
+    }
+
+    printf("\n===================================\n");
+    printf("       ATAQUE RELAMPAGO           \n");
+    printf("===================================\n");
+    printf("%s (%s, %d tropas) ataca %s (%s, %d tropas) ate restarem %d tropas\n",
+           textoNome(atacante->nome), nomeCor(atacante->idCor), atacante->tropas,
+           textoNome(defensor->nome), nomeCor(defensor->idCor), defensor->tropas, piso);
+    printf("Rodadas (V = vitoria do atacante, D = defesa, E = empate):\n");
+
+    simularBatalhaObservada(atacante, defensor, piso, gerador, anotarRodadaBlitz, &placar, &batalha);
+    descarregarPlacar(&placar);
+
+    if (batalha.rodadas == 0)
+    {
+        printf("  (nenhuma rodada: o atacante ja esta no piso de tropas)\n");
+    }
+
+    printf("\nRodadas: %d | Vitorias: %d | Defesas: %d | Empates: %d\n",
+           batalha.rodadas, batalha.vitoriasAtacante, batalha.vitoriasDefensor, batalha.empates);
+    printf("Baixas: %s perdeu %d tropas, %s perdeu %d tropas\n",
+           textoNome(atacante->nome), batalha.tropasPerdidasAtacante, textoNome(defensor->nome), batalha.tropasPerdidasDefensor);
+
+    if (batalha.conquistado)
+    {
+        printf("O territorio %s foi conquistado e agora pertence ao exercito %s\n", textoNome(defensor->nome), nomeCor(defensor->idCor));
+    }
+    else
+    {
+        printf("%s interrompeu o ataque ao chegar a %d tropas\n", textoNome(atacante->nome), atacante->tropas);
+    }
+    printf("===================================\n\n");
+}
+
+/**
+ * Função para aplicar atrito a uma cor e gravar no diário a variação de cada território
+ */
+static void aplicarAtritoRegistrado(MapaSoA *mapa, const char *cor, int pontosBase, RegistroPartida *registro)
+{
+    int32_t *antes = NULL;
+    long long perdidas = 0;
+    int idCor = procurarCor(cor);
+
+    // Com o diário ativo, guarda uma cópia do vetor de tropas para gravar as variações reais
+    if (registro != NULL)
+    {
+        antes = (int32_t *)malloc((mapa->quantidade > 0 ? (size_t)mapa->quantidade : 1) * sizeof(int32_t));
+        if (antes == NULL)
+        {
+            printf("Erro na alocacao de memoria!\n");
+            return;
+        }
+        memcpy(antes, mapa->tropas, (size_t)mapa->quantidade * sizeof(int32_t));
+    }
+
+    // Uma cor que não está na tabela não ocupa nenhum território
+    if (idCor >= 0)
+    {
+        perdidas = aplicarAtritoDono(mapa, (uint16_t)idCor, pontosBase);
+    }
+
+    if (antes != NULL)
+    {
+        for (int i = 0; i < mapa->quantidade; i++)
+        {
+            if (mapa->tropas[i] != antes[i])
+            {
+                registrarAjuste(registro, i, mapa->tropas[i] - antes[i]);
+            }
+        }
+        free(antes);
+    }
+
+    printf("\nO exercito %s perdeu %lld tropas por atrito (%d.%02d%%).\n\n",
+           cor, perdidas, pontosBase / 100, pontosBase % 100);
+}
+
+int main(int argc, char *argv[])
+{
+    int quantidade = 0;
+    MapaSoA territorios;
+    Territorio atacante, defensor;
+    int mapaPreenchido;
+    int opcao = -1;
+    int retorno = 0;
+    int idAtacante, idDefensor;
+    int piso;
+    ResultadoCombate combate;
+    GeradorAleatorio gerador;
+    AcompanhamentoAtaque acompanhamento;
+    RegistroPartida registro;
+    RegistroPartida *registroAtivo = NULL;
+    AcompanhamentoEventos acompanhamentoEventos;
+    SaidaEventos saidaEventos;
+    SaidaEventos *eventosAtivos = NULL;
+    const char *caminhoEventos = NULL;
+    const char *caminhoRegistro = NULL;
+    const char *caminhoReplay = NULL;
+    const char *caminhoFronteiras = NULL;
+    const char *caminhoMapa = NULL;
+    const char *caminhoGerarMapa = NULL;
+    const char *caminhoInfoMapa = NULL;
+    const char *caminhoImportacao = NULL;
+    const char *caminhoConversao = NULL;
+    const char *caminhoJogo = NULL;
+    const char *caminhoComandos = NULL;
+    FILE *avisos = stdout;
+    int territoriosGerarMapa = 0;
+    MapaArquivo mapaArquivo;
+    GrafoFronteiras grafo;
+    const GrafoFronteiras *fronteiras = NULL;
+    uint64_t semente = (uint64_t)time(NULL);
+    int modoMonteCarlo = 0;
+    int modoExato = 0;
+    int modoAutoplay = 0;
+    int modoTorneio = 0;
+    int territoriosVarredura = 0;
+    long long facesConferencia = 0;
+    int partidas = 1;
+    ConfiguracaoPartida partida = {42, 4, 3, 500, {ESTRATEGIA_AGRESSIVA, ESTRATEGIA_ALEATORIA, ESTRATEGIA_CAUTELOSA,
+                                                   ESTRATEGIA_AGRESSIVA, ESTRATEGIA_ALEATORIA, ESTRATEGIA_CAUTELOSA},
+                                   0, NULL, NULL};
+    ConfiguracaoMonteCarlo monteCarlo = {0, 0, 1, 4000000, 0, 0};
+    ConfiguracaoTorneio torneio = {0, 0, 0, 0, {0, 0, 0, 0, {ESTRATEGIA_ALEATORIA}, 0, NULL, NULL}, 0};
+
+    // Opções de linha de comando: semente fixa e modos não interativos
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc)
+        {
+            semente = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--montecarlo") == 0 && i + 2 < argc)
+        {
+            modoMonteCarlo = 1;
+            monteCarlo.tropasAtacante = atoi(argv[++i]);
+            monteCarlo.tropasDefensor = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--exato") == 0 && i + 2 < argc)
+        {
+            modoExato = 1;
+            monteCarlo.tropasAtacante = atoi(argv[++i]);
+            monteCarlo.tropasDefensor = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--registrar") == 0 && i + 1 < argc)
+        {
+            caminhoRegistro = argv[++i];
+        }
+        else if (strcmp(argv[i], "--eventos") == 0 && i + 1 < argc)
+        {
+            caminhoEventos = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            caminhoReplay = argv[++i];
+        }
+        else if (strcmp(argv[i], "--fronteiras") == 0 && i + 1 < argc)
+        {
+            caminhoFronteiras = argv[++i];
+        }
+        else if (strcmp(argv[i], "--mapa") == 0 && i + 1 < argc)
+        {
+            caminhoMapa = argv[++i];
+        }
+        else if (strcmp(argv[i], "--gerar-mapa") == 0 && i + 2 < argc)
+        {
+            territoriosGerarMapa = atoi(argv[++i]);
+            caminhoGerarMapa = argv[++i];
+        }
+        else if (strcmp(argv[i], "--info-mapa") == 0 && i + 1 < argc)
+        {
+            caminhoInfoMapa = argv[++i];
+        }
+        else if (strcmp(argv[i], "--carregar") == 0 && i + 1 < argc)
+        {
+            caminhoJogo = argv[++i];
+        }
+        else if (strcmp(argv[i], "--comandos") == 0 && i + 1 < argc)
+        {
+            caminhoComandos = argv[++i];
+        }
+        else if (strcmp(argv[i], "--importar") == 0 && i + 1 < argc)
+        {
+            caminhoImportacao = argv[++i];
+        }
+        else if (strcmp(argv[i], "--converter") == 0 && i + 2 < argc)
+        {
+            caminhoImportacao = argv[++i];
+            caminhoConversao = argv[++i];
+        }
+        else if (strcmp(argv[i], "--autoplay") == 0)
+        {
+            modoAutoplay = 1;
+        }
+        else if (strcmp(argv[i], "--torneio") == 0 && i + 1 < argc)
+        {
+            modoTorneio = 1;
+            torneio.partidas = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--conferir-lote") == 0 && i + 1 < argc)
+        {
+            facesConferencia = atoll(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--varredura") == 0 && i + 1 < argc)
+        {
+            territoriosVarredura = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--territorios-max") == 0 && i + 1 < argc)
+        {
+            torneio.territoriosMaximo = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--partidas") == 0 && i + 1 < argc)
+        {
+            partidas = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--territorios") == 0 && i + 1 < argc)
+        {
+            partida.territorios = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--jogadores") == 0 && i + 1 < argc)
+        {
+            partida.jogadores = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--tropas") == 0 && i + 1 < argc)
+        {
+            partida.tropasIniciais = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--turnos") == 0 && i + 1 < argc)
+        {
+            partida.maxTurnos = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--estrategias") == 0 && i + 1 < argc)
+        {
+            if (!lerListaEstrategias(argv[++i], &partida))
+            {
+                printf("Estrategia invalida! Use aleatoria, agressiva ou cautelosa.\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--tentativas") == 0 && i + 1 < argc)
+        {
+            monteCarlo.tentativas = atoll(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            monteCarlo.threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--piso") == 0 && i + 1 < argc)
+        {
+            monteCarlo.tropasMinimas = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--alocador") == 0 && i + 1 < argc)
+        {
+            if (!selecionarAlocador(argv[++i]))
+            {
+                printf("Alocador invalido! Use sistema, arena, pool ou mmap.\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--estatisticas") == 0)
+        {
+            atexit(exibirEstatisticasAoSair);
+        }
+    }
 
-int main()
-{
-    int quantidade = 0;
-    Territorio *mapa = NULL;
-    int opcao = 0;
-    int idAtacante, idDefensor;
-    TipoAlocacao tipoAlocacao;
+    if (caminhoReplay != NULL)
+    {
+        return executarModoReplay(caminhoReplay);
+    }
 
-    // Inicializa a semente para números aleatórios
-    srand(time(NULL));
+    if (caminhoGerarMapa != NULL)
+    {
+        return executarModoGerarMapa(territoriosGerarMapa, caminhoGerarMapa, semente);
+    }
 
-    printf("===================================\n");
-    printf("  SISTEMA DE TERRITORIOS PARA WAR  \n");
-    printf("===================================\n\n");
+    if (caminhoInfoMapa != NULL)
+    {
+        return executarModoInfoMapa(caminhoInfoMapa);
+    }
 
-    // Solicita a quantidade de territórios a serem cadastrados
-    printf("Informe a quantidade de territorios: ");
-    scanf("%d", &quantidade);
-    limparBuffer();
+    if (caminhoConversao != NULL)
+    {
+        return executarModoConverter(caminhoImportacao, caminhoConversao);
+    }
 
-    if (quantidade <= 0)
+    if (modoAutoplay)
+    {
+        int retorno;
+
+        partida.semente = semente;
+
+        // O grafo cobre exatamente os territórios gerados em cada partida
+        if (caminhoFronteiras != NULL)
+        {
+            if (!carregarFronteiras(&grafo, caminhoFronteiras, partida.territorios))
+            {
+                printf("Erro ao carregar as fronteiras de %s para %d territorios!\n", caminhoFronteiras,
+                       partida.territorios);
+                return 1;
+            }
+            partida.fronteiras = &grafo;
+        }
+
+        if (caminhoEventos != NULL)
+        {
+            if (!abrirEventos(&saidaEventos, caminhoEventos))
+            {
+                printf("Nao foi possivel abrir %s para os eventos!\n", caminhoEventos);
+                if (partida.fronteiras != NULL)
+                {
+                    liberarGrafo(&grafo);
+                }
+                return 1;
+            }
+            partida.eventos = &saidaEventos;
+        }
+
+        retorno = executarModoAutoplay(&partida, partidas);
+        if (partida.eventos != NULL && !fecharEventos(&saidaEventos))
+        {
+            fprintf(stderr, "Erro ao gravar os eventos em %s!\n", caminhoEventos);
+            retorno = 1;
+        }
+        if (partida.fronteiras != NULL)
+        {
+            liberarGrafo(&grafo);
+        }
+        return retorno;
+    }
+
+    if (facesConferencia != 0)
+    {
+        return executarModoConferirLote(facesConferencia, semente);
+    }
+
+    if (territoriosVarredura != 0)
+    {
+        return executarModoVarredura(territoriosVarredura, monteCarlo.threads, semente);
+    }
+
+    if (modoTorneio)
+    {
+        // Um destino de eventos não pode ser compartilhado pelas threads do torneio
+        if (caminhoEventos != NULL)
+        {
+            printf("--eventos vale para --autoplay e para a sessao interativa; o torneio o ignora.\n");
+        }
+        torneio.base = partida;
+        torneio.territoriosMinimo = partida.territorios;
+        torneio.threads = monteCarlo.threads;
+        torneio.semente = semente;
+        return executarModoTorneio(&torneio);
+    }
+
+    if (modoExato)
+    {
+        return executarModoExato(monteCarlo.tropasAtacante, monteCarlo.tropasDefensor, monteCarlo.tropasMinimas);
+    }
+
+    if (modoMonteCarlo)
+    {
+        monteCarlo.semente = semente;
+        return executarModoMonteCarlo(&monteCarlo);
+    }
+
+    // Inicializa o gerador de números aleatórios com a semente escolhida
+    inicializarGerador(&gerador, semente);
+
+    // No modo de comandos a saída padrão fica só com os resultados; os avisos vão para a saída de erro
+    if (caminhoComandos != NULL)
+    {
+        avisos = stderr;
+    }
+    else
+    {
+        printf("===================================\n");
+        printf("  SISTEMA DE TERRITORIOS PARA WAR  \n");
+        printf("===================================\n");
+        printf("Semente: %llu\n", (unsigned long long)semente);
+        printf("Alocador: %s\n\n", alocadorAtual()->operacoes->nome);
+    }
+
+    // Com --carregar a partida salva volta inteira (territórios e gerador); com --mapa os
+    // territórios vêm de um arquivo .wmap, com --importar de um CSV/TSV; sem nenhum, são digitados um a um
+    if (caminhoJogo != NULL)
+    {
+        CabecalhoSalvamento salvo;
+        double inicio = segundosDecorridos();
+
+        if (!carregarJogo(caminhoJogo, &territorios, &grafo, &gerador, &salvo))
+        {
+            printf("Nao foi possivel carregar o jogo %s (arquivo ausente ou invalido)! O programa sera encerrado.\n", caminhoJogo);
+            return 1;
+        }
+        semente = salvo.semente;
+        quantidade = territorios.quantidade;
+        fprintf(avisos, "Jogo %s carregado em %.3f ms: %d territorios, semente %llu, salvo com o alocador %s\n\n",
+                caminhoJogo, (segundosDecorridos() - inicio) * 1e3, quantidade,
+                (unsigned long long)semente, salvo.alocador);
+    }
+    else if (caminhoImportacao != NULL)
+    {
+        ResultadoImportacao resultado;
+        double inicio = segundosDecorridos();
+
+        iniciarMapa(&territorios, 0);
+        if (!importarTerritorios(caminhoImportacao, &territorios, &resultado))
+        {
+            printf("Erro ao importar %s! O programa sera encerrado.\n", caminhoImportacao);
+            return 1;
+        }
+        exibirResultadoImportacao(avisos, caminhoImportacao, &resultado, segundosDecorridos() - inicio);
+        fprintf(avisos, "\n");
+        quantidade = territorios.quantidade;
+    }
+    else if (caminhoMapa != NULL)
+    {
+        if (!abrirMapaArquivo(&mapaArquivo, caminhoMapa))
+        {
+            printf("Nao foi possivel abrir o mapa %s! O programa sera encerrado.\n", caminhoMapa);
+            return 1;
+        }
+        quantidade = mapaArquivo.quantidade;
+        fprintf(avisos, "Mapa %s: %d territorios, %u fronteiras\n\n", caminhoMapa, quantidade,
+                mapaArquivo.fronteiras.entradas / 2);
+    }
+    else if (caminhoComandos != NULL)
+    {
+        // Sem mapa de origem, o lote começa vazio e cadastra os territórios com add
+        quantidade = 0;
+    }
+    else
+    {
+        // Solicita a quantidade de territórios a serem cadastrados
+        printf("Informe a quantidade de territorios: ");
+        scanf("%d", &quantidade);
+        limparBuffer();
+    }
+
+    if (quantidade < 0 || (quantidade == 0 && caminhoComandos == NULL))
     {
         printf("Quantidade invalida! O programa sera encerrado.\n");
         return 1;
     }
 
-    // Aloca memória para os territórios usando a função modularizada
-    mapa = alocarTerritorios(quantidade, &tipoAlocacao);
+    // Fronteiras: sem o arquivo, qualquer território pode atacar qualquer outro
+    if (caminhoFronteiras != NULL)
+    {
+        // As fronteiras indicadas na linha de comando substituem as do salvamento
+        if (caminhoJogo != NULL)
+        {
+            liberarGrafo(&grafo);
+        }
+        if (!carregarFronteiras(&grafo, caminhoFronteiras, quantidade))
+        {
+            printf("Erro ao carregar as fronteiras de %s! O programa sera encerrado.\n", caminhoFronteiras);
+            return 1;
+        }
+        fronteiras = &grafo;
+        fprintf(avisos, "Fronteiras carregadas: %u ligacoes entre %d territorios\n\n", grafo.entradas / 2, quantidade);
+    }
+    else if (caminhoJogo != NULL)
+    {
+        // A partida salva traz as próprias fronteiras, se tinha alguma
+        if (grafo.deslocamentos != NULL)
+        {
+            fronteiras = &grafo;
+            fprintf(avisos, "Fronteiras do salvamento: %u ligacoes entre %d territorios\n\n", grafo.entradas / 2, quantidade);
+        }
+    }
+    else if (caminhoMapa != NULL && mapaArquivo.fronteiras.entradas > 0)
+    {
+        // O grafo do arquivo é usado no lugar, direto das páginas mapeadas
+        fronteiras = &mapaArquivo.fronteiras;
+    }
 
-    // Verificação de falha na alocação
-    if (mapa == NULL)
+    // Aloca o mapa já com a capacidade exata do cadastro inicial
+    // (a carga e a importação já o preencheram)
+    mapaPreenchido = caminhoJogo != NULL || caminhoImportacao != NULL;
+    if (!mapaPreenchido && (!iniciarMapa(&territorios, quantidade) || !crescerMapa(&territorios, quantidade)))
     {
         printf("Erro na alocacao de memoria! O programa sera encerrado.\n");
         return 1;
     }
 
-    // Laço para entrada de dados dos territórios
-    for (int i = 0; i < quantidade; i++)
+    // Mapa grande: os vetores vieram zerados sob demanda, e as faltas de página saem do laço serial abaixo
+    if (!mapaPreenchido && (size_t)territorios.capacidade * BYTES_TERRITORIO_MAPA >= LIMIAR_MAPA_GRANDE)
+    {
+        tocarPaginas(territorios.tropas, (size_t)territorios.capacidade * sizeof(int32_t), monteCarlo.threads);
+        tocarPaginas(territorios.donos, (size_t)territorios.capacidade * sizeof(uint16_t), monteCarlo.threads);
+        tocarPaginas(territorios.nomes, (size_t)territorios.capacidade * sizeof(RefNome), monteCarlo.threads);
+    }
+
+    // Cópia do arquivo, que continua somente leitura, ou entrada de dados dos territórios
+    if (!mapaPreenchido && caminhoMapa != NULL)
+    {
+        if (!copiarMapaArquivo(&mapaArquivo, &territorios))
+        {
+            printf("Erro na alocacao de memoria! O programa sera encerrado.\n");
+            return 1;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < territorios.quantidade && !mapaPreenchido; i++)
+        {
+            cadastrarTerritorioMapa(&territorios, i);
+        }
+    }
+
+    // Exibe os territórios cadastrados (só a primeira página, em mapas grandes)
+    if (caminhoComandos == NULL)
+    {
+        listarParaEscolha(&territorios);
+    }
+
+    // Inicia o diário de ataques a partir do mapa já cadastrado
+    if (caminhoRegistro != NULL)
+    {
+        if (abrirRegistro(&registro, caminhoRegistro, semente, &territorios))
+        {
+            registroAtivo = &registro;
+        }
+        else
+        {
+            fprintf(avisos, "Nao foi possivel criar o diario %s; a sessao seguira sem gravacao.\n\n", caminhoRegistro);
+        }
+    }
+
+    // Abre o fluxo de eventos NDJSON, se pedido (no modo de comandos a saída padrão é dos resultados)
+    if (caminhoEventos != NULL && caminhoComandos != NULL && strcmp(caminhoEventos, "-") == 0)
+    {
+        fprintf(avisos, "--eventos - nao pode dividir a saida padrao com --comandos; use um arquivo.\n\n");
+    }
+    else if (caminhoEventos != NULL)
     {
-        cadastrarTerritorio(&mapa[i], i, quantidade);
+        if (abrirEventos(&saidaEventos, caminhoEventos))
+        {
+            eventosAtivos = &saidaEventos;
+        }
+        else
+        {
+            fprintf(avisos, "Nao foi possivel abrir %s; a sessao seguira sem eventos.\n\n", caminhoEventos);
+        }
     }
 
-    // Exibe os territórios cadastrados
-    listarTerritorios(mapa, quantidade);
+    // No modo de comandos o lote substitui o menu
+    if (caminhoComandos != NULL)
+    {
+        SessaoComandos sessao = {&territorios, &gerador, semente, fronteiras, registroAtivo, eventosAtivos};
+
+        retorno = executarModoComandos(caminhoComandos, &sessao);
+        opcao = 0;
+    }
 
     // Menu de opções para simulação de ataques
-    do
+    while (opcao != 0)
     {
         printf("===================================\n");
         printf("             MENU                 \n");
@@ -73,61 +1520,59 @@ int main()
         printf("1 - Listar territorios\n");
         printf("2 - Realizar ataque\n");
         printf("3 - Adicionar mais territorios\n");
+        printf("4 - Ataque relampago (blitz)\n");
+        printf("5 - Aplicar atrito a um exercito\n");
+        printf("6 - Estatisticas de memoria\n");
+        printf("7 - Salvar mapa (.wmap)\n");
+        printf("8 - Salvar jogo\n");
+        printf("9 - Consultar territorios (filtros e paginas)\n");
         printf("0 - Sair\n");
         printf("Escolha uma opcao: ");
         scanf("%d", &opcao);
         limparBuffer();
 
+        // Na sessão interativa os eventos seguem a cada ação, sem esperar o buffer encher
+        if (eventosAtivos != NULL)
+        {
+            descarregarEventosPendentes(eventosAtivos);
+        }
+
         switch (opcao)
         {
         case 1:
-            listarTerritorios(mapa, quantidade);
+            listarTerritoriosMapa(&territorios);
             break;
 
         case 2:
-            // Solicita os territórios para o ataque
-            listarTerritorios(mapa, quantidade);
-
-            printf("Escolha o territorio atacante (1 a %d): ", quantidade);
-            scanf("%d", &idAtacante);
-            limparBuffer();
-
-            printf("Escolha o territorio defensor (1 a %d): ", quantidade);
-            scanf("%d", &idDefensor);
-            limparBuffer();
-
-            // Valida as escolhas
-            if (idAtacante < 1 || idAtacante > quantidade ||
-                idDefensor < 1 || idDefensor > quantidade ||
-                idAtacante == idDefensor)
-            {
-                printf("\nEscolha invalida! Tente novamente.\n\n");
-                break;
-            }
-
-            // Ajusta os índices (interface usa 1-N, array usa 0-(N-1))
-            idAtacante--;
-            idDefensor--;
-
-            // Verifica se os territórios pertencem ao mesmo jogador
-            if (strcmp(mapa[idAtacante].cor, mapa[idDefensor].cor) == 0)
+            // Solicita e valida os territórios para o ataque
+            if (!escolherAlvosAtaque(&territorios, fronteiras, &idAtacante, &idDefensor))
             {
-                printf("\nVoce nao pode atacar um territorio da sua propria cor!\n\n");
                 break;
             }
 
-            // Realiza o ataque usando a função modularizada
-            atacar(&mapa[idAtacante], &mapa[idDefensor]);
+            // Resolve o ataque numa cópia do par, devolvida ao mapa, e apenas formata o desfecho
+            obterTerritorioMapa(&territorios, idAtacante, &atacante);
+            obterTerritorioMapa(&territorios, idDefensor, &defensor);
+            iniciarAcompanhamento(&acompanhamento, registroAtivo, &gerador, &atacante, &defensor, idAtacante, idDefensor);
+            iniciarAcompanhamentoEventos(&acompanhamentoEventos, eventosAtivos, &atacante, &defensor,
+                                         idAtacante, idDefensor);
+            resolverAtaque(&atacante, &defensor, &gerador, &combate);
+            registrarAtaqueObservado(&combate, &acompanhamento);
+            emitirEventoObservado(&combate, &acompanhamentoEventos);
+            guardarTerritorioMapa(&territorios, idAtacante, &atacante);
+            guardarTerritorioMapa(&territorios, idDefensor, &defensor);
+            exibirResultadoCombate(&atacante, &defensor, &combate);
 
             // Exibe os territórios atualizados
             printf("Estado atual dos territorios envolvidos:\n");
-            exibirTerritorio(&mapa[idAtacante], idAtacante);
-            exibirTerritorio(&mapa[idDefensor], idDefensor);
+            exibirTerritorio(&atacante, idAtacante);
+            exibirTerritorio(&defensor, idDefensor);
             break;
 
         case 3:
-            // Adicionar mais territórios usando realloc
+            // Adicionar mais territórios ao mapa com crescimento geométrico
             {
+                Territorio cadastrado;
                 int novos;
                 printf("Quantos novos territorios deseja adicionar? ");
                 scanf("%d", &novos);
@@ -139,30 +1584,131 @@ int main()
                     break;
                 }
 
-                int novoTotal = quantidade + novos;
-
-                // Realoca memória usando a função modularizada
-                Territorio *novoMapa = realocarTerritorios(mapa, quantidade, novoTotal, &tipoAlocacao);
+                int primeiro = territorios.quantidade;
 
-                if (novoMapa == NULL)
+                // Cresce o mapa; a capacidade dobra só quando acaba o espaço reservado
+                if (!crescerMapa(&territorios, novos))
                 {
                     printf("Erro na realocacao de memoria!\n");
                     break;
                 }
 
-                mapa = novoMapa;
-
                 // Cadastra os novos territórios
-                for (int i = quantidade; i < novoTotal; i++)
+                for (int i = primeiro; i < territorios.quantidade; i++)
                 {
-                    cadastrarTerritorio(&mapa[i], i, novoTotal);
+                    cadastrarTerritorioMapa(&territorios, i);
+                    obterTerritorioMapa(&territorios, i, &cadastrado);
+                    registrarTerritorio(registroAtivo, &cadastrado);
                 }
 
-                quantidade = novoTotal;
                 printf("Territorios adicionados com sucesso!\n");
+                printf("Capacidade: %d territorios | Bytes movidos: %zu nesta operacao, %zu em %d realocacoes\n",
+                       territorios.capacidade, territorios.bytesMovidos,
+                       territorios.bytesMovidosTotal, territorios.realocacoes);
+            }
+            break;
+
+        case 4:
+            // Ataque relâmpago: repete rodadas até a conquista ou até o piso de tropas
+            if (!escolherAlvosAtaque(&territorios, fronteiras, &idAtacante, &idDefensor))
+            {
+                break;
+            }
+
+            printf("Piso de tropas do atacante (minimo 1): ");
+            scanf("%d", &piso);
+            limparBuffer();
+
+            obterTerritorioMapa(&territorios, idAtacante, &atacante);
+            obterTerritorioMapa(&territorios, idDefensor, &defensor);
+            iniciarAcompanhamento(&acompanhamento, registroAtivo, &gerador, &atacante, &defensor, idAtacante, idDefensor);
+            iniciarAcompanhamentoEventos(&acompanhamentoEventos, eventosAtivos, &atacante, &defensor,
+                                         idAtacante, idDefensor);
+            executarBlitz(&atacante, &defensor, piso, &gerador, &acompanhamento, &acompanhamentoEventos);
+            guardarTerritorioMapa(&territorios, idAtacante, &atacante);
+            guardarTerritorioMapa(&territorios, idDefensor, &defensor);
+
+            printf("Estado atual dos territorios envolvidos:\n");
+            exibirTerritorio(&atacante, idAtacante);
+            exibirTerritorio(&defensor, idDefensor);
+            break;
+
+        case 5:
+            // Atrito: todos os territórios de uma cor perdem um percentual das tropas
+            {
+                char cor[TAMANHO_COR];
+                float percentual;
+                int lido;
+
+                lerString(cor, TAMANHO_COR, "Cor do exercito afetado: ");
+                printf("Percentual de perda (ex.: 10 ou 2.5): ");
+                lido = scanf("%f", &percentual);
+                limparBuffer();
+
+                if (lido != 1 || percentual <= 0 || percentual > 100)
+                {
+                    printf("Percentual invalido!\n");
+                    break;
+                }
+
+                aplicarAtritoRegistrado(&territorios, cor, (int)(percentual * 100.0f + 0.5f), registroAtivo);
+            }
+            break;
+
+        case 6:
+            // Telemetria de alocação acumulada desde o início da sessão
+            {
+                EstatisticasAlocacao dados;
+
+                obterEstatisticasAlocacao(&dados);
+                exibirEstatisticasAlocacao(&dados);
+                printf("Mapa de territorios: %d em uso, capacidade %d (%zu bytes reservados nos vetores)\n\n",
+                       territorios.quantidade, territorios.capacidade,
+                       (size_t)territorios.capacidade * BYTES_TERRITORIO_MAPA);
+            }
+            break;
+
+        case 7:
+            // Grava o mapa atual, com as fronteiras carregadas, no formato .wmap
+            {
+                char caminho[TAMANHO_CAMINHO_ARQUIVO];
+
+                lerString(caminho, sizeof(caminho), "Arquivo de destino (.wmap): ");
+                if (salvarMapaArquivo(caminho, &territorios, fronteiras))
+                {
+                    printf("Mapa gravado em %s (%d territorios).\n\n", caminho, territorios.quantidade);
+                }
+                else
+                {
+                    printf("Erro ao gravar o mapa em %s!\n\n", caminho);
+                }
+            }
+            break;
+
+        case 8:
+            // Grava territórios, fronteiras, metadados do mapa e estado do gerador; --carregar retoma daqui
+            {
+                char caminho[TAMANHO_CAMINHO_ARQUIVO];
+                double inicio;
+
+                lerString(caminho, sizeof(caminho), "Arquivo de destino: ");
+                inicio = segundosDecorridos();
+                if (salvarJogo(caminho, &territorios, fronteiras, &gerador, semente))
+                {
+                    printf("Jogo salvo em %s (%d territorios, %.3f ms).\n\n", caminho, territorios.quantidade,
+                           (segundosDecorridos() - inicio) * 1e3);
+                }
+                else
+                {
+                    printf("Erro ao salvar o jogo em %s!\n\n", caminho);
+                }
             }
             break;
 
+        case 9:
+            consultarTerritorios(&territorios);
+            break;
+
         case 0:
             printf("\n===== PROGRAMA FINALIZADO =====\n");
             break;
@@ -171,14 +1717,36 @@ int main()
             printf("\nOpcao invalida! Tente novamente.\n\n");
             break;
         }
+    }
 
-    } while (opcao != 0);
+    // Fecha o diário gravando o hash do estado final
+    if (registroAtivo != NULL && !fecharRegistro(registroAtivo, &territorios))
+    {
+        fprintf(avisos, "Erro ao gravar o diario %s!\n", caminhoRegistro);
+    }
+    if (eventosAtivos != NULL && !fecharEventos(eventosAtivos))
+    {
+        fprintf(avisos, "Erro ao gravar os eventos em %s!\n", caminhoEventos);
+    }
 
-    // Libera a memória alocada
-    liberarMemoria(mapa);
+    // Libera a memória alocada (com arena ou pool, os trechos voltam ao sistema de uma vez)
+    liberarMapa(&territorios);
+    if (fronteiras == &grafo)
+    {
+        liberarGrafo(&grafo);
+    }
+    if (caminhoMapa != NULL)
+    {
+        fecharMapaArquivo(&mapaArquivo);
+    }
+    destruirAlocador(alocadorAtual());
 
-    printf("Pressione ENTER para sair...");
-    getchar();
+    // No modo de comandos a entrada padrão pode ser o próprio lote: não há o que esperar
+    if (caminhoComandos == NULL)
+    {
+        printf("Pressione ENTER para sair...");
+        getchar();
+    }
 
-    return 0;
+    return retorno;
 }
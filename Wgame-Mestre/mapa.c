@@ -0,0 +1,550 @@
+/**
+ * mapa.c - Implementação do mapa de territórios em estrutura de vetores (SoA) e em registros quentes
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include "mapa.h"
+#include "territorio.h"
+#include "listagem.h"
+#include "cores.h"
+#include "nomes.h"
+
+// Capacidade mínima após o primeiro crescimento de um mapa vazio
+#define CAPACIDADE_MINIMA_MAPA 8
+
+/**
+ * Função auxiliar que aloca ou realoca um dos vetores do mapa
+ */
+static void *mudarVetor(Alocador *alocador, void *vetor, size_t bytes, int zerar)
+{
+    if (vetor == NULL)
+    {
+        return alocarMemoria(alocador, bytes, zerar);
+    }
+    return realocarMemoria(alocador, vetor, bytes);
+}
+
+/**
+ * Função auxiliar que muda a capacidade dos três vetores e contabiliza os bytes copiados
+ *
+ * Se um dos vetores não puder ser realocado, os que já mudaram ficam com o novo
+ * tamanho e a capacidade passa a ser a menor entre os três: os territórios em
+ * uso nunca se perdem.
+ */
+static int mudarCapacidade(MapaSoA *mapa, int capacidade)
+{
+    // Só o valor numérico dos endereços sobrevive à realocação
+    uintptr_t tropasAnterior = (uintptr_t)mapa->tropas;
+    uintptr_t donosAnterior = (uintptr_t)mapa->donos;
+    uintptr_t nomesAnterior = (uintptr_t)mapa->nomes;
+    size_t elementos = (size_t)capacidade;
+    int32_t *tropas;
+    uint16_t *donos = NULL;
+    RefNome *nomes = NULL;
+    int primeiro = mapa->tropas == NULL;
+    int zerar = 0;
+
+    if (capacidade == 0)
+    {
+        liberarBloco(mapa->alocador, mapa->nomes);
+        liberarBloco(mapa->alocador, mapa->donos);
+        liberarBloco(mapa->alocador, mapa->tropas);
+        mapa->tropas = NULL;
+        mapa->donos = NULL;
+        mapa->nomes = NULL;
+        mapa->capacidade = 0;
+        mapa->zerados = 0;
+        mapa->bytesMovidos = 0;
+        return 1;
+    }
+
+    // A primeira alocação segue a mesma heurística de alocarTerritorios; as seguintes vêm da realocação
+    if (primeiro)
+    {
+        zerar = escolherTipoAlocacao(capacidade, BYTES_TERRITORIO_MAPA) == USAR_CALLOC ||
+                elementos * BYTES_TERRITORIO_MAPA >= LIMIAR_MAPA_GRANDE;
+    }
+
+    tropas = (int32_t *)mudarVetor(mapa->alocador, mapa->tropas, elementos * sizeof(int32_t), zerar);
+    if (tropas != NULL)
+    {
+        mapa->tropas = tropas;
+        donos = (uint16_t *)mudarVetor(mapa->alocador, mapa->donos, elementos * sizeof(uint16_t), zerar);
+    }
+    if (donos != NULL)
+    {
+        mapa->donos = donos;
+        nomes = (RefNome *)mudarVetor(mapa->alocador, mapa->nomes, elementos * sizeof(RefNome), zerar);
+    }
+    if (nomes == NULL)
+    {
+        if (capacidade < mapa->capacidade)
+        {
+            mapa->capacidade = capacidade;
+        }
+        return 0;
+    }
+    mapa->nomes = nomes;
+
+    // O trecho acrescentado pelo realloc não vem zerado
+    if (primeiro)
+    {
+        mapa->zerados = zerar ? capacidade : 0;
+    }
+    else if (mapa->zerados > capacidade)
+    {
+        mapa->zerados = capacidade;
+    }
+
+    // O realloc só copia os elementos quando não consegue crescer o bloco no lugar
+    mapa->bytesMovidos = 0;
+    if (tropasAnterior != 0 && (uintptr_t)tropas != tropasAnterior)
+    {
+        mapa->bytesMovidos += (size_t)mapa->quantidade * sizeof(int32_t);
+    }
+    if (donosAnterior != 0 && (uintptr_t)donos != donosAnterior)
+    {
+        mapa->bytesMovidos += (size_t)mapa->quantidade * sizeof(uint16_t);
+    }
+    if (nomesAnterior != 0 && (uintptr_t)nomes != nomesAnterior)
+    {
+        mapa->bytesMovidos += (size_t)mapa->quantidade * sizeof(RefNome);
+    }
+    mapa->bytesMovidosTotal += mapa->bytesMovidos;
+    mapa->realocacoes++;
+
+    mapa->capacidade = capacidade;
+    return 1;
+}
+
+/**
+ * Função para criar um mapa vazio com uma capacidade inicial
+ */
+int iniciarMapa(MapaSoA *mapa, int capacidade)
+{
+    memset(mapa, 0, sizeof(MapaSoA));
+    mapa->alocador = alocadorAtual();
+    return capacidade <= 0 || mudarCapacidade(mapa, capacidade);
+}
+
+/**
+ * Função para garantir capacidade para pelo menos 'capacidade' territórios
+ */
+int reservarMapa(MapaSoA *mapa, int capacidade)
+{
+    mapa->bytesMovidos = 0;
+    return capacidade <= mapa->capacidade || mudarCapacidade(mapa, capacidade);
+}
+
+/**
+ * Função para acrescentar territórios zerados ao final do mapa
+ */
+int crescerMapa(MapaSoA *mapa, int novos)
+{
+    int necessario;
+    int limpos;
+    size_t novosLimpos;
+
+    mapa->bytesMovidos = 0;
+    if (novos < 0 || novos > INT_MAX - mapa->quantidade)
+    {
+        return 0;
+    }
+
+    necessario = mapa->quantidade + novos;
+    if (necessario > mapa->capacidade)
+    {
+        int capacidade = CAPACIDADE_MINIMA_MAPA;
+
+        if (mapa->capacidade > INT_MAX / 2)
+        {
+            capacidade = INT_MAX;
+        }
+        else if (mapa->capacidade * 2 > capacidade)
+        {
+            capacidade = mapa->capacidade * 2;
+        }
+
+        if (!mudarCapacidade(mapa, capacidade > necessario ? capacidade : necessario))
+        {
+            return 0;
+        }
+    }
+
+    // Só os novos territórios são zerados, e apenas os que o alocador não entregou zerados
+    limpos = mapa->zerados < necessario ? mapa->zerados : necessario;
+    limpos = limpos > mapa->quantidade ? limpos : mapa->quantidade;
+    novosLimpos = (size_t)(necessario - limpos);
+    if (novosLimpos > 0)
+    {
+        memset(&mapa->tropas[limpos], 0, novosLimpos * sizeof(int32_t));
+        memset(&mapa->donos[limpos], 0, novosLimpos * sizeof(uint16_t));
+        memset(&mapa->nomes[limpos], 0, novosLimpos * sizeof(RefNome));
+    }
+    mapa->quantidade = necessario;
+    return 1;
+}
+
+/**
+ * Função para reduzir a capacidade à quantidade em uso
+ */
+int ajustarMapa(MapaSoA *mapa)
+{
+    mapa->bytesMovidos = 0;
+    return mapa->capacidade == mapa->quantidade || mudarCapacidade(mapa, mapa->quantidade);
+}
+
+/**
+ * Função para liberar os vetores de um mapa
+ */
+void liberarMapa(MapaSoA *mapa)
+{
+    // Ordem inversa da criação: numa arena, cada liberação devolve o último bloco
+    liberarBloco(mapa->alocador, mapa->nomes);
+    liberarBloco(mapa->alocador, mapa->donos);
+    liberarBloco(mapa->alocador, mapa->tropas);
+    memset(mapa, 0, sizeof(MapaSoA));
+}
+
+/**
+ * Função para copiar um território do mapa para a estrutura Territorio
+ */
+void obterTerritorioMapa(const MapaSoA *mapa, int indice, Territorio *territorio)
+{
+    territorio->nome = mapa->nomes[indice];
+    territorio->idCor = mapa->donos[indice];
+    territorio->tropas = mapa->tropas[indice];
+}
+
+/**
+ * Função para gravar uma estrutura Territorio no mapa
+ */
+void guardarTerritorioMapa(MapaSoA *mapa, int indice, const Territorio *territorio)
+{
+    mapa->nomes[indice] = territorio->nome;
+    mapa->donos[indice] = territorio->idCor;
+    mapa->tropas[indice] = territorio->tropas;
+}
+
+/**
+ * Função para cadastrar um território do mapa pelo teclado, como cadastrarTerritorio
+ */
+void cadastrarTerritorioMapa(MapaSoA *mapa, int indice)
+{
+    Territorio territorio;
+
+    memset(&territorio, 0, sizeof(territorio));
+    cadastrarTerritorio(&territorio, indice, mapa->quantidade);
+    guardarTerritorioMapa(mapa, indice, &territorio);
+}
+
+/**
+ * Função para listar todos os territórios do mapa
+ * O texto é montado no buffer da listagem e sai com um write, no formato de exibirTerritorio
+ */
+void listarTerritoriosMapa(const MapaSoA *mapa)
+{
+    FiltroListagem filtro;
+
+    iniciarFiltroListagem(&filtro);
+    renderizarTerritorios(mapa, &filtro, NULL);
+}
+
+/**
+ * Função para somar as tropas de todo o mapa
+ */
+long long somarTropasMapa(const MapaSoA *mapa)
+{
+    const int32_t *tropas = mapa->tropas;
+    long long total = 0;
+
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        total += tropas[i];
+    }
+
+    return total;
+}
+
+/**
+ * Função para contar os territórios e somar as tropas de um dono
+ * A comparação vira máscara para somar sem desvios
+ */
+int contarTerritoriosDono(const MapaSoA *mapa, int dono, long long *tropas)
+{
+    const int32_t *vetorTropas = mapa->tropas;
+    const uint16_t *donos = mapa->donos;
+    long long total = 0;
+    int contagem = 0;
+
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        int32_t mascara = -(int32_t)(donos[i] == dono);
+        contagem -= mascara;
+        total += vetorTropas[i] & mascara;
+    }
+
+    if (tropas != NULL)
+    {
+        *tropas = total;
+    }
+    return contagem;
+}
+
+/**
+ * Função para aplicar atrito a todos os territórios de um dono
+ * Percorre só tropas e donos: a perda de territórios de outros donos é
+ * zerada por máscara, sem desvios nem chamadas por território
+ */
+long long aplicarAtritoDono(MapaSoA *mapa, uint16_t dono, int pontosBase)
+{
+    int32_t *vetorTropas = mapa->tropas;
+    const uint16_t *donos = mapa->donos;
+    long long total = 0;
+
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        int32_t tropas = vetorTropas[i];
+        int32_t mascara = -(int32_t)(donos[i] == dono);
+        int32_t perda = (int32_t)((int64_t)tropas * pontosBase / PONTOS_BASE_TOTAL);
+        int32_t restantes;
+
+        perda = (perda < 1 ? 1 : perda) & mascara;
+        restantes = tropas - perda;
+
+        // Territórios de outros donos mantêm o valor original, mesmo abaixo de 1
+        restantes = restantes < 1 ? 1 : restantes;
+        vetorTropas[i] = (restantes & mascara) | (tropas & ~mascara);
+        total += perda;
+    }
+
+    return total;
+}
+
+// Constantes do hash FNV-1a de 64 bits
+#define FNV_BASE 0xCBF29CE484222325ull
+#define FNV_PRIMO 0x100000001B3ull
+
+/**
+ * Função auxiliar para acumular bytes no hash FNV-1a
+ */
+static uint64_t acumularHash(uint64_t hash, const void *dados, size_t tamanho)
+{
+    const unsigned char *bytes = (const unsigned char *)dados;
+
+    for (size_t i = 0; i < tamanho; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIMO;
+    }
+
+    return hash;
+}
+
+/**
+ * Função para calcular uma assinatura (hash FNV-1a de 64 bits) do estado do mapa
+ */
+uint64_t calcularHashMapa(const MapaSoA *mapa)
+{
+    uint64_t hash = FNV_BASE;
+
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        int32_t tropas = mapa->tropas[i];
+        const char *cor = nomeCor(mapa->donos[i]);
+        const char *nome = textoNome(mapa->nomes[i]);
+
+        // Inclui o terminador para separar nome e cor sem ambiguidade
+        hash = acumularHash(hash, nome, mapa->nomes[i].comprimento + 1);
+        hash = acumularHash(hash, cor, strlen(cor) + 1);
+        hash = acumularHash(hash, &tropas, sizeof(tropas));
+    }
+
+    return hash;
+}
+
+// O registro quente precisa ter exatamente 16 bytes para caberem quatro por linha de cache
+typedef char verificarTamanhoTerritorioQuente[sizeof(TerritorioQuente) == 16 ? 1 : -1];
+
+/**
+ * Função para criar um mapa de registros quentes zerados
+ * Os registros vêm de um bloco com folga para alinhar o início a uma linha de cache
+ */
+int criarMapaQuente(MapaQuente *mapa, int quantidade, Alocador *alocador)
+{
+    size_t elementos = quantidade > 0 ? (size_t)quantidade : 1;
+    uintptr_t endereco;
+
+    memset(mapa, 0, sizeof(MapaQuente));
+    mapa->alocador = alocador != NULL ? alocador : alocadorSistema();
+
+    if (quantidade < 0)
+    {
+        return 0;
+    }
+
+    mapa->bloco = alocarMemoria(mapa->alocador, elementos * sizeof(TerritorioQuente) + LINHA_CACHE_MAPA - 1, 1);
+    mapa->nomes = (RefNome *)alocarMemoria(mapa->alocador, elementos * sizeof(RefNome), 1);
+
+    if (mapa->bloco == NULL || mapa->nomes == NULL)
+    {
+        liberarMapaQuente(mapa);
+        return 0;
+    }
+
+    endereco = ((uintptr_t)mapa->bloco + LINHA_CACHE_MAPA - 1) & ~(uintptr_t)(LINHA_CACHE_MAPA - 1);
+    mapa->quentes = (TerritorioQuente *)((unsigned char *)mapa->bloco + (endereco - (uintptr_t)mapa->bloco));
+    mapa->quantidade = quantidade;
+    return 1;
+}
+
+/**
+ * Função para preencher região e adjacência dos registros quentes a partir do grafo de fronteiras
+ *
+ * A adjacência e o grau vêm direto dos deslocamentos do CSR. As regiões são os
+ * componentes conexos do grafo, numerados por uma busca em largura na ordem dos
+ * territórios; a fila é tirada do alocador do mapa e devolvida no final.
+ */
+int ligarFronteirasQuente(MapaQuente *mapa, const GrafoFronteiras *grafo)
+{
+    TerritorioQuente *quentes = mapa->quentes;
+    int *fila;
+    int regioes = 0;
+
+    if (grafo->quantidade != mapa->quantidade)
+    {
+        return 0;
+    }
+
+    fila = (int *)alocarMemoria(mapa->alocador, (size_t)(mapa->quantidade > 0 ? mapa->quantidade : 1) * sizeof(int), 0);
+    if (fila == NULL)
+    {
+        return 0;
+    }
+
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        quentes[i].adjacencia = grafo->deslocamentos[i];
+        quentes[i].grau = grafo->deslocamentos[i + 1] - grafo->deslocamentos[i];
+        quentes[i].regiao = UINT16_MAX;
+    }
+
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        uint16_t regiao;
+        int inicio = 0, fim = 0;
+
+        if (quentes[i].regiao != UINT16_MAX)
+        {
+            continue;
+        }
+
+        // A partir de UINT16_MAX componentes, os restantes dividem o último identificador
+        regiao = regioes < UINT16_MAX ? (uint16_t)regioes++ : UINT16_MAX;
+        quentes[i].regiao = regiao;
+        fila[fim++] = i;
+
+        while (inicio < fim)
+        {
+            const TerritorioQuente *atual = &quentes[fila[inicio++]];
+
+            for (uint32_t k = 0; k < atual->grau; k++)
+            {
+                int vizinho = (int)grafo->vizinhos[atual->adjacencia + k];
+                if (quentes[vizinho].regiao != regiao)
+                {
+                    quentes[vizinho].regiao = regiao;
+                    fila[fim++] = vizinho;
+                }
+            }
+        }
+    }
+
+    liberarBloco(mapa->alocador, fila);
+    return 1;
+}
+
+/**
+ * Função para liberar os vetores de um mapa de registros quentes
+ */
+void liberarMapaQuente(MapaQuente *mapa)
+{
+    if (mapa->alocador == NULL)
+    {
+        return;
+    }
+
+    // Ordem inversa da criação: numa arena, cada liberação devolve o último bloco
+    liberarBloco(mapa->alocador, mapa->nomes);
+    liberarBloco(mapa->alocador, mapa->bloco);
+    mapa->quentes = NULL;
+    mapa->nomes = NULL;
+    mapa->bloco = NULL;
+    mapa->quantidade = 0;
+}
+
+/**
+ * Função para copiar um território do mapa quente para a estrutura Territorio
+ */
+void obterTerritorioQuente(const MapaQuente *mapa, int indice, Territorio *territorio)
+{
+    territorio->nome = mapa->nomes[indice];
+    territorio->idCor = mapa->quentes[indice].dono;
+    territorio->tropas = mapa->quentes[indice].tropas;
+}
+
+/**
+ * Função para gravar uma estrutura Territorio no mapa quente
+ * Região, adjacência e grau vêm do grafo e não são alterados
+ */
+void guardarTerritorioQuente(MapaQuente *mapa, int indice, const Territorio *territorio)
+{
+    mapa->nomes[indice] = territorio->nome;
+    mapa->quentes[indice].dono = territorio->idCor;
+    mapa->quentes[indice].tropas = territorio->tropas;
+}
+
+/**
+ * Função para somar as tropas de todo o mapa quente
+ */
+long long somarTropasQuente(const MapaQuente *mapa)
+{
+    const TerritorioQuente *quentes = mapa->quentes;
+    long long total = 0;
+
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        total += quentes[i].tropas;
+    }
+
+    return total;
+}
+
+/**
+ * Função para contar os territórios e somar as tropas de um dono no mapa quente
+ * Mesma máscara de contarTerritoriosDono, lendo os dois campos da mesma linha de cache
+ */
+int contarTerritoriosDonoQuente(const MapaQuente *mapa, int dono, long long *tropas)
+{
+    const TerritorioQuente *quentes = mapa->quentes;
+    long long total = 0;
+    int contagem = 0;
+
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        int32_t mascara = -(int32_t)(quentes[i].dono == dono);
+        contagem -= mascara;
+        total += quentes[i].tropas & mascara;
+    }
+
+    if (tropas != NULL)
+    {
+        *tropas = total;
+    }
+    return contagem;
+}
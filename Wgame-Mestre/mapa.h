@@ -0,0 +1,260 @@
+/**
+ * mapa.h - Mapa de territórios em estrutura de vetores (SoA) e em registros quentes
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef MAPA_H
+#define MAPA_H
+
+#include <stdint.h>
+#include "territorio.h"
+#include "cores.h"
+#include "nomes.h"
+#include "alocacao.h"
+#include "fronteiras.h"
+
+/**
+ * Mapa de territórios da sessão, com cada campo num vetor próprio
+ * - tropas: tropas de cada território, contíguas
+ * - donos: identificador da cor de cada território (ver cores.h)
+ * - nomes: referências aos nomes na arena padrão, consultadas apenas na exibição
+ * - quantidade/capacidade: territórios em uso e territórios alocados em cada vetor
+ * - bytesMovidos: bytes copiados pela última operação sobre o mapa (0 se não houve
+ *   realocação ou se os vetores cresceram no lugar)
+ * - bytesMovidosTotal/realocacoes: totais acumulados desde a criação do mapa
+ * - zerados: posições [quantidade..zerados-1] dos vetores já vieram zeradas do
+ *   alocador (primeira alocação a partir de LIMIAR_MAPA_GRANDE), então o
+ *   crescimento não as apaga de novo
+ * - alocador: alocador atual no momento da criação, usado em todas as realocações
+ *
+ * Varreduras sobre tropas ou donos (atrito, filtros da listagem, contagens)
+ * percorrem só 4 ou 2 bytes por território, em vez dos 16 bytes de cada
+ * Territorio. Um território avulso é lido e gravado com obterTerritorioMapa e
+ * guardarTerritorioMapa; os índices são estáveis, mas os vetores podem mudar de
+ * endereço a cada crescimento.
+ */
+typedef struct
+{
+    Alocador *alocador;
+    int32_t *tropas;
+    uint16_t *donos;
+    RefNome *nomes;
+    int quantidade;
+    int capacidade;
+    size_t bytesMovidos;
+    size_t bytesMovidosTotal;
+    int realocacoes;
+    int zerados;
+} MapaSoA;
+
+// Bytes ocupados por um território somando os três vetores do MapaSoA
+#define BYTES_TERRITORIO_MAPA (sizeof(int32_t) + sizeof(uint16_t) + sizeof(RefNome))
+
+/**
+ * Função para criar um mapa vazio com uma capacidade inicial
+ * @param mapa Ponteiro para o mapa
+ * @param capacidade Quantidade de territórios a reservar (0 não aloca nada)
+ * @return 1 em caso de sucesso, 0 se faltar memória
+ */
+int iniciarMapa(MapaSoA *mapa, int capacidade);
+
+/**
+ * Função para garantir capacidade para pelo menos 'capacidade' territórios
+ * @param mapa Ponteiro para o mapa
+ * @param capacidade Capacidade mínima desejada
+ * @return 1 em caso de sucesso, 0 se faltar memória (os territórios ficam inalterados)
+ */
+int reservarMapa(MapaSoA *mapa, int capacidade);
+
+/**
+ * Função para acrescentar territórios zerados ao final do mapa
+ *
+ * Quando falta espaço, a capacidade dobra (ou vai direto ao necessário, se
+ * for maior), então acrescentar um território de cada vez custa O(1) amortizado.
+ *
+ * @param mapa Ponteiro para o mapa
+ * @param novos Quantidade de territórios a acrescentar
+ * @return 1 em caso de sucesso, 0 se faltar memória (os territórios ficam inalterados)
+ */
+int crescerMapa(MapaSoA *mapa, int novos);
+
+/**
+ * Função para reduzir a capacidade à quantidade em uso
+ * @param mapa Ponteiro para o mapa
+ * @return 1 em caso de sucesso, 0 se a realocação falhar (os territórios ficam inalterados)
+ */
+int ajustarMapa(MapaSoA *mapa);
+
+/**
+ * Função para liberar os vetores de um mapa
+ * @param mapa Ponteiro para o mapa
+ */
+void liberarMapa(MapaSoA *mapa);
+
+/**
+ * Função para copiar um território do mapa para a estrutura Territorio
+ * @param mapa Ponteiro para o mapa
+ * @param indice Índice do território
+ * @param territorio Ponteiro para a estrutura que receberá os dados
+ */
+void obterTerritorioMapa(const MapaSoA *mapa, int indice, Territorio *territorio);
+
+/**
+ * Função para gravar uma estrutura Territorio no mapa
+ * @param mapa Ponteiro para o mapa
+ * @param indice Índice do território
+ * @param territorio Ponteiro para os dados a gravar
+ */
+void guardarTerritorioMapa(MapaSoA *mapa, int indice, const Territorio *territorio);
+
+/**
+ * Função para cadastrar um território do mapa pelo teclado, como cadastrarTerritorio
+ * @param mapa Ponteiro para o mapa
+ * @param indice Índice do território (o total exibido é a quantidade do mapa)
+ */
+void cadastrarTerritorioMapa(MapaSoA *mapa, int indice);
+
+/**
+ * Função para listar todos os territórios do mapa, no formato de exibirTerritorio
+ * @param mapa Ponteiro para o mapa
+ */
+void listarTerritoriosMapa(const MapaSoA *mapa);
+
+/**
+ * Função para somar as tropas de todo o mapa
+ * @param mapa Ponteiro para o mapa
+ * @return Total de tropas
+ */
+long long somarTropasMapa(const MapaSoA *mapa);
+
+/**
+ * Função para contar os territórios e somar as tropas de um dono
+ * @param mapa Ponteiro para o mapa
+ * @param dono Identificador da cor
+ * @param tropas Ponteiro para receber o total de tropas do dono (pode ser NULL)
+ * @return Quantidade de territórios do dono
+ */
+int contarTerritoriosDono(const MapaSoA *mapa, int dono, long long *tropas);
+
+/**
+ * Função para aplicar atrito a todos os territórios de um dono
+ *
+ * Mesma regra de reduzirTropasPB, num laço único sem desvios sobre os vetores
+ * de tropas e donos: os demais territórios recebem perda zero por máscara.
+ *
+ * @param mapa Ponteiro para o mapa
+ * @param dono Identificador da cor do exército afetado
+ * @param pontosBase Percentual de perda em pontos-base
+ * @return Total de tropas perdidas
+ */
+long long aplicarAtritoDono(MapaSoA *mapa, uint16_t dono, int pontosBase);
+
+/**
+ * Função para calcular uma assinatura (hash FNV-1a de 64 bits) do estado do mapa
+ *
+ * Considera nome, nome da cor e tropas de cada território, campo a campo, então
+ * o valor não depende da disposição dos vetores na memória nem da ordem em que
+ * as cores foram cadastradas.
+ *
+ * @param mapa Ponteiro para o mapa
+ * @return Assinatura do estado atual do mapa
+ */
+uint64_t calcularHashMapa(const MapaSoA *mapa);
+
+// Tamanho da linha de cache a que o vetor de registros quentes é alinhado
+#define LINHA_CACHE_MAPA 64
+
+/**
+ * Registro quente de um território, usado pelas partidas automáticas
+ * - tropas: quantidade de tropas
+ * - dono: identificador da cor do exército (ver cores.h)
+ * - regiao: componente conexo do grafo de fronteiras a que o território pertence
+ *           (0 sem grafo; satura em UINT16_MAX)
+ * - adjacencia: posição dos vizinhos no vetor 'vizinhos' do grafo (deslocamentos[i])
+ * - grau: quantidade de vizinhos (0 sem grafo)
+ *
+ * Com o vetor alinhado em 64 bytes, quatro territórios dividem exatamente uma linha
+ * de cache. Na partida automática, combate, reforço, escolha do alvo e verificação
+ * de vitória só leem esse registro e, com fronteiras, a lista de vizinhos.
+ */
+typedef struct
+{
+    int32_t tropas;
+    uint16_t dono;
+    uint16_t regiao;
+    uint32_t adjacencia;
+    uint32_t grau;
+} TerritorioQuente;
+
+/**
+ * Mapa de territórios com os dados quentes separados dos descritivos
+ * - quentes: registros quentes, alinhados em LINHA_CACHE_MAPA bytes
+ * - nomes: referências aos nomes na arena padrão, consultadas apenas na exibição
+ * - bloco: início do bloco alocado (quentes é alinhado dentro dele)
+ * - alocador: de onde vieram os vetores, usado também para liberá-los
+ */
+typedef struct
+{
+    TerritorioQuente *quentes;
+    RefNome *nomes;
+    int quantidade;
+    void *bloco;
+    Alocador *alocador;
+} MapaQuente;
+
+/**
+ * Função para criar um mapa de registros quentes zerados
+ * @param mapa Ponteiro para o mapa a ser inicializado
+ * @param quantidade Quantidade de territórios
+ * @param alocador Alocador dos vetores (NULL usa o do sistema)
+ * @return 1 em caso de sucesso, 0 se faltar memória
+ */
+int criarMapaQuente(MapaQuente *mapa, int quantidade, Alocador *alocador);
+
+/**
+ * Função para preencher região e adjacência dos registros quentes a partir do grafo de fronteiras
+ * @param mapa Ponteiro para o mapa
+ * @param grafo Grafo de fronteiras com a mesma quantidade de territórios do mapa
+ * @return 1 em caso de sucesso, 0 se o grafo não corresponder ao mapa ou faltar memória
+ */
+int ligarFronteirasQuente(MapaQuente *mapa, const GrafoFronteiras *grafo);
+
+/**
+ * Função para liberar os vetores de um mapa de registros quentes
+ * @param mapa Ponteiro para o mapa
+ */
+void liberarMapaQuente(MapaQuente *mapa);
+
+/**
+ * Função para copiar um território do mapa quente para a estrutura Territorio
+ * @param mapa Ponteiro para o mapa
+ * @param indice Índice do território
+ * @param territorio Ponteiro para a estrutura que receberá os dados
+ */
+void obterTerritorioQuente(const MapaQuente *mapa, int indice, Territorio *territorio);
+
+/**
+ * Função para gravar uma estrutura Territorio no mapa quente
+ * @param mapa Ponteiro para o mapa
+ * @param indice Índice do território
+ * @param territorio Ponteiro para os dados a gravar
+ */
+void guardarTerritorioQuente(MapaQuente *mapa, int indice, const Territorio *territorio);
+
+/**
+ * Função para somar as tropas de todo o mapa quente
+ * @param mapa Ponteiro para o mapa
+ * @return Total de tropas
+ */
+long long somarTropasQuente(const MapaQuente *mapa);
+
+/**
+ * Função para contar os territórios e somar as tropas de um dono no mapa quente
+ * @param mapa Ponteiro para o mapa
+ * @param dono Identificador da cor
+ * @param tropas Ponteiro para receber o total de tropas do dono (pode ser NULL)
+ * @return Quantidade de territórios do dono
+ */
+int contarTerritoriosDonoQuente(const MapaQuente *mapa, int dono, long long *tropas);
+
+#endif /* MAPA_H */
@@ -0,0 +1,284 @@
+/**
+ * montecarlo.c - Implementação da estimativa por Monte Carlo
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "montecarlo.h"
+#include "combate.h"
+#include "territorio.h"
+#include "aleatorio.h"
+
+// Valor z para intervalos de confiança de 95%
+#define Z_95 1.959963984540054
+
+/**
+ * Estrutura de trabalho de cada thread: uma faixa contígua de blocos
+ * Cada thread escreve apenas na sua própria parcial, então não há travas
+ */
+typedef struct
+{
+    const ConfiguracaoMonteCarlo *configuracao;
+    long long primeiroBloco;
+    long long blocos;
+    EstatisticasMonteCarlo parcial;
+} TrabalhoMonteCarlo;
+
+/**
+ * Função auxiliar que simula as batalhas de um bloco e acumula as somas na parcial
+ */
+static void simularBloco(const ConfiguracaoMonteCarlo *configuracao, long long bloco, EstatisticasMonteCarlo *parcial)
+{
+    FonteDadosLote fonte;
+    Territorio atacante = {{0, 0}, 0, 0};
+    Territorio defensor = {{0, 0}, 1, 0};
+    ResultadoBatalha batalha;
+    long long inicio = bloco * MC_BATALHAS_POR_BLOCO;
+    long long fim = inicio + MC_BATALHAS_POR_BLOCO < configuracao->tentativas ? inicio + MC_BATALHAS_POR_BLOCO
+                                                                               : configuracao->tentativas;
+
+    // Os dados vêm do gerador vetorizado, milhares por vez; o gerador depende só do número do bloco
+    iniciarFonteDadosLote(&fonte, derivarSemente(configuracao->semente, (uint64_t)bloco));
+
+    for (long long i = inicio; i < fim; i++)
+    {
+        atacante.tropas = configuracao->tropasAtacante;
+        defensor.tropas = configuracao->tropasDefensor;
+        defensor.idCor = 1;
+
+        simularBatalhaLote(&atacante, &defensor, configuracao->tropasMinimas, &fonte, &batalha);
+
+        if (batalha.conquistado)
+        {
+            long long rodadas = batalha.rodadas;
+            int faixa = batalha.rodadas < MC_FAIXAS_RODADAS ? batalha.rodadas : MC_FAIXAS_RODADAS - 1;
+
+            parcial->conquistas++;
+            parcial->somaRodadasConquista += rodadas;
+            parcial->somaQuadradoRodadasConquista += rodadas * rodadas;
+            parcial->histogramaRodadas[faixa]++;
+        }
+        else
+        {
+            // Tropas restantes do defensor só contam se ele não foi conquistado
+            long long restantes = defensor.tropas;
+            parcial->somaSobreviventesDefensor += restantes;
+            parcial->somaQuadradoSobreviventesDefensor += restantes * restantes;
+        }
+
+        parcial->somaSobreviventesAtacante += atacante.tropas;
+        parcial->somaQuadradoSobreviventesAtacante += (long long)atacante.tropas * atacante.tropas;
+    }
+
+    parcial->tentativas += fim - inicio;
+}
+
+/**
+ * Função executada por cada thread: simula os blocos da sua fatia
+ */
+static void *executarFatia(void *argumento)
+{
+    TrabalhoMonteCarlo *trabalho = (TrabalhoMonteCarlo *)argumento;
+    EstatisticasMonteCarlo acumulado;
+
+    // Acumula numa cópia local para que threads vizinhas não disputem a mesma linha de cache
+    memset(&acumulado, 0, sizeof(acumulado));
+
+    for (long long bloco = trabalho->primeiroBloco; bloco < trabalho->primeiroBloco + trabalho->blocos; bloco++)
+    {
+        simularBloco(trabalho->configuracao, bloco, &acumulado);
+    }
+
+    trabalho->parcial = acumulado;
+    return NULL;
+}
+
+/**
+ * Função auxiliar para somar uma parcial ao total
+ */
+static void combinarEstatisticas(EstatisticasMonteCarlo *total, const EstatisticasMonteCarlo *parcial)
+{
+    total->tentativas += parcial->tentativas;
+    total->conquistas += parcial->conquistas;
+    total->somaRodadasConquista += parcial->somaRodadasConquista;
+    total->somaQuadradoRodadasConquista += parcial->somaQuadradoRodadasConquista;
+    total->somaSobreviventesAtacante += parcial->somaSobreviventesAtacante;
+    total->somaQuadradoSobreviventesAtacante += parcial->somaQuadradoSobreviventesAtacante;
+    total->somaSobreviventesDefensor += parcial->somaSobreviventesDefensor;
+    total->somaQuadradoSobreviventesDefensor += parcial->somaQuadradoSobreviventesDefensor;
+
+    for (int i = 0; i < MC_FAIXAS_RODADAS; i++)
+    {
+        total->histogramaRodadas[i] += parcial->histogramaRodadas[i];
+    }
+}
+
+/**
+ * Função para executar as batalhas em paralelo e agregar as estatísticas
+ */
+int executarMonteCarlo(const ConfiguracaoMonteCarlo *configuracao, EstatisticasMonteCarlo *saida)
+{
+    int threads = configuracao->threads;
+    long long blocos = (configuracao->tentativas + MC_BATALHAS_POR_BLOCO - 1) / MC_BATALHAS_POR_BLOCO;
+    long long primeiroBloco = 0;
+    TrabalhoMonteCarlo *trabalhos;
+    pthread_t *identificadores;
+    int iniciadas = 0;
+
+    memset(saida, 0, sizeof(EstatisticasMonteCarlo));
+
+    if (threads <= 0)
+    {
+        long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = nucleos > 0 ? (int)nucleos : 1;
+    }
+    if (threads > blocos)
+    {
+        threads = blocos > 0 ? (int)blocos : 1;
+    }
+
+    trabalhos = (TrabalhoMonteCarlo *)calloc(threads, sizeof(TrabalhoMonteCarlo));
+    identificadores = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    if (trabalhos == NULL || identificadores == NULL)
+    {
+        free(trabalhos);
+        free(identificadores);
+        return 0;
+    }
+
+    // Divide os blocos em fatias contíguas quase iguais, uma por thread
+    for (int i = 0; i < threads; i++)
+    {
+        trabalhos[i].configuracao = configuracao;
+        trabalhos[i].primeiroBloco = primeiroBloco;
+        trabalhos[i].blocos = blocos / threads + (i < blocos % threads ? 1 : 0);
+        primeiroBloco += trabalhos[i].blocos;
+    }
+
+    // A thread principal executa a fatia 0; as demais rodam em paralelo
+    for (int i = 1; i < threads; i++)
+    {
+        if (pthread_create(&identificadores[i], NULL, executarFatia, &trabalhos[i]) != 0)
+        {
+            break;
+        }
+        iniciadas = i;
+    }
+    executarFatia(&trabalhos[0]);
+
+    // Fatias cujas threads não puderam ser criadas são executadas aqui mesmo
+    for (int i = iniciadas + 1; i < threads; i++)
+    {
+        executarFatia(&trabalhos[i]);
+    }
+
+    for (int i = 1; i <= iniciadas; i++)
+    {
+        pthread_join(identificadores[i], NULL);
+    }
+
+    // Combina as parciais somente depois que todas as threads terminaram
+    for (int i = 0; i < threads; i++)
+    {
+        combinarEstatisticas(saida, &trabalhos[i].parcial);
+    }
+
+    free(trabalhos);
+    free(identificadores);
+
+    return threads;
+}
+
+/**
+ * Função auxiliar para exibir uma média com intervalo de confiança de 95%
+ */
+static void exibirMedia(const char *rotulo, long long soma, long long somaQuadrados, long long amostras)
+{
+    if (amostras == 0)
+    {
+        printf("%s: sem amostras\n", rotulo);
+        return;
+    }
+
+    double media = (double)soma / amostras;
+    double variancia = (double)somaQuadrados / amostras - media * media;
+    double margem = amostras > 1 ? Z_95 * sqrt((variancia > 0 ? variancia : 0) / (amostras - 1)) : 0.0;
+
+    printf("%s: %.3f (IC95%%: %.3f a %.3f)\n", rotulo, media, media - margem, media + margem);
+}
+
+/**
+ * Função auxiliar para encontrar o percentil no histograma de rodadas
+ */
+static int percentilRodadas(const EstatisticasMonteCarlo *estatisticas, double fracao)
+{
+    long long alvo = (long long)ceil(fracao * estatisticas->conquistas);
+    long long acumulado = 0;
+
+    for (int i = 0; i < MC_FAIXAS_RODADAS; i++)
+    {
+        acumulado += estatisticas->histogramaRodadas[i];
+        if (acumulado >= alvo && acumulado > 0)
+        {
+            return i;
+        }
+    }
+
+    return MC_FAIXAS_RODADAS - 1;
+}
+
+/**
+ * Função para exibir as estimativas com intervalos de confiança de 95%
+ */
+void exibirMonteCarlo(const ConfiguracaoMonteCarlo *configuracao, const EstatisticasMonteCarlo *estatisticas)
+{
+    long long n = estatisticas->tentativas;
+    long long naoConquistadas = n - estatisticas->conquistas;
+
+    printf("\n===================================\n");
+    printf("     ESTIMATIVA MONTE CARLO       \n");
+    printf("===================================\n");
+    printf("Atacante: %d tropas (piso %d) | Defensor: %d tropas\n",
+           configuracao->tropasAtacante, configuracao->tropasMinimas, configuracao->tropasDefensor);
+    printf("Batalhas simuladas: %lld\n\n", n);
+
+    if (n == 0)
+    {
+        printf("Nenhuma batalha simulada.\n");
+        return;
+    }
+
+    // Intervalo de Wilson: bem comportado mesmo para probabilidades próximas de 0 ou 1
+    double p = (double)estatisticas->conquistas / n;
+    double z2 = Z_95 * Z_95;
+    double centro = (p + z2 / (2.0 * n)) / (1.0 + z2 / n);
+    double margem = Z_95 * sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * (double)n)) / (1.0 + z2 / n);
+
+    printf("Probabilidade de conquista: %.4f (IC95%%: %.4f a %.4f)\n", p, centro - margem, centro + margem);
+
+    exibirMedia("Rodadas ate a conquista (media)", estatisticas->somaRodadasConquista,
+                estatisticas->somaQuadradoRodadasConquista, estatisticas->conquistas);
+
+    if (estatisticas->conquistas > 0)
+    {
+        int limite = MC_FAIXAS_RODADAS - 1;
+        printf("Rodadas ate a conquista (percentis): p10=%d p50=%d p90=%d p99=%d%s\n",
+               percentilRodadas(estatisticas, 0.10), percentilRodadas(estatisticas, 0.50),
+               percentilRodadas(estatisticas, 0.90), percentilRodadas(estatisticas, 0.99),
+               estatisticas->histogramaRodadas[limite] > 0 ? " (ultima faixa acumula valores maiores)" : "");
+    }
+
+    exibirMedia("Tropas restantes do atacante", estatisticas->somaSobreviventesAtacante,
+                estatisticas->somaQuadradoSobreviventesAtacante, n);
+    exibirMedia("Tropas restantes do defensor (quando resiste)", estatisticas->somaSobreviventesDefensor,
+                estatisticas->somaQuadradoSobreviventesDefensor, naoConquistadas);
+
+    printf("===================================\n\n");
+}
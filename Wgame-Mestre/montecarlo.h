@@ -0,0 +1,71 @@
+/**
+ * montecarlo.h - Estimativa por Monte Carlo da probabilidade de conquista
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include <stdint.h>
+
+// Quantidade de faixas do histograma de rodadas; a última acumula os valores maiores
+#define MC_FAIXAS_RODADAS 256
+
+// Batalhas por bloco; cada bloco sorteia com um gerador em lote próprio, derivado da semente e do número do bloco
+#define MC_BATALHAS_POR_BLOCO 16384
+
+/**
+ * Estrutura com as somas parciais de um conjunto de batalhas simuladas
+ *
+ * Todas as somas são inteiras, então o resultado agregado não depende da ordem
+ * em que as parciais são combinadas. Como os dados de cada bloco de batalhas
+ * vêm de um gerador próprio do bloco, o resultado também não depende da
+ * quantidade de threads: só da semente e da quantidade de tentativas.
+ */
+typedef struct
+{
+    long long tentativas;
+    long long conquistas;
+    long long somaRodadasConquista;
+    long long somaQuadradoRodadasConquista;
+    long long somaSobreviventesAtacante;
+    long long somaQuadradoSobreviventesAtacante;
+    long long somaSobreviventesDefensor;
+    long long somaQuadradoSobreviventesDefensor;
+    long long histogramaRodadas[MC_FAIXAS_RODADAS];
+} EstatisticasMonteCarlo;
+
+/**
+ * Estrutura com os parâmetros de uma estimativa
+ * - tropasAtacante/tropasDefensor: tropas iniciais de cada lado
+ * - tropasMinimas: piso de tropas abaixo do qual o atacante desiste
+ * - tentativas: quantidade de batalhas independentes
+ * - threads: quantidade de threads (0 usa todos os núcleos disponíveis)
+ * - semente: semente comum; cada bloco de MC_BATALHAS_POR_BLOCO batalhas usa um gerador derivado dela
+ */
+typedef struct
+{
+    int tropasAtacante;
+    int tropasDefensor;
+    int tropasMinimas;
+    long long tentativas;
+    int threads;
+    uint64_t semente;
+} ConfiguracaoMonteCarlo;
+
+/**
+ * Função para executar as batalhas em paralelo e agregar as estatísticas
+ * @param configuracao Parâmetros da estimativa
+ * @param saida Ponteiro para a estrutura que receberá as somas agregadas
+ * @return Quantidade de threads efetivamente usadas, ou 0 em caso de falha
+ */
+int executarMonteCarlo(const ConfiguracaoMonteCarlo *configuracao, EstatisticasMonteCarlo *saida);
+
+/**
+ * Função para exibir as estimativas com intervalos de confiança de 95%
+ * @param configuracao Parâmetros usados na estimativa
+ * @param estatisticas Somas agregadas retornadas por executarMonteCarlo
+ */
+void exibirMonteCarlo(const ConfiguracaoMonteCarlo *configuracao, const EstatisticasMonteCarlo *estatisticas);
+
+#endif /* MONTECARLO_H */
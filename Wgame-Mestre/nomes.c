@@ -0,0 +1,285 @@
+/**
+ * nomes.c - Implementação da arena de nomes de territórios
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "nomes.h"
+
+// Capacidade inicial do bloco de caracteres e do índice de deduplicação
+#define CAPACIDADE_INICIAL_ARENA 1024
+#define POSICOES_INICIAIS_INDICE 64
+
+static ArenaNomes arenaPadrao = {NULL, 0, 0, NULL, 0, 0, 1};
+
+/**
+ * Função auxiliar: hash FNV-1a de 32 bits dos caracteres do nome
+ */
+static uint32_t calcularHashNome(const char *texto, size_t comprimento)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < comprimento; i++)
+    {
+        hash ^= (unsigned char)texto[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * Função auxiliar: garante o byte 0 reservado para o nome vazio
+ */
+static int prepararArena(ArenaNomes *arena)
+{
+    if (arena->dados != NULL)
+    {
+        return 1;
+    }
+
+    arena->dados = (char *)malloc(CAPACIDADE_INICIAL_ARENA);
+    if (arena->dados == NULL)
+    {
+        return 0;
+    }
+
+    arena->dados[0] = '\0';
+    arena->usado = 1;
+    arena->capacidade = CAPACIDADE_INICIAL_ARENA;
+    return 1;
+}
+
+/**
+ * Função para inicializar uma arena vazia
+ */
+void iniciarArenaNomes(ArenaNomes *arena, int deduplicar)
+{
+    memset(arena, 0, sizeof(ArenaNomes));
+    arena->deduplicar = deduplicar;
+}
+
+/**
+ * Função para garantir espaço para mais caracteres sem novas alocações
+ * O bloco cresce por dobra, então guardar nomes um a um custa O(1) amortizado
+ */
+int reservarArenaNomes(ArenaNomes *arena, size_t bytes)
+{
+    size_t necessario;
+    size_t capacidade;
+    char *dados;
+
+    if (!prepararArena(arena))
+    {
+        return 0;
+    }
+
+    necessario = arena->usado + bytes;
+    if (necessario <= arena->capacidade)
+    {
+        return 1;
+    }
+
+    // Os deslocamentos das referências são de 32 bits
+    if (necessario > UINT32_MAX)
+    {
+        return 0;
+    }
+
+    capacidade = arena->capacidade;
+    while (capacidade < necessario)
+    {
+        capacidade *= 2;
+    }
+
+    dados = (char *)realloc(arena->dados, capacidade);
+    if (dados == NULL)
+    {
+        return 0;
+    }
+
+    arena->dados = dados;
+    arena->capacidade = capacidade;
+    return 1;
+}
+
+/**
+ * Função auxiliar: procura o nome no índice de deduplicação
+ * @return Posição do nome ou da vaga onde ele entraria
+ */
+static size_t localizarNome(const ArenaNomes *arena, const char *texto, size_t comprimento, uint32_t *encontrado)
+{
+    size_t mascara = arena->posicoes - 1;
+    size_t posicao = calcularHashNome(texto, comprimento) & mascara;
+
+    for (;;)
+    {
+        uint32_t entrada = arena->indice[posicao];
+
+        // Entrada: deslocamento do nome; 0 indica posição vazia (o nome vazio nunca entra no índice)
+        if (entrada == 0)
+        {
+            *encontrado = 0;
+            return posicao;
+        }
+        // strncmp para no '\0' do nome guardado, então só lê o terminador se os prefixos coincidirem
+        if (strncmp(arena->dados + entrada, texto, comprimento) == 0 && arena->dados[entrada + comprimento] == '\0')
+        {
+            *encontrado = entrada;
+            return posicao;
+        }
+        posicao = (posicao + 1) & mascara;
+    }
+}
+
+/**
+ * Função auxiliar: dobra o índice de deduplicação e reinsere os nomes
+ */
+static int crescerIndice(ArenaNomes *arena)
+{
+    size_t posicoes = arena->posicoes == 0 ? POSICOES_INICIAIS_INDICE : arena->posicoes * 2;
+    uint32_t *antigo = arena->indice;
+    size_t posicoesAntigas = arena->posicoes;
+    uint32_t *novo = (uint32_t *)calloc(posicoes, sizeof(uint32_t));
+
+    if (novo == NULL)
+    {
+        return 0;
+    }
+
+    arena->indice = novo;
+    arena->posicoes = posicoes;
+
+    for (size_t i = 0; i < posicoesAntigas; i++)
+    {
+        if (antigo[i] != 0)
+        {
+            const char *texto = arena->dados + antigo[i];
+            size_t posicao = calcularHashNome(texto, strlen(texto)) & (posicoes - 1);
+
+            while (novo[posicao] != 0)
+            {
+                posicao = (posicao + 1) & (posicoes - 1);
+            }
+            novo[posicao] = antigo[i];
+        }
+    }
+
+    free(antigo);
+    return 1;
+}
+
+/**
+ * Função para guardar um nome na arena
+ */
+int guardarNomeArena(ArenaNomes *arena, const char *texto, size_t comprimento, RefNome *saida)
+{
+    size_t posicao = 0;
+    uint32_t encontrado;
+    const char *terminador = (const char *)memchr(texto, '\0', comprimento);
+
+    saida->deslocamento = 0;
+    saida->comprimento = 0;
+
+    // O nome termina no primeiro '\0', mesmo que o comprimento informado seja maior
+    if (terminador != NULL)
+    {
+        comprimento = (size_t)(terminador - texto);
+    }
+    if (comprimento > COMPRIMENTO_MAXIMO_NOME)
+    {
+        comprimento = COMPRIMENTO_MAXIMO_NOME;
+    }
+    if (comprimento == 0)
+    {
+        return 1;
+    }
+
+    if (arena->deduplicar)
+    {
+        // Mantém a ocupação do índice abaixo de 50%
+        if (2 * (arena->ocupadas + 1) > arena->posicoes && !crescerIndice(arena))
+        {
+            return 0;
+        }
+
+        posicao = localizarNome(arena, texto, comprimento, &encontrado);
+        if (encontrado != 0)
+        {
+            saida->deslocamento = encontrado;
+            saida->comprimento = (uint32_t)comprimento;
+            return 1;
+        }
+    }
+
+    if (!reservarArenaNomes(arena, comprimento + 1))
+    {
+        return 0;
+    }
+
+    saida->deslocamento = (uint32_t)arena->usado;
+    saida->comprimento = (uint32_t)comprimento;
+    memcpy(arena->dados + arena->usado, texto, comprimento);
+    arena->dados[arena->usado + comprimento] = '\0';
+    arena->usado += comprimento + 1;
+
+    if (arena->deduplicar)
+    {
+        arena->indice[posicao] = saida->deslocamento;
+        arena->ocupadas++;
+    }
+
+    return 1;
+}
+
+/**
+ * Função para obter o texto de um nome
+ */
+const char *textoNomeArena(const ArenaNomes *arena, RefNome nome)
+{
+    if (nome.comprimento == 0 || arena->dados == NULL)
+    {
+        return "";
+    }
+    return arena->dados + nome.deslocamento;
+}
+
+/**
+ * Função para liberar a memória de uma arena
+ */
+void liberarArenaNomes(ArenaNomes *arena)
+{
+    int deduplicar = arena->deduplicar;
+
+    free(arena->dados);
+    free(arena->indice);
+    iniciarArenaNomes(arena, deduplicar);
+}
+
+/**
+ * Função para obter a arena padrão, com deduplicação, usada pelos territórios do jogo
+ */
+ArenaNomes *arenaNomesPadrao(void)
+{
+    return &arenaPadrao;
+}
+
+/**
+ * Função para guardar um nome na arena padrão
+ */
+RefNome internarNome(const char *texto)
+{
+    RefNome nome;
+
+    guardarNomeArena(&arenaPadrao, texto, strlen(texto), &nome);
+    return nome;
+}
+
+/**
+ * Função para obter o texto de um nome da arena padrão
+ */
+const char *textoNome(RefNome nome)
+{
+    return textoNomeArena(&arenaPadrao, nome);
+}
@@ -0,0 +1,112 @@
+/**
+ * nomes.h - Arena de nomes de territórios
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef NOMES_H
+#define NOMES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Comprimento máximo de um nome (o diário grava o comprimento em 16 bits)
+#define COMPRIMENTO_MAXIMO_NOME 65535
+
+/**
+ * Referência a um nome guardado numa arena
+ * - deslocamento: posição do primeiro caractere dentro da arena
+ * - comprimento: quantidade de caracteres, sem o '\0'
+ *
+ * A referência zerada representa o nome vazio em qualquer arena.
+ */
+typedef struct
+{
+    uint32_t deslocamento;
+    uint32_t comprimento;
+} RefNome;
+
+/**
+ * Arena de nomes: todos os textos ficam num único bloco que cresce por dobra
+ * - dados/usado/capacidade: bloco de caracteres; cada nome termina em '\0'
+ * - indice/posicoes/ocupadas: tabela de hash dos nomes, usada só com deduplicação
+ * - deduplicar: se diferente de zero, nomes iguais compartilham o mesmo texto
+ *
+ * As referências guardam deslocamentos, então continuam válidas quando o bloco
+ * é realocado; já os ponteiros devolvidos por textoNomeArena só valem até o
+ * próximo nome guardado.
+ */
+typedef struct
+{
+    char *dados;
+    size_t usado;
+    size_t capacidade;
+    uint32_t *indice;
+    size_t posicoes;
+    size_t ocupadas;
+    int deduplicar;
+} ArenaNomes;
+
+/**
+ * Função para inicializar uma arena vazia
+ * @param arena Ponteiro para a arena
+ * @param deduplicar Diferente de zero para guardar nomes repetidos uma única vez
+ */
+void iniciarArenaNomes(ArenaNomes *arena, int deduplicar);
+
+/**
+ * Função para garantir espaço para mais caracteres sem novas alocações
+ *
+ * Usada nas cargas em massa: uma reserva do total de bytes dos nomes faz com
+ * que o mapa inteiro custe uma única alocação.
+ *
+ * @param arena Ponteiro para a arena
+ * @param bytes Bytes adicionais previstos (contando um '\0' por nome)
+ * @return 1 em caso de sucesso, 0 se faltar memória
+ */
+int reservarArenaNomes(ArenaNomes *arena, size_t bytes);
+
+/**
+ * Função para guardar um nome na arena
+ * @param arena Ponteiro para a arena
+ * @param texto Caracteres do nome (não precisam terminar em '\0')
+ * @param comprimento Quantidade de caracteres (limitada a COMPRIMENTO_MAXIMO_NOME)
+ * @param saida Ponteiro para receber a referência
+ * @return 1 em caso de sucesso, 0 se faltar memória
+ */
+int guardarNomeArena(ArenaNomes *arena, const char *texto, size_t comprimento, RefNome *saida);
+
+/**
+ * Função para obter o texto de um nome
+ * @param arena Ponteiro para a arena que guardou o nome
+ * @param nome Referência do nome
+ * @return Texto terminado em '\0'
+ */
+const char *textoNomeArena(const ArenaNomes *arena, RefNome nome);
+
+/**
+ * Função para liberar a memória de uma arena
+ * @param arena Ponteiro para a arena
+ */
+void liberarArenaNomes(ArenaNomes *arena);
+
+/**
+ * Função para obter a arena padrão, com deduplicação, usada pelos territórios do jogo
+ * @return Ponteiro para a arena padrão
+ */
+ArenaNomes *arenaNomesPadrao(void);
+
+/**
+ * Função para guardar um nome na arena padrão
+ * @param texto Nome terminado em '\0'
+ * @return Referência do nome (o nome vazio se faltar memória)
+ */
+RefNome internarNome(const char *texto);
+
+/**
+ * Função para obter o texto de um nome da arena padrão
+ * @param nome Referência do nome
+ * @return Texto terminado em '\0'
+ */
+const char *textoNome(RefNome nome);
+
+#endif /* NOMES_H */
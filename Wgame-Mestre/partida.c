@@ -0,0 +1,434 @@
+/**
+ * partida.c - Implementação da simulação automática de partidas
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "partida.h"
+#include "territorio.h"
+#include "mapa.h"
+#include "cores.h"
+#include "combate.h"
+#include "aleatorio.h"
+
+// Inimigos sorteados por ataque pelas estratégias que escolhem o mais fraco
+#define AMOSTRAS_ALVO 4
+
+static const char *NOMES_ESTRATEGIAS[TOTAL_ESTRATEGIAS] = {
+    "aleatoria", "agressiva", "cautelosa"};
+
+/**
+ * Estado interno de uma partida em andamento
+ * - mapa: registros quentes dos territórios; o dono de cada um é o índice do jogador,
+ *         que coincide com o identificador da sua cor padrão (ver cores.h)
+ * - vizinhos: listas de vizinhos do grafo de fronteiras, indexadas pela adjacência
+ *             dos registros quentes (NULL sem fronteiras)
+ * - proprios: lista temporária dos territórios do jogador da vez
+ * - contagem: quantidade de territórios de cada jogador
+ */
+typedef struct
+{
+    const ConfiguracaoPartida *configuracao;
+    MapaQuente mapa;
+    const uint32_t *vizinhos;
+    int *proprios;
+    int contagem[MAX_JOGADORES];
+    GeradorAleatorio gerador;
+    ResultadoPartida *resultado;
+} EstadoPartida;
+
+/**
+ * Função para obter o nome de uma estratégia
+ */
+const char *nomeEstrategia(Estrategia estrategia)
+{
+    return (estrategia >= 0 && estrategia < TOTAL_ESTRATEGIAS) ? NOMES_ESTRATEGIAS[estrategia] : "?";
+}
+
+/**
+ * Função para converter um nome em estratégia
+ */
+int lerEstrategia(const char *nome, Estrategia *estrategia)
+{
+    for (int i = 0; i < TOTAL_ESTRATEGIAS; i++)
+    {
+        if (strcmp(nome, NOMES_ESTRATEGIAS[i]) == 0)
+        {
+            *estrategia = (Estrategia)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Função para obter a cor do exército de um jogador
+ */
+const char *corJogador(int jogador)
+{
+    return nomeCor((uint16_t)jogador);
+}
+
+/**
+ * Função auxiliar que gera o mapa: territórios distribuídos igualmente e embaralhados
+ */
+static void gerarMapa(EstadoPartida *estado)
+{
+    const ConfiguracaoPartida *configuracao = estado->configuracao;
+    TerritorioQuente *quentes = estado->mapa.quentes;
+    int n = configuracao->territorios;
+
+    for (int i = 0; i < n; i++)
+    {
+        quentes[i].dono = (uint16_t)(i % configuracao->jogadores);
+    }
+
+    // Embaralhamento de Fisher-Yates dos donos
+    for (int i = n - 1; i > 0; i--)
+    {
+        int j = (int)sortearIntervalo(&estado->gerador, (uint32_t)(i + 1));
+        uint16_t temporario = quentes[i].dono;
+        quentes[i].dono = quentes[j].dono;
+        quentes[j].dono = temporario;
+    }
+
+    // Os nomes ficam vazios: a partida automática nunca exibe o mapa
+    for (int i = 0; i < n; i++)
+    {
+        quentes[i].tropas = configuracao->tropasIniciais;
+        estado->contagem[quentes[i].dono]++;
+    }
+}
+
+/**
+ * Função auxiliar que escolhe um vizinho inimigo de 'origem' pelo grafo de fronteiras
+ *
+ * Mesmo critério de escolherAlvo, restrito à lista de vizinhos apontada pelo
+ * registro quente da origem.
+ *
+ * @return Índice do alvo, ou -1 se nenhum vizinho for inimigo
+ */
+static int escolherVizinho(EstadoPartida *estado, int jogador, int origem, int amostras)
+{
+    const TerritorioQuente *quentes = estado->mapa.quentes;
+    const uint32_t *vizinhos = estado->vizinhos + quentes[origem].adjacencia;
+    uint32_t grau = quentes[origem].grau;
+    int alvo = -1;
+    int encontrados = 0;
+
+    if (grau == 0)
+    {
+        return -1;
+    }
+
+    for (int tentativa = 0; tentativa < 4 * amostras && encontrados < amostras; tentativa++)
+    {
+        int candidato = (int)vizinhos[sortearIntervalo(&estado->gerador, grau)];
+
+        if (quentes[candidato].dono != jogador)
+        {
+            if (alvo < 0 || quentes[candidato].tropas < quentes[alvo].tropas)
+            {
+                alvo = candidato;
+            }
+            encontrados++;
+        }
+    }
+
+    if (alvo < 0)
+    {
+        uint32_t inicio = sortearIntervalo(&estado->gerador, grau);
+        for (uint32_t k = 0; k < grau && alvo < 0; k++)
+        {
+            int candidato = (int)vizinhos[(inicio + k) % grau];
+            if (quentes[candidato].dono != jogador)
+            {
+                alvo = candidato;
+            }
+        }
+    }
+
+    return alvo;
+}
+
+/**
+ * Função auxiliar que escolhe um território inimigo
+ *
+ * Sorteia até 'amostras' inimigos e fica com o mais fraco. Se os sorteios só
+ * encontrarem territórios do próprio jogador, procura linearmente a partir de
+ * uma posição aleatória. Com fronteiras, a escolha fica entre os vizinhos de 'origem'.
+ *
+ * @return Índice do alvo, ou -1 se não houver inimigos
+ */
+static int escolherAlvo(EstadoPartida *estado, int jogador, int origem, int amostras)
+{
+    int n = estado->configuracao->territorios;
+    int alvo = -1;
+    int encontrados = 0;
+
+    if (estado->vizinhos != NULL)
+    {
+        return escolherVizinho(estado, jogador, origem, amostras);
+    }
+
+    for (int tentativa = 0; tentativa < 4 * amostras && encontrados < amostras; tentativa++)
+    {
+        int candidato = (int)sortearIntervalo(&estado->gerador, (uint32_t)n);
+
+        if (estado->mapa.quentes[candidato].dono != jogador)
+        {
+            if (alvo < 0 || estado->mapa.quentes[candidato].tropas < estado->mapa.quentes[alvo].tropas)
+            {
+                alvo = candidato;
+            }
+            encontrados++;
+        }
+    }
+
+    if (alvo < 0 && estado->contagem[jogador] < n)
+    {
+        int inicio = (int)sortearIntervalo(&estado->gerador, (uint32_t)n);
+        for (int k = 0; k < n && alvo < 0; k++)
+        {
+            int candidato = (inicio + k) % n;
+            if (estado->mapa.quentes[candidato].dono != jogador)
+            {
+                alvo = candidato;
+            }
+        }
+    }
+
+    return alvo;
+}
+
+/**
+ * Função auxiliar que resolve o ataque de 'origem' contra 'alvo' e atualiza os donos
+ *
+ * O combate trabalha sobre cópias com as tropas e a cor, sem os nomes, que
+ * depois são gravadas de volta nos registros quentes.
+ *
+ * @param piso Piso de tropas da batalha; 0 resolve uma única rodada
+ */
+static void atacarTerritorio(EstadoPartida *estado, int origem, int alvo, int piso)
+{
+    TerritorioQuente *quenteOrigem = &estado->mapa.quentes[origem];
+    TerritorioQuente *quenteAlvo = &estado->mapa.quentes[alvo];
+    SaidaEventos *eventos = estado->configuracao->eventos;
+    AcompanhamentoEventos acompanhamento;
+    Territorio atacante, defensor;
+    int conquistado;
+
+    atacante.tropas = quenteOrigem->tropas;
+    defensor.tropas = quenteAlvo->tropas;
+    atacante.idCor = quenteOrigem->dono;
+    defensor.idCor = quenteAlvo->dono;
+
+    // Os eventos não consomem números do gerador: a partida é a mesma com ou sem eles
+    if (eventos != NULL)
+    {
+        iniciarAcompanhamentoEventos(&acompanhamento, eventos, &atacante, &defensor, origem, alvo);
+    }
+
+    if (piso == 0)
+    {
+        ResultadoCombate combate;
+        resolverAtaque(&atacante, &defensor, &estado->gerador, &combate);
+        if (eventos != NULL)
+        {
+            emitirEventoObservado(&combate, &acompanhamento);
+        }
+        estado->resultado->ataques++;
+        conquistado = combate.conquistado;
+    }
+    else
+    {
+        ResultadoBatalha batalha;
+        simularBatalhaObservada(&atacante, &defensor, piso, &estado->gerador,
+                                eventos != NULL ? emitirEventoObservado : NULL, &acompanhamento, &batalha);
+        estado->resultado->ataques += batalha.rodadas;
+        conquistado = batalha.conquistado;
+    }
+
+    quenteOrigem->tropas = atacante.tropas;
+    quenteAlvo->tropas = defensor.tropas;
+
+    if (conquistado)
+    {
+        estado->contagem[quenteAlvo->dono]--;
+        estado->contagem[quenteOrigem->dono]++;
+        quenteAlvo->dono = defensor.idCor;
+        estado->resultado->conquistas++;
+    }
+}
+
+/**
+ * Função auxiliar que lista os territórios do jogador e distribui os reforços
+ * Reforço: um terço dos territórios ocupados, com mínimo de 3 tropas
+ * @return Quantidade de territórios do jogador (listados em estado->proprios)
+ */
+static int reforcar(EstadoPartida *estado, int jogador)
+{
+    Estrategia estrategia = estado->configuracao->estrategias[jogador];
+    int quantidade = 0;
+    int escolhido;
+    int reforco;
+
+    for (int i = 0; i < estado->configuracao->territorios; i++)
+    {
+        if (estado->mapa.quentes[i].dono == jogador)
+        {
+            estado->proprios[quantidade++] = i;
+        }
+    }
+
+    if (quantidade == 0)
+    {
+        return 0;
+    }
+
+    reforco = quantidade / 3 < 3 ? 3 : quantidade / 3;
+    escolhido = estado->proprios[sortearIntervalo(&estado->gerador, (uint32_t)quantidade)];
+
+    // A agressiva reforça o território mais forte; a cautelosa, o mais fraco
+    for (int k = 0; k < quantidade && estrategia != ESTRATEGIA_ALEATORIA; k++)
+    {
+        int i = estado->proprios[k];
+        if ((estrategia == ESTRATEGIA_AGRESSIVA && estado->mapa.quentes[i].tropas > estado->mapa.quentes[escolhido].tropas) ||
+            (estrategia == ESTRATEGIA_CAUTELOSA && estado->mapa.quentes[i].tropas < estado->mapa.quentes[escolhido].tropas))
+        {
+            escolhido = i;
+        }
+    }
+
+    estado->mapa.quentes[escolhido].tropas += reforco;
+    return quantidade;
+}
+
+/**
+ * Função auxiliar que joga o turno de um jogador
+ * @return 1 se o jogador dominou o mapa neste turno, 0 caso contrário
+ */
+static int jogarTurno(EstadoPartida *estado, int jogador)
+{
+    Estrategia estrategia = estado->configuracao->estrategias[jogador];
+    int quantidade = reforcar(estado, jogador);
+
+    // Os territórios do jogador não mudam de dono durante o seu próprio turno
+    for (int k = 0; k < quantidade; k++)
+    {
+        int origem = estado->proprios[k];
+        int alvo;
+
+        if (estado->mapa.quentes[origem].tropas <= 1)
+        {
+            continue;
+        }
+
+        switch (estrategia)
+        {
+        case ESTRATEGIA_ALEATORIA:
+            alvo = escolherAlvo(estado, jogador, origem, 1);
+            if (alvo >= 0)
+            {
+                atacarTerritorio(estado, origem, alvo, 0);
+            }
+            break;
+
+        case ESTRATEGIA_AGRESSIVA:
+            alvo = escolherAlvo(estado, jogador, origem, AMOSTRAS_ALVO);
+            if (alvo >= 0)
+            {
+                atacarTerritorio(estado, origem, alvo, 1);
+            }
+            break;
+
+        default:
+            alvo = escolherAlvo(estado, jogador, origem, AMOSTRAS_ALVO);
+            if (alvo >= 0 && estado->mapa.quentes[origem].tropas >= 2 * estado->mapa.quentes[alvo].tropas)
+            {
+                int piso = estado->mapa.quentes[origem].tropas / 2;
+                atacarTerritorio(estado, origem, alvo, piso < 1 ? 1 : piso);
+            }
+            break;
+        }
+
+        if (estado->contagem[jogador] == estado->configuracao->territorios)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Função para jogar uma partida completa sem nenhuma interação
+ */
+int jogarPartida(const ConfiguracaoPartida *configuracao, ResultadoPartida *saida)
+{
+    return jogarPartidaCom(configuracao, alocadorSistema(), saida);
+}
+
+/**
+ * Função para jogar uma partida tirando todo o estado interno de um alocador específico
+ */
+int jogarPartidaCom(const ConfiguracaoPartida *configuracao, Alocador *alocador, ResultadoPartida *saida)
+{
+    EstadoPartida estado;
+    int n = configuracao->territorios;
+
+    memset(saida, 0, sizeof(ResultadoPartida));
+    saida->vencedor = -1;
+
+    if (n < configuracao->jogadores || configuracao->jogadores < 2 ||
+        configuracao->jogadores > MAX_JOGADORES || configuracao->tropasIniciais < 1 ||
+        (configuracao->fronteiras != NULL && configuracao->fronteiras->quantidade != n))
+    {
+        return 0;
+    }
+
+    memset(&estado, 0, sizeof(estado));
+    estado.configuracao = configuracao;
+    estado.resultado = saida;
+    estado.proprios = (int *)alocarMemoria(alocador, n * sizeof(int), 0);
+
+    if (estado.proprios == NULL || !criarMapaQuente(&estado.mapa, n, alocador))
+    {
+        liberarBloco(alocador, estado.proprios);
+        return 0;
+    }
+
+    if (configuracao->fronteiras != NULL)
+    {
+        if (!ligarFronteirasQuente(&estado.mapa, configuracao->fronteiras))
+        {
+            liberarMapaQuente(&estado.mapa);
+            liberarBloco(alocador, estado.proprios);
+            return 0;
+        }
+        estado.vizinhos = configuracao->fronteiras->vizinhos;
+    }
+
+    inicializarGerador(&estado.gerador, configuracao->semente);
+    gerarMapa(&estado);
+
+    for (int turno = 1; turno <= configuracao->maxTurnos && saida->vencedor < 0; turno++)
+    {
+        for (int jogador = 0; jogador < configuracao->jogadores; jogador++)
+        {
+            if (estado.contagem[jogador] > 0 && jogarTurno(&estado, jogador))
+            {
+                saida->vencedor = jogador;
+                break;
+            }
+        }
+        saida->turnos = turno;
+    }
+
+    liberarMapaQuente(&estado.mapa);
+    liberarBloco(alocador, estado.proprios);
+
+    return 1;
+}
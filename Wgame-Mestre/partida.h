@@ -0,0 +1,111 @@
+/**
+ * partida.h - Simulação automática de partidas completas
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef PARTIDA_H
+#define PARTIDA_H
+
+#include <stdint.h>
+#include "alocacao.h"
+#include "eventos.h"
+#include "fronteiras.h"
+
+// Quantidade máxima de jogadores numa partida (um por cor padrão, ver cores.h)
+#define MAX_JOGADORES 6
+
+/**
+ * Estratégias dos jogadores automáticos
+ * - ESTRATEGIA_ALEATORIA: uma rodada contra um inimigo qualquer a partir de cada território
+ * - ESTRATEGIA_AGRESSIVA: ataque relâmpago contra o inimigo mais fraco de uma pequena amostra
+ * - ESTRATEGIA_CAUTELOSA: só ataca com vantagem de 2 para 1 e preserva metade das tropas
+ */
+typedef enum
+{
+    ESTRATEGIA_ALEATORIA,
+    ESTRATEGIA_AGRESSIVA,
+    ESTRATEGIA_CAUTELOSA,
+    TOTAL_ESTRATEGIAS
+} Estrategia;
+
+/**
+ * Parâmetros de uma partida
+ * - territorios: tamanho do mapa gerado
+ * - jogadores: quantidade de jogadores (2 a MAX_JOGADORES)
+ * - tropasIniciais: tropas de cada território no início
+ * - maxTurnos: limite de turnos (a partida termina empatada ao atingi-lo)
+ * - estrategias: estratégia de cada jogador
+ * - semente: semente da partida (mapa inicial e dados)
+ * - eventos: destino dos eventos NDJSON de cada rodada e conquista (NULL desativa);
+ *   não pode ser compartilhado por partidas jogadas em threads diferentes
+ * - fronteiras: grafo com exatamente 'territorios' territórios; com ele, cada território
+ *   só ataca os seus vizinhos (NULL permite atacar qualquer território)
+ */
+typedef struct
+{
+    int territorios;
+    int jogadores;
+    int tropasIniciais;
+    int maxTurnos;
+    Estrategia estrategias[MAX_JOGADORES];
+    uint64_t semente;
+    SaidaEventos *eventos;
+    const GrafoFronteiras *fronteiras;
+} ConfiguracaoPartida;
+
+/**
+ * Resultado de uma partida
+ * - vencedor: índice do jogador que dominou o mapa, ou -1 se o limite de turnos foi atingido
+ * - turnos: turnos completos jogados
+ * - ataques: rodadas de combate resolvidas
+ * - conquistas: territórios que mudaram de dono
+ */
+typedef struct
+{
+    int vencedor;
+    int turnos;
+    long long ataques;
+    long long conquistas;
+} ResultadoPartida;
+
+/**
+ * Função para jogar uma partida completa sem nenhuma interação
+ * @param configuracao Parâmetros da partida
+ * @param saida Ponteiro para a estrutura que receberá o resultado
+ * @return 1 em caso de sucesso, 0 se os parâmetros forem inválidos ou faltar memória
+ */
+int jogarPartida(const ConfiguracaoPartida *configuracao, ResultadoPartida *saida);
+
+/**
+ * Função para jogar uma partida tirando todo o estado interno de um alocador específico
+ * Com uma arena, basta reiniciá-la entre uma partida e outra
+ * @param configuracao Parâmetros da partida
+ * @param alocador Alocador do estado da partida (não é compartilhado entre threads)
+ * @param saida Ponteiro para a estrutura que receberá o resultado
+ * @return 1 em caso de sucesso, 0 se os parâmetros forem inválidos ou faltar memória
+ */
+int jogarPartidaCom(const ConfiguracaoPartida *configuracao, Alocador *alocador, ResultadoPartida *saida);
+
+/**
+ * Função para obter o nome de uma estratégia
+ * @param estrategia Estratégia
+ * @return Nome em texto ("aleatoria", "agressiva" ou "cautelosa")
+ */
+const char *nomeEstrategia(Estrategia estrategia);
+
+/**
+ * Função para converter um nome em estratégia
+ * @param nome Nome em texto
+ * @param estrategia Recebe a estratégia correspondente
+ * @return 1 se o nome é válido, 0 caso contrário
+ */
+int lerEstrategia(const char *nome, Estrategia *estrategia);
+
+/**
+ * Função para obter a cor do exército de um jogador
+ * @param jogador Índice do jogador (0 a MAX_JOGADORES-1)
+ * @return Cor do exército
+ */
+const char *corJogador(int jogador);
+
+#endif /* PARTIDA_H */
@@ -0,0 +1,201 @@
+/**
+ * probabilidades.c - Implementação do cálculo exato do desfecho de batalhas
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "probabilidades.h"
+#include "territorio.h"
+
+// Probabilidades de uma rodada, derivadas da tabela de combinações
+#define P_VITORIA ((double)COMBINACOES_VITORIA_ATACANTE / COMBINACOES_RODADA)
+#define P_DERROTA ((double)COMBINACOES_VITORIA_DEFENSOR / COMBINACOES_RODADA)
+#define P_EMPATE ((double)COMBINACOES_EMPATE / COMBINACOES_RODADA)
+
+/**
+ * Função auxiliar que aplica uma perda percentual usando as mesmas regras do jogo
+ * @param zerou Recebe 1 se as tropas chegariam a zero (conquista), 0 caso contrário
+ * @return Tropas restantes após a perda
+ */
+static int tropasAposPerda(int tropas, int pontosBase, int *zerou)
+{
+    int restantes = tropas - calcularPerdaTropas(tropas, pontosBase);
+
+    *zerou = (restantes <= 0);
+    return restantes < 1 ? 1 : restantes;
+}
+
+/**
+ * Função auxiliar para acessar o estado (atacante, defensor) na tabela
+ */
+static ResultadoExato *estado(SolucionadorBatalha *solucionador, int atacante, int defensor)
+{
+    return &solucionador->tabela[(size_t)atacante * (solucionador->maximoDefensor + 1) + defensor];
+}
+
+/**
+ * Função auxiliar que preenche toda a tabela por programação dinâmica
+ *
+ * Toda rodada reduz o atacante ou o defensor, então percorrer o atacante em
+ * ordem crescente e, dentro dele, o defensor em ordem crescente garante que
+ * os estados seguintes já estejam calculados.
+ */
+static void preencherTabela(SolucionadorBatalha *solucionador)
+{
+    for (int a = 1; a <= solucionador->maximoAtacante; a++)
+    {
+        for (int d = 1; d <= solucionador->maximoDefensor; d++)
+        {
+            ResultadoExato *atual = estado(solucionador, a, d);
+            const ResultadoExato *seguinte;
+            int zerou, aDerrota, aEmpate, dVitoria, dEmpate;
+
+            // Estado absorvente: o atacante não tem mais tropas para atacar
+            if (a <= solucionador->tropasMinimas)
+            {
+                atual->probabilidadeConquista = 0.0;
+                atual->tropasAtacante = a;
+                atual->tropasDefensor = d;
+                atual->rodadas = 0.0;
+                atual->rodadasConquista = 0.0;
+                continue;
+            }
+
+            *atual = (ResultadoExato){0.0, 0.0, 0.0, 1.0, 0.0};
+
+            // Vitória do atacante: defensor perde 15% e pode ser conquistado
+            dVitoria = tropasAposPerda(d, PERDA_VITORIA_PB, &zerou);
+            if (zerou)
+            {
+                atual->probabilidadeConquista += P_VITORIA;
+                atual->tropasAtacante += P_VITORIA * a;
+                atual->rodadasConquista += P_VITORIA;
+            }
+            else
+            {
+                seguinte = estado(solucionador, a, dVitoria);
+                atual->probabilidadeConquista += P_VITORIA * seguinte->probabilidadeConquista;
+                atual->tropasAtacante += P_VITORIA * seguinte->tropasAtacante;
+                atual->tropasDefensor += P_VITORIA * seguinte->tropasDefensor;
+                atual->rodadas += P_VITORIA * seguinte->rodadas;
+                atual->rodadasConquista += P_VITORIA * (seguinte->rodadasConquista + seguinte->probabilidadeConquista);
+            }
+
+            // Vitória do defensor: atacante perde 15%
+            aDerrota = tropasAposPerda(a, PERDA_VITORIA_PB, &zerou);
+            seguinte = estado(solucionador, aDerrota, d);
+            atual->probabilidadeConquista += P_DERROTA * seguinte->probabilidadeConquista;
+            atual->tropasAtacante += P_DERROTA * seguinte->tropasAtacante;
+            atual->tropasDefensor += P_DERROTA * seguinte->tropasDefensor;
+            atual->rodadas += P_DERROTA * seguinte->rodadas;
+            atual->rodadasConquista += P_DERROTA * (seguinte->rodadasConquista + seguinte->probabilidadeConquista);
+
+            // Empate: ambos perdem 5% (o defensor nunca é conquistado no empate)
+            aEmpate = tropasAposPerda(a, PERDA_EMPATE_PB, &zerou);
+            dEmpate = tropasAposPerda(d, PERDA_EMPATE_PB, &zerou);
+            seguinte = estado(solucionador, aEmpate, dEmpate);
+            atual->probabilidadeConquista += P_EMPATE * seguinte->probabilidadeConquista;
+            atual->tropasAtacante += P_EMPATE * seguinte->tropasAtacante;
+            atual->tropasDefensor += P_EMPATE * seguinte->tropasDefensor;
+            atual->rodadas += P_EMPATE * seguinte->rodadas;
+            atual->rodadasConquista += P_EMPATE * (seguinte->rodadasConquista + seguinte->probabilidadeConquista);
+        }
+    }
+}
+
+/**
+ * Função para inicializar um solucionador vazio
+ */
+void inicializarSolucionador(SolucionadorBatalha *solucionador, int tropasMinimas)
+{
+    solucionador->tropasMinimas = tropasMinimas < 1 ? 1 : tropasMinimas;
+    solucionador->maximoAtacante = 0;
+    solucionador->maximoDefensor = 0;
+    solucionador->tabela = NULL;
+}
+
+/**
+ * Função para obter o desfecho exato de uma batalha
+ */
+int resolverBatalhaExata(SolucionadorBatalha *solucionador, int tropasAtacante, int tropasDefensor, ResultadoExato *saida)
+{
+    if (tropasAtacante < 1 || tropasDefensor < 1)
+    {
+        return 0;
+    }
+
+    // Fora da faixa memorizada: amplia a tabela com folga e recalcula
+    if (tropasAtacante > solucionador->maximoAtacante || tropasDefensor > solucionador->maximoDefensor)
+    {
+        int novoAtacante = solucionador->maximoAtacante + solucionador->maximoAtacante / 2;
+        int novoDefensor = solucionador->maximoDefensor + solucionador->maximoDefensor / 2;
+        ResultadoExato *novaTabela;
+
+        if (novoAtacante < tropasAtacante)
+        {
+            novoAtacante = tropasAtacante;
+        }
+        if (novoDefensor < tropasDefensor)
+        {
+            novoDefensor = tropasDefensor;
+        }
+
+        novaTabela = (ResultadoExato *)malloc((size_t)(novoAtacante + 1) * (novoDefensor + 1) * sizeof(ResultadoExato));
+        if (novaTabela == NULL)
+        {
+            return 0;
+        }
+
+        free(solucionador->tabela);
+        solucionador->tabela = novaTabela;
+        solucionador->maximoAtacante = novoAtacante;
+        solucionador->maximoDefensor = novoDefensor;
+        preencherTabela(solucionador);
+    }
+
+    *saida = *estado(solucionador, tropasAtacante, tropasDefensor);
+    return 1;
+}
+
+/**
+ * Função para liberar a tabela do solucionador
+ */
+void liberarSolucionador(SolucionadorBatalha *solucionador)
+{
+    free(solucionador->tabela);
+    solucionador->tabela = NULL;
+    solucionador->maximoAtacante = 0;
+    solucionador->maximoDefensor = 0;
+}
+
+/**
+ * Função para exibir o desfecho exato no mesmo formato da estimativa por Monte Carlo
+ */
+void exibirBatalhaExata(int tropasAtacante, int tropasDefensor, int tropasMinimas, const ResultadoExato *resultado)
+{
+    double resiste = 1.0 - resultado->probabilidadeConquista;
+
+    printf("\n===================================\n");
+    printf("        CALCULO EXATO             \n");
+    printf("===================================\n");
+    printf("Atacante: %d tropas (piso %d) | Defensor: %d tropas\n", tropasAtacante, tropasMinimas, tropasDefensor);
+    printf("Rodada: vitoria %d/%d, empate %d/%d, derrota %d/%d\n\n",
+           COMBINACOES_VITORIA_ATACANTE, COMBINACOES_RODADA, COMBINACOES_EMPATE, COMBINACOES_RODADA,
+           COMBINACOES_VITORIA_DEFENSOR, COMBINACOES_RODADA);
+
+    printf("Probabilidade de conquista: %.6f\n", resultado->probabilidadeConquista);
+    if (resultado->probabilidadeConquista > 0.0)
+    {
+        printf("Rodadas ate a conquista (media): %.3f\n", resultado->rodadasConquista / resultado->probabilidadeConquista);
+    }
+    printf("Rodadas por batalha (media): %.3f\n", resultado->rodadas);
+    printf("Tropas restantes do atacante: %.3f (perda esperada %.3f)\n",
+           resultado->tropasAtacante, tropasAtacante - resultado->tropasAtacante);
+    if (resiste > 0.0)
+    {
+        printf("Tropas restantes do defensor (quando resiste): %.3f\n", resultado->tropasDefensor / resiste);
+    }
+    printf("Perda esperada do defensor: %.3f\n", tropasDefensor - resultado->tropasDefensor);
+    printf("===================================\n\n");
+}
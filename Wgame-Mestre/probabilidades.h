@@ -0,0 +1,85 @@
+/**
+ * probabilidades.h - Cálculo exato do desfecho de batalhas (cadeia de Markov)
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef PROBABILIDADES_H
+#define PROBABILIDADES_H
+
+/**
+ * Tabela de uma rodada derivada das 36 x 36 combinações de dados
+ *
+ * Cada lado lança 2d6; a frequência da soma s (2 a 12) entre as 36 combinações
+ * é 6 - |s - 7|. O empate acontece quando as duas somas coincidem, e como as
+ * distribuições dos dois lados são iguais, vitória e derrota são simétricas.
+ * Todos os valores são constantes calculadas em tempo de compilação.
+ */
+#define COMBINACOES_RODADA (36 * 36)
+#define COMBINACOES_EMPATE (1 * 1 + 2 * 2 + 3 * 3 + 4 * 4 + 5 * 5 + 6 * 6 + 5 * 5 + 4 * 4 + 3 * 3 + 2 * 2 + 1 * 1)
+#define COMBINACOES_VITORIA_ATACANTE ((COMBINACOES_RODADA - COMBINACOES_EMPATE) / 2)
+#define COMBINACOES_VITORIA_DEFENSOR (COMBINACOES_RODADA - COMBINACOES_EMPATE - COMBINACOES_VITORIA_ATACANTE)
+
+/**
+ * Estrutura com os valores esperados de uma batalha a partir de um estado:
+ * - probabilidadeConquista: chance de o defensor ser conquistado
+ * - tropasAtacante: tropas esperadas do atacante ao final
+ * - tropasDefensor: tropas esperadas do defensor ao final (0 quando conquistado)
+ * - rodadas: quantidade esperada de rodadas até o fim da batalha
+ * - rodadasConquista: soma esperada das rodadas nas batalhas que terminam em conquista
+ */
+typedef struct
+{
+    double probabilidadeConquista;
+    double tropasAtacante;
+    double tropasDefensor;
+    double rodadas;
+    double rodadasConquista;
+} ResultadoExato;
+
+/**
+ * Estrutura do solucionador com a tabela memorizada de estados (atacante, defensor)
+ *
+ * A tabela cresce sob demanda; consultas dentro da faixa já calculada são
+ * respondidas diretamente, sem recalcular nada.
+ */
+typedef struct
+{
+    int tropasMinimas;
+    int maximoAtacante;
+    int maximoDefensor;
+    ResultadoExato *tabela;
+} SolucionadorBatalha;
+
+/**
+ * Função para inicializar um solucionador vazio
+ * @param solucionador Ponteiro para o solucionador
+ * @param tropasMinimas Piso de tropas abaixo do qual o atacante deixa de atacar (mínimo 1)
+ */
+void inicializarSolucionador(SolucionadorBatalha *solucionador, int tropasMinimas);
+
+/**
+ * Função para obter o desfecho exato de uma batalha
+ * @param solucionador Ponteiro para o solucionador
+ * @param tropasAtacante Tropas iniciais do atacante
+ * @param tropasDefensor Tropas iniciais do defensor
+ * @param saida Ponteiro para a estrutura que receberá os valores esperados
+ * @return 1 em caso de sucesso, 0 se os parâmetros forem inválidos ou faltar memória
+ */
+int resolverBatalhaExata(SolucionadorBatalha *solucionador, int tropasAtacante, int tropasDefensor, ResultadoExato *saida);
+
+/**
+ * Função para liberar a tabela do solucionador
+ * @param solucionador Ponteiro para o solucionador
+ */
+void liberarSolucionador(SolucionadorBatalha *solucionador);
+
+/**
+ * Função para exibir o desfecho exato no mesmo formato da estimativa por Monte Carlo
+ * @param tropasAtacante Tropas iniciais do atacante
+ * @param tropasDefensor Tropas iniciais do defensor
+ * @param tropasMinimas Piso de tropas usado no cálculo
+ * @param resultado Valores esperados retornados por resolverBatalhaExata
+ */
+void exibirBatalhaExata(int tropasAtacante, int tropasDefensor, int tropasMinimas, const ResultadoExato *resultado);
+
+#endif /* PROBABILIDADES_H */
@@ -0,0 +1,457 @@
+/**
+ * registro.c - Implementação do diário binário de ataques
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "registro.h"
+#include "territorio.h"
+#include "mapa.h"
+#include "cores.h"
+#include "nomes.h"
+#include "combate.h"
+
+/**
+ * Função auxiliar para gravar os eventos acumulados no buffer
+ * Uma escrita incompleta marca o diário como falho; depois disso nada mais é gravado
+ */
+static int descarregarEventos(RegistroPartida *registro)
+{
+    size_t gravados;
+
+    if (!registro->falhou && registro->pendentes > 0)
+    {
+        gravados = fwrite(registro->buffer, sizeof(EventoRegistro), registro->pendentes, registro->arquivo);
+        if (gravados != (size_t)registro->pendentes)
+        {
+            registro->falhou = 1;
+        }
+    }
+
+    registro->pendentes = 0;
+    return !registro->falhou;
+}
+
+/**
+ * Função auxiliar para acrescentar um evento ao buffer
+ * @return 1 se o diário continua íntegro, 0 se alguma escrita já falhou
+ */
+static int acrescentarEvento(RegistroPartida *registro, const EventoRegistro *evento)
+{
+    registro->buffer[registro->pendentes++] = *evento;
+    registro->eventos++;
+
+    if (registro->pendentes == REGISTRO_EVENTOS_BUFFER)
+    {
+        return descarregarEventos(registro);
+    }
+    return !registro->falhou;
+}
+
+/**
+ * Função auxiliar para gravar um território em formato independente da estrutura
+ */
+static int gravarTerritorio(FILE *arquivo, const Territorio *territorio)
+{
+    const char *cor = nomeCor(territorio->idCor);
+    const char *nome = textoNome(territorio->nome);
+    uint16_t tamanhoNome = (uint16_t)territorio->nome.comprimento;
+    uint16_t tamanhoCor = (uint16_t)strlen(cor);
+    int32_t tropas = territorio->tropas;
+
+    return fwrite(&tamanhoNome, sizeof(tamanhoNome), 1, arquivo) == 1 &&
+           fwrite(&tamanhoCor, sizeof(tamanhoCor), 1, arquivo) == 1 &&
+           fwrite(&tropas, sizeof(tropas), 1, arquivo) == 1 &&
+           fwrite(nome, 1, tamanhoNome, arquivo) == tamanhoNome &&
+           fwrite(cor, 1, tamanhoCor, arquivo) == tamanhoCor;
+}
+
+/**
+ * Função para criar o diário e gravar o cabeçalho e o mapa inicial
+ */
+int abrirRegistro(RegistroPartida *registro, const char *caminho, uint64_t semente, const MapaSoA *mapa)
+{
+    CabecalhoRegistro cabecalho;
+    Territorio territorio;
+
+    registro->arquivo = fopen(caminho, "wb");
+    registro->eventos = 0;
+    registro->pendentes = 0;
+    registro->falhou = 0;
+
+    if (registro->arquivo == NULL)
+    {
+        return 0;
+    }
+
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.assinatura, REGISTRO_ASSINATURA, 4);
+    cabecalho.versao = REGISTRO_VERSAO;
+    cabecalho.ordemBytes = REGISTRO_ORDEM;
+    cabecalho.semente = semente;
+    cabecalho.quantidadeTerritorios = (uint32_t)mapa->quantidade;
+
+    if (fwrite(&cabecalho, sizeof(cabecalho), 1, registro->arquivo) != 1)
+    {
+        fclose(registro->arquivo);
+        registro->arquivo = NULL;
+        return 0;
+    }
+
+    for (int i = 0; i < mapa->quantidade; i++)
+    {
+        obterTerritorioMapa(mapa, i, &territorio);
+        if (!gravarTerritorio(registro->arquivo, &territorio))
+        {
+            fclose(registro->arquivo);
+            registro->arquivo = NULL;
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Função para registrar um território adicionado durante a sessão
+ */
+void registrarTerritorio(RegistroPartida *registro, const Territorio *territorio)
+{
+    EventoRegistro evento;
+
+    if (registro == NULL || registro->arquivo == NULL)
+    {
+        return;
+    }
+
+    memset(&evento, 0, sizeof(evento));
+    evento.tipo = EVENTO_TERRITORIO;
+
+    // O território vem logo após o evento, então os pendentes precisam sair antes
+    if (acrescentarEvento(registro, &evento) && descarregarEventos(registro) &&
+        !gravarTerritorio(registro->arquivo, territorio))
+    {
+        registro->falhou = 1;
+    }
+}
+
+/**
+ * Função para registrar uma variação de tropas fora de combate (atrito, por exemplo)
+ */
+void registrarAjuste(RegistroPartida *registro, int indice, int delta)
+{
+    EventoRegistro evento;
+
+    if (registro == NULL || registro->arquivo == NULL)
+    {
+        return;
+    }
+
+    memset(&evento, 0, sizeof(evento));
+    evento.tipo = EVENTO_AJUSTE;
+    evento.atacante = (uint32_t)indice;
+    evento.deltaAtacante = delta;
+    acrescentarEvento(registro, &evento);
+}
+
+/**
+ * Função para preparar o acompanhamento de ataques entre dois territórios
+ */
+void iniciarAcompanhamento(
+    AcompanhamentoAtaque *acompanhamento,
+    RegistroPartida *registro,
+    const GeradorAleatorio *gerador,
+    const Territorio *atacante,
+    const Territorio *defensor,
+    int idAtacante,
+    int idDefensor)
+{
+    acompanhamento->registro = registro;
+    acompanhamento->gerador = gerador;
+    acompanhamento->atacante = atacante;
+    acompanhamento->defensor = defensor;
+    acompanhamento->idAtacante = idAtacante;
+    acompanhamento->idDefensor = idDefensor;
+    acompanhamento->tropasAtacante = atacante->tropas;
+    acompanhamento->tropasDefensor = defensor->tropas;
+}
+
+/**
+ * Observador de combate que grava cada rodada no diário
+ */
+void registrarAtaqueObservado(const ResultadoCombate *combate, void *contexto)
+{
+    AcompanhamentoAtaque *acompanhamento = (AcompanhamentoAtaque *)contexto;
+    EventoRegistro evento;
+
+    if (acompanhamento->registro == NULL || acompanhamento->registro->arquivo == NULL)
+    {
+        return;
+    }
+
+    evento.tipo = EVENTO_ATAQUE;
+    evento.resultado = (uint8_t)combate->resultado;
+    evento.conquistado = (uint8_t)combate->conquistado;
+    evento.reservado = 0;
+    evento.dados[0] = (uint8_t)combate->dadosAtacante.dado1;
+    evento.dados[1] = (uint8_t)combate->dadosAtacante.dado2;
+    evento.dados[2] = (uint8_t)combate->dadosDefensor.dado1;
+    evento.dados[3] = (uint8_t)combate->dadosDefensor.dado2;
+    evento.atacante = (uint32_t)acompanhamento->idAtacante;
+    evento.defensor = (uint32_t)acompanhamento->idDefensor;
+    evento.deltaAtacante = acompanhamento->atacante->tropas - acompanhamento->tropasAtacante;
+    evento.deltaDefensor = acompanhamento->defensor->tropas - acompanhamento->tropasDefensor;
+    evento.valor = acompanhamento->gerador->posicao;
+
+    acompanhamento->tropasAtacante = acompanhamento->atacante->tropas;
+    acompanhamento->tropasDefensor = acompanhamento->defensor->tropas;
+
+    acrescentarEvento(acompanhamento->registro, &evento);
+}
+
+/**
+ * Função para gravar o evento final com o hash do mapa e fechar o diário
+ */
+int fecharRegistro(RegistroPartida *registro, const MapaSoA *mapa)
+{
+    EventoRegistro evento;
+    int sucesso;
+
+    if (registro->arquivo == NULL)
+    {
+        return 0;
+    }
+
+    memset(&evento, 0, sizeof(evento));
+    evento.tipo = EVENTO_FIM;
+    evento.valor = calcularHashMapa(mapa);
+    acrescentarEvento(registro, &evento);
+
+    // Erros guardados pelo FILE (de um fflush interno, por exemplo) também contam
+    sucesso = descarregarEventos(registro) && !ferror(registro->arquivo);
+    sucesso = (fclose(registro->arquivo) == 0) && sucesso;
+    registro->arquivo = NULL;
+
+    return sucesso;
+}
+
+/**
+ * Função auxiliar para ler um território do diário já carregado em memória
+ * @return Bytes consumidos, ou 0 se o registro estiver truncado
+ */
+static size_t lerTerritorio(const unsigned char *dados, size_t restante, Territorio *territorio)
+{
+    uint16_t tamanhoNome, tamanhoCor;
+    int32_t tropas;
+    char cor[TAMANHO_COR];
+    int idCor;
+    size_t cabecalho = sizeof(tamanhoNome) + sizeof(tamanhoCor) + sizeof(tropas);
+
+    if (restante < cabecalho)
+    {
+        return 0;
+    }
+
+    memcpy(&tamanhoNome, dados, sizeof(tamanhoNome));
+    memcpy(&tamanhoCor, dados + 2, sizeof(tamanhoCor));
+    memcpy(&tropas, dados + 4, sizeof(tropas));
+
+    if (restante < cabecalho + tamanhoNome + tamanhoCor || tamanhoCor >= sizeof(cor))
+    {
+        return 0;
+    }
+
+    memset(territorio, 0, sizeof(Territorio));
+    if (!guardarNomeArena(arenaNomesPadrao(), (const char *)dados + cabecalho, tamanhoNome, &territorio->nome))
+    {
+        return 0;
+    }
+    memcpy(cor, dados + cabecalho + tamanhoNome, tamanhoCor);
+    cor[tamanhoCor] = '\0';
+
+    // A cor gravada por nome volta a ser um identificador da tabela de cores
+    idCor = internarCor(cor);
+    if (idCor < 0)
+    {
+        return 0;
+    }
+    territorio->idCor = (uint16_t)idCor;
+    territorio->tropas = tropas;
+
+    return cabecalho + tamanhoNome + tamanhoCor;
+}
+
+/**
+ * Função auxiliar para carregar o arquivo inteiro com uma única leitura
+ */
+static unsigned char *carregarArquivo(const char *caminho, size_t *tamanho)
+{
+    FILE *arquivo = fopen(caminho, "rb");
+    unsigned char *dados;
+    long fim;
+
+    if (arquivo == NULL)
+    {
+        return NULL;
+    }
+
+    if (fseek(arquivo, 0, SEEK_END) != 0 || (fim = ftell(arquivo)) < 0 || fseek(arquivo, 0, SEEK_SET) != 0)
+    {
+        fclose(arquivo);
+        return NULL;
+    }
+
+    dados = (unsigned char *)malloc(fim > 0 ? (size_t)fim : 1);
+    if (dados != NULL && fread(dados, 1, (size_t)fim, arquivo) != (size_t)fim)
+    {
+        free(dados);
+        dados = NULL;
+    }
+
+    fclose(arquivo);
+    *tamanho = (size_t)fim;
+    return dados;
+}
+
+/**
+ * Função para reaplicar um diário sem lançar dados novamente
+ */
+int reproduzirRegistro(const char *caminho, ResultadoReproducao *saida)
+{
+    CabecalhoRegistro cabecalho;
+    Territorio territorio;
+    MapaSoA *mapa = &saida->mapa;
+    unsigned char *dados;
+    size_t tamanho, posicao, consumidos;
+    int valido = 1;
+
+    memset(saida, 0, sizeof(ResultadoReproducao));
+
+    dados = carregarArquivo(caminho, &tamanho);
+    if (dados == NULL)
+    {
+        return 0;
+    }
+
+    if (tamanho < sizeof(cabecalho))
+    {
+        free(dados);
+        return 0;
+    }
+
+    memcpy(&cabecalho, dados, sizeof(cabecalho));
+    if (memcmp(cabecalho.assinatura, REGISTRO_ASSINATURA, 4) != 0 || cabecalho.versao != REGISTRO_VERSAO ||
+        cabecalho.ordemBytes != REGISTRO_ORDEM)
+    {
+        free(dados);
+        return 0;
+    }
+
+    // A quantidade vira int no mapa, e cada território ocupa ao menos os 8 bytes de tamanhos e tropas
+    if (cabecalho.quantidadeTerritorios > INT_MAX ||
+        cabecalho.quantidadeTerritorios > (tamanho - sizeof(cabecalho)) / (2 * sizeof(uint16_t) + sizeof(int32_t)))
+    {
+        free(dados);
+        return 0;
+    }
+
+    saida->semente = cabecalho.semente;
+    if (!iniciarMapa(mapa, (int)cabecalho.quantidadeTerritorios) ||
+        !crescerMapa(mapa, (int)cabecalho.quantidadeTerritorios))
+    {
+        liberarMapa(mapa);
+        free(dados);
+        return 0;
+    }
+
+    // Mapa inicial
+    posicao = sizeof(cabecalho);
+    for (int i = 0; i < mapa->quantidade && valido; i++)
+    {
+        consumidos = lerTerritorio(dados + posicao, tamanho - posicao, &territorio);
+        valido = (consumidos > 0);
+        posicao += consumidos;
+        if (valido)
+        {
+            guardarTerritorioMapa(mapa, i, &territorio);
+        }
+    }
+
+    // Eventos: os ataques apenas reaplicam as variações gravadas
+    while (valido && posicao + sizeof(EventoRegistro) <= tamanho)
+    {
+        EventoRegistro evento;
+
+        memcpy(&evento, dados + posicao, sizeof(evento));
+        posicao += sizeof(evento);
+        saida->eventos++;
+
+        if (evento.tipo == EVENTO_ATAQUE)
+        {
+            if (evento.atacante >= (uint32_t)mapa->quantidade || evento.defensor >= (uint32_t)mapa->quantidade)
+            {
+                valido = 0;
+                break;
+            }
+
+            mapa->tropas[evento.atacante] += evento.deltaAtacante;
+            mapa->tropas[evento.defensor] += evento.deltaDefensor;
+            if (evento.conquistado)
+            {
+                mapa->donos[evento.defensor] = mapa->donos[evento.atacante];
+            }
+        }
+        else if (evento.tipo == EVENTO_AJUSTE)
+        {
+            if (evento.atacante >= (uint32_t)mapa->quantidade)
+            {
+                valido = 0;
+                break;
+            }
+
+            mapa->tropas[evento.atacante] += evento.deltaAtacante;
+        }
+        else if (evento.tipo == EVENTO_TERRITORIO)
+        {
+            consumidos = lerTerritorio(dados + posicao, tamanho - posicao, &territorio);
+            valido = consumidos > 0 && crescerMapa(mapa, 1);
+            posicao += consumidos;
+            if (valido)
+            {
+                guardarTerritorioMapa(mapa, mapa->quantidade - 1, &territorio);
+            }
+        }
+        else if (evento.tipo == EVENTO_FIM)
+        {
+            saida->possuiFim = 1;
+            saida->hashEsperado = evento.valor;
+            break;
+        }
+        else
+        {
+            valido = 0;
+        }
+    }
+
+    free(dados);
+
+    if (!valido)
+    {
+        liberarReproducao(saida);
+        return 0;
+    }
+
+    saida->hashFinal = calcularHashMapa(mapa);
+    return 1;
+}
+
+/**
+ * Função para liberar o mapa reconstruído pela reprodução
+ */
+void liberarReproducao(ResultadoReproducao *reproducao)
+{
+    liberarMapa(&reproducao->mapa);
+}
@@ -0,0 +1,199 @@
+/**
+ * registro.h - Diário binário de ataques e reprodução determinística
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "territorio.h"
+#include "mapa.h"
+#include "combate.h"
+#include "aleatorio.h"
+
+/**
+ * Formato do arquivo:
+ *
+ *   CabecalhoRegistro
+ *   N registros de território (mapa inicial)
+ *   sequência de EventoRegistro; eventos EVENTO_TERRITORIO são seguidos por
+ *   um registro de território; o último evento é EVENTO_FIM com o hash final
+ *
+ * Registro de território: uint16 tamanho do nome, uint16 tamanho da cor,
+ * int32 tropas e em seguida os bytes do nome e da cor (sem terminador).
+ *
+ * Cabeçalho, eventos e registros são gravados com fwrite direto das estruturas,
+ * na ordem de bytes de quem jogou. O diário só é reproduzido numa máquina com a
+ * mesma ordem: o campo ordemBytes do cabeçalho traz REGISTRO_ORDEM e não confere
+ * quando lido com a ordem inversa.
+ */
+#define REGISTRO_ASSINATURA "WLOG"
+#define REGISTRO_VERSAO 2
+#define REGISTRO_ORDEM 0x01020304u
+
+// Eventos acumulados em memória antes de cada escrita no arquivo
+#define REGISTRO_EVENTOS_BUFFER 1024
+
+typedef enum
+{
+    EVENTO_ATAQUE = 1,
+    EVENTO_TERRITORIO = 2,
+    EVENTO_AJUSTE = 3,
+    EVENTO_FIM = 255
+} TipoEvento;
+
+/**
+ * Cabeçalho do diário
+ * - ordemBytes: REGISTRO_ORDEM na ordem de bytes da máquina que gravou
+ */
+typedef struct
+{
+    char assinatura[4];
+    uint32_t versao;
+    uint64_t semente;
+    uint32_t quantidadeTerritorios;
+    uint32_t ordemBytes;
+} CabecalhoRegistro;
+
+/**
+ * Evento de tamanho fixo (32 bytes)
+ * - dados: dado1 e dado2 do atacante seguidos de dado1 e dado2 do defensor
+ * - deltaAtacante/deltaDefensor: variação real das tropas de cada lado
+ *   (em EVENTO_AJUSTE, 'atacante' é o território ajustado e 'deltaAtacante' a variação)
+ * - valor: posição do gerador após o ataque (EVENTO_ATAQUE) ou hash final (EVENTO_FIM)
+ */
+typedef struct
+{
+    uint8_t tipo;
+    uint8_t resultado;
+    uint8_t conquistado;
+    uint8_t reservado;
+    uint8_t dados[4];
+    uint32_t atacante;
+    uint32_t defensor;
+    int32_t deltaAtacante;
+    int32_t deltaDefensor;
+    uint64_t valor;
+} EventoRegistro;
+
+/**
+ * Diário aberto para gravação
+ * - falhou: diferente de zero depois de uma escrita com erro; os eventos seguintes são
+ *   descartados e fecharRegistro informa a falha
+ */
+typedef struct
+{
+    FILE *arquivo;
+    uint64_t eventos;
+    int pendentes;
+    int falhou;
+    EventoRegistro buffer[REGISTRO_EVENTOS_BUFFER];
+} RegistroPartida;
+
+/**
+ * Estrutura que acompanha um par atacante/defensor para registrar seus ataques
+ *
+ * Guarda as tropas conhecidas antes de cada rodada, de modo que o diário traga
+ * a variação real (após o piso de uma tropa) e não apenas a perda calculada.
+ */
+typedef struct
+{
+    RegistroPartida *registro;
+    const GeradorAleatorio *gerador;
+    const Territorio *atacante;
+    const Territorio *defensor;
+    int idAtacante;
+    int idDefensor;
+    int tropasAtacante;
+    int tropasDefensor;
+} AcompanhamentoAtaque;
+
+/**
+ * Resultado da reprodução de um diário
+ */
+typedef struct
+{
+    MapaSoA mapa;
+    uint64_t semente;
+    uint64_t eventos;
+    uint64_t hashFinal;
+    uint64_t hashEsperado;
+    int possuiFim;
+} ResultadoReproducao;
+
+/**
+ * Função para criar o diário e gravar o cabeçalho e o mapa inicial
+ * @param registro Ponteiro para o diário
+ * @param caminho Caminho do arquivo a ser criado
+ * @param semente Semente do gerador usada na sessão
+ * @param mapa Mapa no momento em que a gravação começa
+ * @return 1 em caso de sucesso, 0 em caso de falha
+ */
+int abrirRegistro(RegistroPartida *registro, const char *caminho, uint64_t semente, const MapaSoA *mapa);
+
+/**
+ * Função para registrar um território adicionado durante a sessão
+ * Uma falha de escrita marca o diário como falho (ver fecharRegistro)
+ * @param registro Ponteiro para o diário
+ * @param territorio Território recém-cadastrado
+ */
+void registrarTerritorio(RegistroPartida *registro, const Territorio *territorio);
+
+/**
+ * Função para registrar uma variação de tropas fora de combate (atrito, por exemplo)
+ * @param registro Ponteiro para o diário (NULL ignora a chamada)
+ * @param indice Índice do território ajustado
+ * @param delta Variação real das tropas
+ */
+void registrarAjuste(RegistroPartida *registro, int indice, int delta);
+
+/**
+ * Função para preparar o acompanhamento de ataques entre dois territórios
+ * @param acompanhamento Ponteiro para a estrutura de acompanhamento
+ * @param registro Diário de destino (NULL desativa a gravação)
+ * @param gerador Gerador usado nos ataques (para gravar a posição do fluxo)
+ * @param atacante Território atacante, observado durante todo o ataque
+ * @param defensor Território defensor, observado durante todo o ataque
+ * @param idAtacante Índice do atacante
+ * @param idDefensor Índice do defensor
+ */
+void iniciarAcompanhamento(
+    AcompanhamentoAtaque *acompanhamento,
+    RegistroPartida *registro,
+    const GeradorAleatorio *gerador,
+    const Territorio *atacante,
+    const Territorio *defensor,
+    int idAtacante,
+    int idDefensor);
+
+/**
+ * Observador de combate que grava cada rodada no diário
+ * Compatível com ObservadorCombate; o contexto é um AcompanhamentoAtaque
+ */
+void registrarAtaqueObservado(const ResultadoCombate *combate, void *contexto);
+
+/**
+ * Função para gravar o evento final com o hash do mapa e fechar o diário
+ * @param registro Ponteiro para o diário
+ * @param mapa Mapa no fim da sessão
+ * @return 1 em caso de sucesso, 0 se alguma escrita da sessão ou o fechamento falhou
+ */
+int fecharRegistro(RegistroPartida *registro, const MapaSoA *mapa);
+
+/**
+ * Função para reaplicar um diário sem lançar dados novamente
+ * @param caminho Caminho do diário
+ * @param saida Recebe o mapa reconstruído (liberar com liberarReproducao) e o resumo
+ * @return 1 em caso de sucesso, 0 se o arquivo for inválido ou faltar memória
+ */
+int reproduzirRegistro(const char *caminho, ResultadoReproducao *saida);
+
+/**
+ * Função para liberar o mapa reconstruído pela reprodução
+ * @param reproducao Ponteiro para o resultado da reprodução
+ */
+void liberarReproducao(ResultadoReproducao *reproducao);
+
+#endif /* REGISTRO_H */
@@ -0,0 +1,419 @@
+/**
+ * salvamento.c - Implementação do salvamento e da carga de partidas
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "salvamento.h"
+#include "cores.h"
+#include "nomes.h"
+
+// Constantes do FNV-1a de 64 bits, aplicado aqui a palavras de 8 bytes
+#define SOMA_BASE 14695981039346656037ULL
+#define SOMA_PRIMO 1099511628211ULL
+
+// Sufixo do arquivo temporário gravado antes da troca de nome
+#define SUFIXO_TEMPORARIO ".tmp"
+
+// O bloco é copiado direto das estruturas: sem folgas, elas têm o mesmo tamanho em qualquer compilador
+typedef char verificarTamanhoCabecalhoSalvamento[sizeof(CabecalhoSalvamento) == 128 ? 1 : -1];
+typedef char verificarTamanhoTerritorioSalvo[sizeof(TerritorioSalvo) == 16 ? 1 : -1];
+
+/**
+ * Função auxiliar que arredonda um tamanho para o próximo múltiplo de 8 bytes
+ */
+static uint64_t alinharPalavra(uint64_t tamanho)
+{
+    return (tamanho + 7) & ~(uint64_t)7;
+}
+
+/**
+ * Função auxiliar que acumula um trecho na soma de verificação
+ *
+ * É o FNV-1a com palavras de 64 bits no lugar de bytes: uma multiplicação a
+ * cada 8 bytes, rápido o bastante para conferir centenas de megabytes por segundo.
+ *
+ * @param soma Soma acumulada até aqui (SOMA_BASE no início do arquivo)
+ * @param dados Início do trecho
+ * @param bytes Tamanho do trecho (múltiplo de 8)
+ */
+static uint64_t acumularSoma(uint64_t soma, const unsigned char *dados, uint64_t bytes)
+{
+    for (uint64_t i = 0; i < bytes; i += sizeof(uint64_t))
+    {
+        uint64_t palavra;
+
+        memcpy(&palavra, dados + i, sizeof(palavra));
+        soma = (soma ^ palavra) * SOMA_PRIMO;
+    }
+
+    return soma;
+}
+
+/**
+ * Função auxiliar que calcula a soma de verificação do arquivo inteiro
+ * O cabeçalho entra com o campo soma zerado, então a soma não depende de si mesma
+ * @param bloco Início do arquivo
+ * @param tamanho Tamanho do arquivo (múltiplo de 8)
+ */
+static uint64_t calcularSoma(const unsigned char *bloco, uint64_t tamanho)
+{
+    CabecalhoSalvamento cabecalho;
+
+    memcpy(&cabecalho, bloco, sizeof(cabecalho));
+    cabecalho.soma = 0;
+    return acumularSoma(acumularSoma(SOMA_BASE, (const unsigned char *)&cabecalho, sizeof(cabecalho)),
+                        bloco + sizeof(CabecalhoSalvamento), tamanho - sizeof(CabecalhoSalvamento));
+}
+
+/**
+ * Função auxiliar que calcula o tamanho da seção de fronteiras
+ * @param quantidade Quantidade de territórios
+ * @param entradas Tamanho do vetor de vizinhos
+ * @param presente Zero se a partida não tem fronteiras (a seção fica vazia)
+ */
+static uint64_t tamanhoFronteiras(uint64_t quantidade, uint64_t entradas, int presente)
+{
+    if (!presente)
+    {
+        return 0;
+    }
+    return alinharPalavra((quantidade + 1) * sizeof(uint32_t)) + alinharPalavra(entradas * sizeof(uint32_t));
+}
+
+/**
+ * Função para salvar o estado de uma partida
+ */
+int salvarJogo(const char *caminho, const MapaSoA *territorios, const GrafoFronteiras *fronteiras,
+               const GeradorAleatorio *gerador, uint64_t semente)
+{
+    CabecalhoSalvamento cabecalho;
+    TerritorioSalvo *salvos;
+    unsigned char *bloco;
+    char *cores, *textos, *temporario;
+    uint32_t *deslocamentos, *vizinhos;
+    uint64_t tamanhoTextos = 0, tamanhoCores, tamanho;
+    uint32_t entradas = fronteiras != NULL ? fronteiras->entradas : 0;
+    int quantidadeCoresTabela = quantidadeCores();
+    FILE *arquivo;
+    int sucesso;
+
+    if (territorios->quantidade < 0 || (territorios->quantidade > 0 && territorios->tropas == NULL) ||
+        (fronteiras != NULL && fronteiras->quantidade > territorios->quantidade))
+    {
+        return 0;
+    }
+
+    for (int i = 0; i < territorios->quantidade; i++)
+    {
+        tamanhoTextos += territorios->nomes[i].comprimento;
+    }
+    if (tamanhoTextos > UINT32_MAX)
+    {
+        return 0;
+    }
+
+    tamanhoCores = alinharPalavra((uint64_t)quantidadeCoresTabela * TAMANHO_COR);
+    tamanho = sizeof(CabecalhoSalvamento) + (uint64_t)territorios->quantidade * sizeof(TerritorioSalvo) +
+              tamanhoCores + alinharPalavra(tamanhoTextos) +
+              tamanhoFronteiras((uint64_t)territorios->quantidade, entradas, fronteiras != NULL);
+
+    // O arquivo inteiro é montado em memória (zerado, para que os preenchimentos sejam determinísticos)
+    bloco = (unsigned char *)calloc(1, (size_t)tamanho);
+    if (bloco == NULL)
+    {
+        return 0;
+    }
+    salvos = (TerritorioSalvo *)(bloco + sizeof(CabecalhoSalvamento));
+    cores = (char *)(salvos + territorios->quantidade);
+    textos = cores + tamanhoCores;
+    deslocamentos = (uint32_t *)(textos + alinharPalavra(tamanhoTextos));
+    vizinhos = deslocamentos + alinharPalavra(((uint64_t)territorios->quantidade + 1) * sizeof(uint32_t)) / sizeof(uint32_t);
+
+    tamanhoTextos = 0;
+    for (int i = 0; i < territorios->quantidade; i++)
+    {
+        RefNome nome = territorios->nomes[i];
+
+        salvos[i].tropas = territorios->tropas[i];
+        salvos[i].idCor = territorios->donos[i];
+        salvos[i].deslocamentoNome = (uint32_t)tamanhoTextos;
+        salvos[i].comprimentoNome = nome.comprimento;
+        memcpy(textos + tamanhoTextos, textoNome(nome), nome.comprimento);
+        tamanhoTextos += nome.comprimento;
+    }
+
+    // A tabela de cores vai inteira, então os identificadores são gravados como estão
+    for (int c = 0; c < quantidadeCoresTabela; c++)
+    {
+        strncpy(cores + (size_t)c * TAMANHO_COR, nomeCor((uint16_t)c), TAMANHO_COR - 1);
+    }
+
+    // Fronteiras em CSR com uma linha por território; os que o grafo não cobre ficam sem vizinhos
+    if (fronteiras != NULL)
+    {
+        for (int i = 0; i <= territorios->quantidade; i++)
+        {
+            deslocamentos[i] = i <= fronteiras->quantidade ? fronteiras->deslocamentos[i] : entradas;
+        }
+        if (entradas > 0)
+        {
+            memcpy(vizinhos, fronteiras->vizinhos, (size_t)entradas * sizeof(uint32_t));
+        }
+    }
+
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.assinatura, SALVAMENTO_ASSINATURA, sizeof(cabecalho.assinatura));
+    cabecalho.versao = SALVAMENTO_VERSAO;
+    cabecalho.ordemBytes = SALVAMENTO_ORDEM;
+    cabecalho.tamanhoCabecalho = (uint16_t)sizeof(CabecalhoSalvamento);
+    cabecalho.tamanhoTerritorio = (uint16_t)sizeof(TerritorioSalvo);
+    cabecalho.tamanhoArquivo = tamanho;
+    cabecalho.semente = semente;
+    memcpy(cabecalho.gerador, gerador->s, sizeof(cabecalho.gerador));
+    cabecalho.posicaoGerador = gerador->posicao;
+    cabecalho.quantidadeTerritorios = (uint32_t)territorios->quantidade;
+    cabecalho.capacidade = (uint32_t)territorios->capacidade;
+    cabecalho.quantidadeCores = (uint32_t)quantidadeCoresTabela;
+    cabecalho.realocacoes = (uint32_t)territorios->realocacoes;
+    cabecalho.bytesMovidosTotal = territorios->bytesMovidosTotal;
+    cabecalho.tamanhoTextos = tamanhoTextos;
+    if (territorios->alocador != NULL)
+    {
+        strncpy(cabecalho.alocador, territorios->alocador->operacoes->nome, sizeof(cabecalho.alocador) - 1);
+    }
+    cabecalho.fronteiras = fronteiras != NULL;
+    cabecalho.entradasFronteiras = entradas;
+    memcpy(bloco, &cabecalho, sizeof(cabecalho));
+    cabecalho.soma = calcularSoma(bloco, tamanho);
+    memcpy(bloco + offsetof(CabecalhoSalvamento, soma), &cabecalho.soma, sizeof(cabecalho.soma));
+
+    // Grava num arquivo temporário com uma única escrita e só então substitui o salvamento anterior
+    temporario = (char *)malloc(strlen(caminho) + sizeof(SUFIXO_TEMPORARIO));
+    if (temporario == NULL)
+    {
+        free(bloco);
+        return 0;
+    }
+    strcpy(temporario, caminho);
+    strcat(temporario, SUFIXO_TEMPORARIO);
+
+    arquivo = fopen(temporario, "wb");
+    sucesso = arquivo != NULL;
+    if (sucesso)
+    {
+        setvbuf(arquivo, NULL, _IONBF, 0);
+        sucesso = fwrite(bloco, 1, (size_t)tamanho, arquivo) == (size_t)tamanho;
+        sucesso = (fclose(arquivo) == 0) && sucesso;
+    }
+    sucesso = sucesso && rename(temporario, caminho) == 0;
+    if (!sucesso)
+    {
+        remove(temporario);
+    }
+
+    free(temporario);
+    free(bloco);
+    return sucesso;
+}
+
+/**
+ * Função auxiliar que confere o cabeçalho e as referências do corpo antes da carga
+ * @return 1 se o salvamento é consistente, 0 caso contrário
+ */
+static int validarSalvamento(const unsigned char *bloco, uint64_t tamanho, CabecalhoSalvamento *cabecalho)
+{
+    const TerritorioSalvo *salvos;
+    const uint32_t *deslocamentos, *vizinhos;
+    uint64_t tamanhoCores, esperado;
+
+    if (tamanho < sizeof(CabecalhoSalvamento))
+    {
+        return 0;
+    }
+    memcpy(cabecalho, bloco, sizeof(CabecalhoSalvamento));
+
+    // Ordem de bytes e disposição das estruturas precisam ser as desta máquina
+    if (memcmp(cabecalho->assinatura, SALVAMENTO_ASSINATURA, sizeof(cabecalho->assinatura)) != 0 ||
+        cabecalho->versao != SALVAMENTO_VERSAO || cabecalho->ordemBytes != SALVAMENTO_ORDEM ||
+        cabecalho->tamanhoCabecalho != sizeof(CabecalhoSalvamento) ||
+        cabecalho->tamanhoTerritorio != sizeof(TerritorioSalvo) ||
+        memchr(cabecalho->alocador, '\0', sizeof(cabecalho->alocador)) == NULL ||
+        cabecalho->tamanhoArquivo != tamanho ||
+        cabecalho->quantidadeTerritorios > INT32_MAX || cabecalho->capacidade > INT32_MAX ||
+        cabecalho->quantidadeCores > MAX_CORES || cabecalho->tamanhoTextos > UINT32_MAX ||
+        cabecalho->fronteiras > 1 || (!cabecalho->fronteiras && cabecalho->entradasFronteiras != 0))
+    {
+        return 0;
+    }
+
+    tamanhoCores = alinharPalavra((uint64_t)cabecalho->quantidadeCores * TAMANHO_COR);
+    esperado = sizeof(CabecalhoSalvamento) + (uint64_t)cabecalho->quantidadeTerritorios * sizeof(TerritorioSalvo) +
+               tamanhoCores + alinharPalavra(cabecalho->tamanhoTextos) +
+               tamanhoFronteiras(cabecalho->quantidadeTerritorios, cabecalho->entradasFronteiras, (int)cabecalho->fronteiras);
+    if (esperado != tamanho || calcularSoma(bloco, tamanho) != cabecalho->soma)
+    {
+        return 0;
+    }
+
+    salvos = (const TerritorioSalvo *)(bloco + sizeof(CabecalhoSalvamento));
+    for (uint32_t i = 0; i < cabecalho->quantidadeTerritorios; i++)
+    {
+        if (salvos[i].idCor >= cabecalho->quantidadeCores ||
+            salvos[i].comprimentoNome > COMPRIMENTO_MAXIMO_NOME ||
+            (uint64_t)salvos[i].deslocamentoNome + salvos[i].comprimentoNome > cabecalho->tamanhoTextos)
+        {
+            return 0;
+        }
+    }
+
+    // Fronteiras: deslocamentos crescentes de 0 a entradas e vizinhos dentro do mapa
+    if (cabecalho->fronteiras)
+    {
+        deslocamentos = (const uint32_t *)(bloco + sizeof(CabecalhoSalvamento) +
+                                           (uint64_t)cabecalho->quantidadeTerritorios * sizeof(TerritorioSalvo) +
+                                           tamanhoCores + alinharPalavra(cabecalho->tamanhoTextos));
+        vizinhos = deslocamentos + alinharPalavra(((uint64_t)cabecalho->quantidadeTerritorios + 1) * sizeof(uint32_t)) / sizeof(uint32_t);
+
+        if (deslocamentos[0] != 0 || deslocamentos[cabecalho->quantidadeTerritorios] != cabecalho->entradasFronteiras)
+        {
+            return 0;
+        }
+        for (uint32_t i = 0; i < cabecalho->quantidadeTerritorios; i++)
+        {
+            if (deslocamentos[i] > deslocamentos[i + 1])
+            {
+                return 0;
+            }
+        }
+        for (uint32_t k = 0; k < cabecalho->entradasFronteiras; k++)
+        {
+            if (vizinhos[k] >= cabecalho->quantidadeTerritorios)
+            {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Função para carregar uma partida salva com salvarJogo
+ */
+int carregarJogo(const char *caminho, MapaSoA *territorios, GrafoFronteiras *fronteiras,
+                 GeradorAleatorio *gerador, CabecalhoSalvamento *cabecalho)
+{
+    CabecalhoSalvamento lido;
+    const TerritorioSalvo *salvos;
+    const char *cores, *textos;
+    const uint32_t *deslocamentos;
+    uint16_t traducao[MAX_CORES];
+    unsigned char *bloco;
+    FILE *arquivo;
+    uint32_t capacidade;
+    long tamanho;
+    int sucesso;
+
+    memset(fronteiras, 0, sizeof(GrafoFronteiras));
+    arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL)
+    {
+        return 0;
+    }
+
+    // Uma única leitura para um buffer do tamanho exato do arquivo
+    if (fseek(arquivo, 0, SEEK_END) != 0 || (tamanho = ftell(arquivo)) < 0 || fseek(arquivo, 0, SEEK_SET) != 0)
+    {
+        fclose(arquivo);
+        return 0;
+    }
+    bloco = (unsigned char *)malloc(tamanho > 0 ? (size_t)tamanho : 1);
+    sucesso = bloco != NULL && fread(bloco, 1, (size_t)tamanho, arquivo) == (size_t)tamanho;
+    fclose(arquivo);
+
+    sucesso = sucesso && validarSalvamento(bloco, (uint64_t)tamanho, &lido);
+    if (!sucesso)
+    {
+        free(bloco);
+        return 0;
+    }
+
+    salvos = (const TerritorioSalvo *)(bloco + sizeof(CabecalhoSalvamento));
+    cores = (const char *)(salvos + lido.quantidadeTerritorios);
+    textos = cores + alinharPalavra((uint64_t)lido.quantidadeCores * TAMANHO_COR);
+    deslocamentos = (const uint32_t *)(textos + alinharPalavra(lido.tamanhoTextos));
+
+    // As cores voltam para a tabela global, que pode tê-las com outros identificadores
+    for (uint32_t c = 0; c < lido.quantidadeCores && sucesso; c++)
+    {
+        char nome[TAMANHO_COR];
+        int idCor;
+
+        memcpy(nome, cores + (size_t)c * TAMANHO_COR, TAMANHO_COR);
+        nome[TAMANHO_COR - 1] = '\0';
+        idCor = internarCor(nome);
+        sucesso = idCor >= 0;
+        traducao[c] = (uint16_t)(sucesso ? idCor : 0);
+    }
+    if (!sucesso)
+    {
+        free(bloco);
+        return 0;
+    }
+
+    // O mapa volta com a capacidade salva, então o crescimento segue de onde parou
+    capacidade = lido.capacidade > lido.quantidadeTerritorios ? lido.capacidade : lido.quantidadeTerritorios;
+    sucesso = iniciarMapa(territorios, (int)capacidade) &&
+              crescerMapa(territorios, (int)lido.quantidadeTerritorios) &&
+              reservarArenaNomes(arenaNomesPadrao(), lido.tamanhoTextos + lido.quantidadeTerritorios);
+
+    for (uint32_t i = 0; i < lido.quantidadeTerritorios && sucesso; i++)
+    {
+        sucesso = guardarNomeArena(arenaNomesPadrao(), textos + salvos[i].deslocamentoNome,
+                                   salvos[i].comprimentoNome, &territorios->nomes[i]);
+        territorios->donos[i] = traducao[salvos[i].idCor];
+        territorios->tropas[i] = salvos[i].tropas;
+    }
+
+    // O grafo salvo ganha vetores próprios, já conferidos por validarSalvamento
+    if (sucesso && lido.fronteiras)
+    {
+        size_t bytesDeslocamentos = ((size_t)lido.quantidadeTerritorios + 1) * sizeof(uint32_t);
+        size_t bytesVizinhos = (size_t)lido.entradasFronteiras * sizeof(uint32_t);
+
+        fronteiras->deslocamentos = (uint32_t *)malloc(bytesDeslocamentos);
+        fronteiras->vizinhos = (uint32_t *)malloc(bytesVizinhos > 0 ? bytesVizinhos : 1);
+        sucesso = fronteiras->deslocamentos != NULL && fronteiras->vizinhos != NULL;
+        if (sucesso)
+        {
+            memcpy(fronteiras->deslocamentos, deslocamentos, bytesDeslocamentos);
+            memcpy(fronteiras->vizinhos, deslocamentos + alinharPalavra(bytesDeslocamentos) / sizeof(uint32_t), bytesVizinhos);
+            fronteiras->quantidade = (int)lido.quantidadeTerritorios;
+            fronteiras->entradas = lido.entradasFronteiras;
+        }
+    }
+
+    if (!sucesso)
+    {
+        liberarGrafo(fronteiras);
+        liberarMapa(territorios);
+        free(bloco);
+        return 0;
+    }
+
+    memcpy(gerador->s, lido.gerador, sizeof(gerador->s));
+    gerador->posicao = lido.posicaoGerador;
+    territorios->realocacoes = (int)lido.realocacoes;
+    territorios->bytesMovidosTotal = (size_t)lido.bytesMovidosTotal;
+    if (cabecalho != NULL)
+    {
+        *cabecalho = lido;
+    }
+
+    free(bloco);
+    return 1;
+}
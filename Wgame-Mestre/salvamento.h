@@ -0,0 +1,120 @@
+/**
+ * salvamento.h - Salvamento e carga do estado completo de uma partida
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef SALVAMENTO_H
+#define SALVAMENTO_H
+
+#include <stdint.h>
+#include "mapa.h"
+#include "aleatorio.h"
+#include "fronteiras.h"
+
+/**
+ * Formato do arquivo:
+ *
+ *   CabecalhoSalvamento
+ *   TerritorioSalvo[N]
+ *   cores:  char[TAMANHO_COR] por cor usada; a cor i do arquivo é o idCor i
+ *   textos: bytes dos nomes, sem terminador
+ *   fronteiras (opcional): uint32[N + 1] deslocamentos e uint32[entradas] vizinhos (CSR)
+ *
+ * Cores, textos e cada vetor das fronteiras são completados com zeros até
+ * múltiplos de 8 bytes. A soma de verificação cobre o arquivo inteiro, com o
+ * campo soma do cabeçalho zerado. O arquivo inteiro é montado num único bloco
+ * e gravado de uma vez.
+ *
+ * O bloco é a cópia das estruturas em memória, com os inteiros na ordem de bytes
+ * de quem salvou. A carga confere a marca SALVAMENTO_ORDEM e os tamanhos de
+ * cabeçalho e registro gravados, então um salvamento de outra ordem de bytes ou
+ * de outra disposição das estruturas é recusado em vez de carregado trocado.
+ */
+#define SALVAMENTO_ASSINATURA "WSAV"
+#define SALVAMENTO_VERSAO 3
+#define SALVAMENTO_ORDEM 0x01020304u
+
+/**
+ * Cabeçalho do salvamento (128 bytes)
+ * - tamanhoArquivo: bytes totais, usados para conferir truncamento
+ * - soma: soma de verificação do arquivo, calculada com este campo zerado
+ * - semente/gerador/posicaoGerador: semente da sessão e estado atual do gerador
+ * - capacidade/realocacoes/bytesMovidosTotal: metadados do MapaSoA da sessão
+ * - alocador: nome do alocador em uso quando o jogo foi salvo
+ * - ordemBytes: SALVAMENTO_ORDEM, na ordem de bytes de quem salvou
+ * - tamanhoCabecalho/tamanhoTerritorio: sizeof das duas estruturas ao salvar
+ * - fronteiras/entradasFronteiras: 1 se a seção de fronteiras está presente e o
+ *   tamanho do seu vetor de vizinhos
+ */
+typedef struct
+{
+    char assinatura[4];
+    uint32_t versao;
+    uint64_t tamanhoArquivo;
+    uint64_t soma;
+    uint64_t semente;
+    uint64_t gerador[4];
+    uint64_t posicaoGerador;
+    uint32_t quantidadeTerritorios;
+    uint32_t capacidade;
+    uint32_t quantidadeCores;
+    uint32_t realocacoes;
+    uint64_t bytesMovidosTotal;
+    uint64_t tamanhoTextos;
+    char alocador[8];
+    uint32_t ordemBytes;
+    uint16_t tamanhoCabecalho;
+    uint16_t tamanhoTerritorio;
+    uint32_t fronteiras;
+    uint32_t entradasFronteiras;
+} CabecalhoSalvamento;
+
+/**
+ * Território como gravado no salvamento (16 bytes)
+ * - deslocamentoNome/comprimentoNome: posição do nome na seção de textos
+ */
+typedef struct
+{
+    int32_t tropas;
+    uint16_t idCor;
+    uint16_t reservado;
+    uint32_t deslocamentoNome;
+    uint32_t comprimentoNome;
+} TerritorioSalvo;
+
+/**
+ * Função para salvar o estado de uma partida
+ *
+ * O arquivo é gravado com outro nome e renomeado no fim, então um salvamento
+ * interrompido nunca estraga o anterior.
+ *
+ * @param caminho Caminho do arquivo
+ * @param territorios Mapa de territórios da partida
+ * @param fronteiras Grafo de fronteiras da sessão (NULL grava uma partida sem fronteiras;
+ *                   territórios além dos cobertos pelo grafo ficam sem vizinhos)
+ * @param gerador Estado atual do gerador de números aleatórios
+ * @param semente Semente da sessão
+ * @return 1 em caso de sucesso, 0 se faltar memória ou a gravação falhar
+ */
+int salvarJogo(const char *caminho, const MapaSoA *territorios, const GrafoFronteiras *fronteiras,
+               const GeradorAleatorio *gerador, uint64_t semente);
+
+/**
+ * Função para carregar uma partida salva com salvarJogo
+ *
+ * O arquivo é lido com uma única leitura para um buffer do tamanho exato e
+ * conferido (assinatura, versão, tamanho, soma e referências) antes de qualquer
+ * alteração. O mapa é criado com a capacidade salva, com o alocador atual.
+ *
+ * @param caminho Caminho do arquivo
+ * @param territorios Mapa a ser criado (não deve estar em uso)
+ * @param fronteiras Recebe o grafo salvo, liberado com liberarGrafo; fica zerado
+ *                   se a partida foi salva sem fronteiras
+ * @param gerador Recebe o estado salvo do gerador
+ * @param cabecalho Recebe o cabeçalho lido (pode ser NULL)
+ * @return 1 em caso de sucesso, 0 se o arquivo for inválido ou faltar memória
+ */
+int carregarJogo(const char *caminho, MapaSoA *territorios, GrafoFronteiras *fronteiras,
+                 GeradorAleatorio *gerador, CabecalhoSalvamento *cabecalho);
+
+#endif /* SALVAMENTO_H */
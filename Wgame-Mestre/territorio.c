@@ -34,19 +34,74 @@ void lerString(char *destino, int tamanho, const char *mensagem)
     }
 }
 
+// Tamanho dos blocos lidos de cada vez por lerNome
+#define BLOCO_LEITURA_NOME 128
+
+/**
+ * Função auxiliar que lê uma linha inteira, de qualquer comprimento, e guarda o texto na arena de nomes
+ */
+static RefNome lerNome(const char *mensagem)
+{
+    char bloco[BLOCO_LEITURA_NOME];
+    char *linha = NULL;
+    size_t comprimento = 0;
+    RefNome nome = {0, 0};
+
+    printf("%s", mensagem);
+
+    // Junta os blocos até encontrar o '\n', em vez de truncar o nome
+    while (fgets(bloco, sizeof(bloco), stdin) != NULL)
+    {
+        size_t tamanhoBloco = strlen(bloco);
+        char *ampliada = (char *)realloc(linha, comprimento + tamanhoBloco + 1);
+
+        if (ampliada == NULL)
+        {
+            break;
+        }
+        linha = ampliada;
+        memcpy(linha + comprimento, bloco, tamanhoBloco + 1);
+        comprimento += tamanhoBloco;
+
+        if (tamanhoBloco > 0 && bloco[tamanhoBloco - 1] == '\n')
+        {
+            linha[--comprimento] = '\0';
+            break;
+        }
+    }
+
+    if (linha != NULL)
+    {
+        guardarNomeArena(arenaNomesPadrao(), linha, comprimento, &nome);
+        free(linha);
+    }
+
+    return nome;
+}
+
 /**
  * Função para cadastrar um território no vetor dinâmico
  */
 void cadastrarTerritorio(Territorio *territorio, int indice, int total)
 {
+    char cor[TAMANHO_COR];
+    int idCor;
+
     printf("Cadastro do territorio %d de %d:\n", indice + 1, total);
     printf("----------------------------------\n");
 
     // Leitura do nome do território com espaços
-    lerString(territorio->nome, 30, "Nome do territorio: ");
+    territorio->nome = lerNome("Nome do territorio: ");
 
-    // Leitura da cor do exército com espaços
-    lerString(territorio->cor, 10, "Cor do exercito: ");
+    // Leitura da cor do exército com espaços; a tabela de cores devolve o identificador
+    lerString(cor, TAMANHO_COR, "Cor do exercito: ");
+    idCor = internarCor(cor);
+    if (idCor < 0)
+    {
+        printf("Limite de %d cores atingido! Usando a cor %s.\n", MAX_CORES, nomeCor(0));
+        idCor = 0;
+    }
+    territorio->idCor = (uint16_t)idCor;
 
     // Leitura da quantidade de tropas
     printf("Quantidade de tropas: ");
@@ -61,40 +116,58 @@ void cadastrarTerritorio(Territorio *territorio, int indice, int total)
  */
 void exibirTerritorio(const Territorio *territorio, int indice)
 {
-    printf("Territorio %d: %s\n", indice + 1, territorio->nome);
-    printf("  Cor do exercito: %s\n", territorio->cor);
+    printf("Territorio %d: %s\n", indice + 1, textoNome(territorio->nome));
+    printf("  Cor do exercito: %s\n", nomeCor(territorio->idCor));
     printf("  Tropas: %d\n", territorio->tropas);
     printf("----------------------------------\n\n");
 }
 
 /**
- * Função para listar todos os territórios cadastrados
+ * Função para calcular quantas tropas um território perde, em aritmética inteira
+ * O produto é feito em 64 bits para não transbordar com exércitos grandes
  */
-void listarTerritorios(const Territorio *mapa, int quantidade)
+int calcularPerdaTropas(int tropas, int pontosBase)
 {
-    printf("\n===================================\n");
-    printf("     TERRITORIOS CADASTRADOS      \n");
-    printf("===================================\n\n");
+    int tropasPerdidas = (int)((int64_t)tropas * pontosBase / PONTOS_BASE_TOTAL);
 
-    for (int i = 0; i < quantidade; i++)
-    {
-        exibirTerritorio(&mapa[i], i);
-    }
+    // Garante perda mínima de 1 tropa
+    return tropasPerdidas < 1 ? 1 : tropasPerdidas;
+}
+
+/**
+ * Função auxiliar para converter um percentual (0-100) em pontos-base
+ */
+static int percentualParaPontosBase(float percentualPerda)
+{
+    float pontosBase = percentualPerda * 100.0f;
+    return (int)(pontosBase < 0 ? pontosBase - 0.5f : pontosBase + 0.5f);
 }
 
 /**
  * Função para transferir o controle de um território para outro exército
- * Implementa passagem por referência usando ponteiro
+ * Mantida para compatibilidade: converte o percentual e usa a versão inteira
  */
-int conquistarTerritorio(Territorio *territorio, const char *novaCor, float percentualPerda)
+int conquistarTerritorio(Territorio *territorio, uint16_t novaCor, float percentualPerda)
 {
-    int tropasPerdidas = (int)(territorio->tropas * percentualPerda / 100.0);
+    return conquistarTerritorioPB(territorio, novaCor, percentualParaPontosBase(percentualPerda));
+}
 
-    // Garante perda mínima de 1 tropa
-    if (tropasPerdidas < 1)
-    {
-        tropasPerdidas = 1;
-    }
+/**
+ * Função para reduzir tropas de um território após uma derrota
+ * Mantida para compatibilidade: converte o percentual e usa a versão inteira
+ */
+int reduzirTropas(Territorio *territorio, float percentualPerda)
+{
+    return reduzirTropasPB(territorio, percentualParaPontosBase(percentualPerda));
+}
+
+/**
+ * Versão inteira de conquistarTerritorio, com a perda em pontos-base
+ * Implementa passagem por referência usando ponteiro
+ */
+int conquistarTerritorioPB(Territorio *territorio, uint16_t novaCor, int pontosBase)
+{
+    int tropasPerdidas = calcularPerdaTropas(territorio->tropas, pontosBase);
 
     // Ajusta a quantidade de tropas do defensor após a perda
     territorio->tropas -= tropasPerdidas;
@@ -103,7 +176,7 @@ int conquistarTerritorio(Territorio *territorio, const char *novaCor, float perc
     if (territorio->tropas <= 0)
     {
         // Transfere a cor do exército atacante para o território conquistado
-        strcpy(territorio->cor, novaCor);
+        territorio->idCor = novaCor;
         // Garantir pelo menos 1 tropa
         territorio->tropas = 1;
     }
@@ -112,27 +185,16 @@ int conquistarTerritorio(Territorio *territorio, const char *novaCor, float perc
 }
 
 /**
- * Função para reduzir tropas de um território após uma derrota
+ * Versão inteira de reduzirTropas, com a perda em pontos-base
  * Implementa passagem por referência usando ponteiro
  */
-int reduzirTropas(Territorio *territorio, float percentualPerda)
+int reduzirTropasPB(Territorio *territorio, int pontosBase)
 {
-    int tropasPerdidas = (int)(territorio->tropas * percentualPerda / 100.0);
-
-    // Garante perda mínima de 1 tropa
-    if (tropasPerdidas < 1)
-    {
-        tropasPerdidas = 1;
-    }
-
-    // Reduz tropas
-    territorio->tropas -= tropasPerdidas;
+    int tropasPerdidas = calcularPerdaTropas(territorio->tropas, pontosBase);
+    int restantes = territorio->tropas - tropasPerdidas;
 
     // Garantir pelo menos 1 tropa
-    if (territorio->tropas <= 0)
-    {
-        territorio->tropas = 1;
-    }
+    territorio->tropas = restantes < 1 ? 1 : restantes;
 
     return tropasPerdidas;
 }
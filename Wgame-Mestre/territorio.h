@@ -6,16 +6,30 @@
 #ifndef TERRITORIO_H
 #define TERRITORIO_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include "cores.h"
+#include "nomes.h"
+
+/**
+ * Perdas em pontos-base (centésimos de ponto percentual): 10000 = 100%
+ * - PERDA_VITORIA_PB: perda do lado derrotado numa rodada (15%)
+ * - PERDA_EMPATE_PB: perda de cada lado num empate (5%)
+ */
+#define PONTOS_BASE_TOTAL 10000
+#define PERDA_VITORIA_PB 1500
+#define PERDA_EMPATE_PB 500
+
 /**
  * Definição da estrutura Territorio que armazena:
- * - nome: nome do território (até 29 caracteres + '\0')
- * - cor: cor do exército que ocupa o território (até 9 caracteres + '\0')
+ * - nome: referência ao nome do território na arena padrão de nomes (ver nomes.h)
+ * - idCor: identificador da cor do exército que ocupa o território (ver cores.h)
  * - tropas: quantidade de tropas no território
  */
 typedef struct
 {
-    char nome[30];
-    char cor[10];
+    RefNome nome;
+    uint16_t idCor;
     int tropas;
 } Territorio;
 
@@ -47,21 +61,14 @@ void cadastrarTerritorio(Territorio *territorio, int indice, int total);
  */
 void exibirTerritorio(const Territorio *territorio, int indice);
 
-/**
- * Função para listar todos os territórios cadastrados
- * @param mapa Ponteiro para o vetor de territórios
- * @param quantidade Quantidade total de territórios
- */
-void listarTerritorios(const Territorio *mapa, int quantidade);
-
 /**
  * Função para transferir o controle de um território para outro exército
  * @param territorio Ponteiro para o território a ser conquistado
- * @param novaCor String contendo a cor do novo exército controlador
+ * @param novaCor Identificador da cor do novo exército controlador
  * @param percentualPerda Percentual de tropas que serão perdidas (0-100)
  * @return Quantidade de tropas perdidas
  */
-int conquistarTerritorio(Territorio *territorio, const char *novaCor, float percentualPerda);
+int conquistarTerritorio(Territorio *territorio, uint16_t novaCor, float percentualPerda);
 
 /**
  * Função para reduzir tropas de um território após uma derrota
@@ -71,4 +78,33 @@ int conquistarTerritorio(Territorio *territorio, const char *novaCor, float perc
  */
 int reduzirTropas(Territorio *territorio, float percentualPerda);
 
+/**
+ * Função para calcular quantas tropas um território perde, em aritmética inteira
+ *
+ * A perda é tropas * pontosBase / 10000 truncada, com mínimo de 1 tropa. É a
+ * regra usada por conquistarTerritorio e reduzirTropas.
+ *
+ * @param tropas Tropas atuais do território
+ * @param pontosBase Percentual de perda em pontos-base (1500 = 15%)
+ * @return Quantidade de tropas perdidas (no mínimo 1)
+ */
+int calcularPerdaTropas(int tropas, int pontosBase);
+
+/**
+ * Versão inteira de conquistarTerritorio, com a perda em pontos-base
+ * @param territorio Ponteiro para o território a ser conquistado
+ * @param novaCor Identificador da cor do novo exército controlador
+ * @param pontosBase Percentual de perda em pontos-base (1500 = 15%)
+ * @return Quantidade de tropas perdidas
+ */
+int conquistarTerritorioPB(Territorio *territorio, uint16_t novaCor, int pontosBase);
+
+/**
+ * Versão inteira de reduzirTropas, com a perda em pontos-base
+ * @param territorio Ponteiro para o território que perderá tropas
+ * @param pontosBase Percentual de perda em pontos-base (500 = 5%)
+ * @return Quantidade de tropas perdidas
+ */
+int reduzirTropasPB(Territorio *territorio, int pontosBase);
+
 #endif /* TERRITORIO_H */
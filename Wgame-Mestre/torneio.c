@@ -0,0 +1,336 @@
+/**
+ * torneio.c - Implementação do torneio paralelo com roubo de trabalho
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "torneio.h"
+#include "partida.h"
+#include "aleatorio.h"
+
+// Tamanho de uma linha de cache; cada fila ocupa a sua para evitar falso compartilhamento
+#define LINHA_CACHE 64
+
+// Trecho da arena de cada thread; cobre o estado de partidas com alguns milhares de territórios
+#define TRECHO_ARENA_TORNEIO (64 * 1024)
+
+/**
+ * Fila de trabalho de uma thread: um intervalo [inicio, fim) de índices de partidas
+ *
+ * Os dois limites ficam num único inteiro de 64 bits (fim nos 32 bits altos),
+ * de modo que o dono e os ladrões o alteram com uma única comparação e troca:
+ * o dono consome pelo início e os ladrões levam metade do que resta pelo fim.
+ */
+typedef struct
+{
+    uint64_t intervalo;
+    char preenchimento[LINHA_CACHE - sizeof(uint64_t)];
+} FilaTrabalho;
+
+/**
+ * Dados de cada thread do torneio
+ */
+typedef struct
+{
+    const ConfiguracaoTorneio *configuracao;
+    FilaTrabalho *filas;
+    int indice;
+    int threads;
+    ResultadoTorneio parcial;
+} TrabalhadorTorneio;
+
+/**
+ * Funções auxiliares para montar e desmontar o intervalo de uma fila
+ */
+static uint64_t montarIntervalo(uint32_t inicio, uint32_t fim)
+{
+    return ((uint64_t)fim << 32) | inicio;
+}
+
+static uint32_t inicioIntervalo(uint64_t intervalo)
+{
+    return (uint32_t)intervalo;
+}
+
+static uint32_t fimIntervalo(uint64_t intervalo)
+{
+    return (uint32_t)(intervalo >> 32);
+}
+
+/**
+ * Função auxiliar: o dono retira a próxima partida do início da sua fila
+ * @return Índice da partida, ou -1 se a fila estiver vazia
+ */
+static long long retirarPropria(FilaTrabalho *fila)
+{
+    uint64_t atual = __atomic_load_n(&fila->intervalo, __ATOMIC_ACQUIRE);
+
+    while (inicioIntervalo(atual) < fimIntervalo(atual))
+    {
+        uint64_t novo = montarIntervalo(inicioIntervalo(atual) + 1, fimIntervalo(atual));
+        if (__atomic_compare_exchange_n(&fila->intervalo, &atual, novo, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            return inicioIntervalo(atual);
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Função auxiliar: rouba metade do trabalho restante de outra thread
+ * @return 1 se conseguiu trabalho (já colocado na própria fila), 0 se todas estão vazias
+ */
+static int roubarTrabalho(TrabalhadorTorneio *trabalhador)
+{
+    for (int k = 1; k < trabalhador->threads; k++)
+    {
+        FilaTrabalho *vitima = &trabalhador->filas[(trabalhador->indice + k) % trabalhador->threads];
+        uint64_t atual = __atomic_load_n(&vitima->intervalo, __ATOMIC_ACQUIRE);
+
+        while (inicioIntervalo(atual) < fimIntervalo(atual))
+        {
+            uint32_t restante = fimIntervalo(atual) - inicioIntervalo(atual);
+            uint32_t levar = (restante + 1) / 2;
+            uint32_t corte = fimIntervalo(atual) - levar;
+            uint64_t novo = montarIntervalo(inicioIntervalo(atual), corte);
+
+            if (__atomic_compare_exchange_n(&vitima->intervalo, &atual, novo, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                __atomic_store_n(&trabalhador->filas[trabalhador->indice].intervalo,
+                                 montarIntervalo(corte, corte + levar), __ATOMIC_RELEASE);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Função auxiliar que monta a configuração da partida de índice 'indice'
+ */
+static void configurarPartida(const ConfiguracaoTorneio *configuracao, long long indice, ConfiguracaoPartida *partida)
+{
+    int faixa = configuracao->territoriosMaximo - configuracao->territoriosMinimo + 1;
+    long long combinacao = indice;
+
+    *partida = configuracao->base;
+    partida->semente = derivarSemente(configuracao->semente, (uint64_t)indice);
+    partida->territorios = configuracao->territoriosMinimo + (int)(partida->semente % (uint64_t)faixa);
+
+    // Estratégias: o índice da partida escrito na base TOTAL_ESTRATEGIAS, um dígito por jogador
+    for (int j = 0; j < partida->jogadores; j++)
+    {
+        partida->estrategias[j] = (Estrategia)(combinacao % TOTAL_ESTRATEGIAS);
+        combinacao /= TOTAL_ESTRATEGIAS;
+    }
+}
+
+/**
+ * Função executada por cada thread: joga partidas até não haver mais trabalho
+ */
+static void *executarTrabalhador(void *argumento)
+{
+    TrabalhadorTorneio *trabalhador = (TrabalhadorTorneio *)argumento;
+    FilaTrabalho *propria = &trabalhador->filas[trabalhador->indice];
+    ResultadoTorneio parcial;
+    ConfiguracaoPartida partida;
+    ResultadoPartida resultado;
+    AlocadorArena arena;
+
+    // Cada thread tira o estado das suas partidas de uma arena própria, reiniciada a cada partida
+    memset(&parcial, 0, sizeof(parcial));
+    iniciarAlocadorArena(&arena, TRECHO_ARENA_TORNEIO);
+
+    for (;;)
+    {
+        long long indice = retirarPropria(propria);
+
+        if (indice < 0)
+        {
+            if (!roubarTrabalho(trabalhador))
+            {
+                break;
+            }
+            continue;
+        }
+
+        configurarPartida(trabalhador->configuracao, indice, &partida);
+        reiniciarAlocador(&arena.base);
+        if (!jogarPartidaCom(&partida, &arena.base, &resultado))
+        {
+            parcial.invalidas++;
+            continue;
+        }
+
+        parcial.partidas++;
+        parcial.turnos += resultado.turnos;
+        parcial.ataques += resultado.ataques;
+        for (int j = 0; j < partida.jogadores; j++)
+        {
+            parcial.assentos[partida.estrategias[j]]++;
+        }
+        if (resultado.vencedor >= 0)
+        {
+            parcial.vitorias[partida.estrategias[resultado.vencedor]]++;
+        }
+        else
+        {
+            parcial.empates++;
+        }
+    }
+
+    destruirAlocador(&arena.base);
+    trabalhador->parcial = parcial;
+    return NULL;
+}
+
+/**
+ * Função para executar o torneio num conjunto de threads com roubo de trabalho
+ */
+int executarTorneio(const ConfiguracaoTorneio *configuracao, ResultadoTorneio *saida)
+{
+    int threads = configuracao->threads;
+    TrabalhadorTorneio *trabalhadores;
+    FilaTrabalho *filas;
+    pthread_t *identificadores;
+    int iniciadas = 0;
+
+    memset(saida, 0, sizeof(ResultadoTorneio));
+
+    if (configuracao->partidas <= 0 || configuracao->territoriosMinimo < 1 ||
+        configuracao->territoriosMaximo < configuracao->territoriosMinimo)
+    {
+        return 0;
+    }
+
+    if (threads <= 0)
+    {
+        long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = nucleos > 0 ? (int)nucleos : 1;
+    }
+    if (threads > configuracao->partidas)
+    {
+        threads = configuracao->partidas;
+    }
+
+    trabalhadores = (TrabalhadorTorneio *)calloc(threads, sizeof(TrabalhadorTorneio));
+    filas = (FilaTrabalho *)calloc(threads, sizeof(FilaTrabalho));
+    identificadores = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    if (trabalhadores == NULL || filas == NULL || identificadores == NULL)
+    {
+        free(trabalhadores);
+        free(filas);
+        free(identificadores);
+        return 0;
+    }
+
+    // Distribuição inicial em blocos contíguos; o roubo corrige os desequilíbrios
+    for (int i = 0; i < threads; i++)
+    {
+        uint32_t inicio = (uint32_t)((long long)configuracao->partidas * i / threads);
+        uint32_t fim = (uint32_t)((long long)configuracao->partidas * (i + 1) / threads);
+
+        filas[i].intervalo = montarIntervalo(inicio, fim);
+        trabalhadores[i].configuracao = configuracao;
+        trabalhadores[i].filas = filas;
+        trabalhadores[i].indice = i;
+        trabalhadores[i].threads = threads;
+    }
+
+    for (int i = 1; i < threads; i++)
+    {
+        if (pthread_create(&identificadores[i], NULL, executarTrabalhador, &trabalhadores[i]) != 0)
+        {
+            break;
+        }
+        iniciadas = i;
+    }
+
+    // A thread principal também trabalha; filas sem thread acabam roubadas por ela
+    executarTrabalhador(&trabalhadores[0]);
+
+    for (int i = 1; i <= iniciadas; i++)
+    {
+        pthread_join(identificadores[i], NULL);
+    }
+
+    // Combina os acumuladores de cada thread somente no final
+    saida->threads = iniciadas + 1;
+    saida->partidasMinimasThread = trabalhadores[0].parcial.partidas;
+    for (int i = 0; i <= iniciadas; i++)
+    {
+        const ResultadoTorneio *parcial = &trabalhadores[i].parcial;
+
+        saida->partidas += parcial->partidas;
+        saida->empates += parcial->empates;
+        saida->invalidas += parcial->invalidas;
+        saida->turnos += parcial->turnos;
+        saida->ataques += parcial->ataques;
+        for (int e = 0; e < TOTAL_ESTRATEGIAS; e++)
+        {
+            saida->assentos[e] += parcial->assentos[e];
+            saida->vitorias[e] += parcial->vitorias[e];
+        }
+        if (parcial->partidas < saida->partidasMinimasThread)
+        {
+            saida->partidasMinimasThread = parcial->partidas;
+        }
+        if (parcial->partidas > saida->partidasMaximasThread)
+        {
+            saida->partidasMaximasThread = parcial->partidas;
+        }
+    }
+
+    free(trabalhadores);
+    free(filas);
+    free(identificadores);
+
+    return 1;
+}
+
+/**
+ * Função para exibir os resultados do torneio
+ */
+void exibirTorneio(const ConfiguracaoTorneio *configuracao, const ResultadoTorneio *resultado, double segundos)
+{
+    printf("\n===================================\n");
+    printf("            TORNEIO               \n");
+    printf("===================================\n");
+    printf("Partidas: %lld | Mapas de %d a %d territorios | Jogadores: %d\n",
+           resultado->partidas, configuracao->territoriosMinimo, configuracao->territoriosMaximo,
+           configuracao->base.jogadores);
+    printf("Semente: %llu\n\n", (unsigned long long)configuracao->semente);
+
+    printf("  %-10s %12s %12s %8s\n", "Estrategia", "Assentos", "Vitorias", "Taxa");
+    for (int e = 0; e < TOTAL_ESTRATEGIAS; e++)
+    {
+        printf("  %-10s %12lld %12lld %7.2f%%\n", nomeEstrategia((Estrategia)e),
+               resultado->assentos[e], resultado->vitorias[e],
+               resultado->assentos[e] > 0 ? 100.0 * resultado->vitorias[e] / resultado->assentos[e] : 0.0);
+    }
+    printf("  Limite de turnos atingido: %lld partidas\n", resultado->empates);
+    if (resultado->invalidas > 0)
+    {
+        printf("  Partidas invalidas (mapa menor que o numero de jogadores): %lld\n", resultado->invalidas);
+    }
+
+    if (resultado->partidas > 0)
+    {
+        printf("\nDuracao media: %.1f turnos, %.1f ataques por partida\n",
+               (double)resultado->turnos / resultado->partidas, (double)resultado->ataques / resultado->partidas);
+    }
+    printf("Threads: %d (partidas por thread: %lld a %lld)\n", resultado->threads,
+           resultado->partidasMinimasThread, resultado->partidasMaximasThread);
+    printf("Tempo: %.3f s | %.1f partidas/s | %.0f ataques/s\n", segundos,
+           segundos > 0 ? resultado->partidas / segundos : 0.0,
+           segundos > 0 ? resultado->ataques / segundos : 0.0);
+    printf("===================================\n\n");
+}
@@ -0,0 +1,68 @@
+/**
+ * torneio.h - Torneio paralelo de partidas automáticas
+ * Parte do Sistema de Territórios para Jogo de War
+ */
+
+#ifndef TORNEIO_H
+#define TORNEIO_H
+
+#include <stdint.h>
+#include "partida.h"
+
+/**
+ * Parâmetros do torneio
+ * - partidas: quantidade total de partidas independentes
+ * - threads: quantidade de threads (0 usa todos os núcleos disponíveis)
+ * - territoriosMinimo/territoriosMaximo: faixa do tamanho dos mapas sorteados
+ * - base: jogadores, tropas iniciais e limite de turnos de cada partida
+ * - semente: semente principal; cada partida deriva a sua a partir dela
+ *
+ * As estratégias de cada partida percorrem todas as combinações possíveis
+ * entre os jogadores, de modo que cada confronto aparece com a mesma frequência.
+ */
+typedef struct
+{
+    int partidas;
+    int threads;
+    int territoriosMinimo;
+    int territoriosMaximo;
+    ConfiguracaoPartida base;
+    uint64_t semente;
+} ConfiguracaoTorneio;
+
+/**
+ * Resultados agregados do torneio
+ * - assentos/vitorias: partidas disputadas e vencidas por cada estratégia
+ * - partidasMinimasThread/partidasMaximasThread: equilíbrio da distribuição entre threads
+ */
+typedef struct
+{
+    long long partidas;
+    long long empates;
+    long long invalidas;
+    long long turnos;
+    long long ataques;
+    long long assentos[TOTAL_ESTRATEGIAS];
+    long long vitorias[TOTAL_ESTRATEGIAS];
+    long long partidasMinimasThread;
+    long long partidasMaximasThread;
+    int threads;
+} ResultadoTorneio;
+
+/**
+ * Função para executar o torneio num conjunto de threads com roubo de trabalho
+ * @param configuracao Parâmetros do torneio
+ * @param saida Ponteiro para a estrutura que receberá os resultados agregados
+ * @return 1 em caso de sucesso, 0 se faltar memória ou os parâmetros forem inválidos
+ */
+int executarTorneio(const ConfiguracaoTorneio *configuracao, ResultadoTorneio *saida);
+
+/**
+ * Função para exibir os resultados do torneio
+ * @param configuracao Parâmetros usados
+ * @param resultado Resultados agregados
+ * @param segundos Duração da execução, para o cálculo de partidas por segundo
+ */
+void exibirTorneio(const ConfiguracaoTorneio *configuracao, const ResultadoTorneio *resultado, double segundos);
+
+#endif /* TORNEIO_H */